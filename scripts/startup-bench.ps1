@@ -0,0 +1,125 @@
+<#
+.SYNOPSIS
+  Compare startup time of neofetch-cli against the GUI.
+
+.DESCRIPTION
+  Runs each executable several times and reports the median and worst time to
+  first complete output, both as measured from outside (process start to exit)
+  and as reported by the program itself on stderr:
+
+    neofetch-cli --time         prints "startup: <ms> ms" after the summary
+    NeoFetchPro --startup-time  prints "startup: <ms> ms" once the window shows
+                                a complete snapshot, then quits
+
+  With -ColdWarm each executable is measured twice against a private inventory
+  cache: cold (cache deleted before every run, so everything is probed) and
+  warm (cache written by a priming run). The CLI runs with --hardware in this
+  mode so that it needs the slow collectors at all.
+
+  Works with PowerShell 7 on Windows and Linux.
+
+.PARAMETER BuildDir
+  Directory containing the built executables. Default: build
+
+.PARAMETER Runs
+  Number of runs per executable. Default: 10
+
+.PARAMETER SkipGui
+  Only measure the CLI (e.g. in an SSH session without a display).
+
+.PARAMETER ColdWarm
+  Compare a cold start (no inventory cache) with a warm one.
+
+.EXAMPLE
+  .\startup-bench.ps1 -BuildDir build\Release -Runs 20
+
+.EXAMPLE
+  .\startup-bench.ps1 -ColdWarm -SkipGui
+#>
+
+[CmdletBinding()]
+param(
+    [string]$BuildDir = "build",
+    [int]$Runs = 10,
+    [switch]$SkipGui,
+    [switch]$ColdWarm
+)
+
+function Find-Executable([string]$Name) {
+    foreach ($candidate in @((Join-Path $BuildDir "$Name.exe"), (Join-Path $BuildDir $Name))) {
+        if (Test-Path $candidate) { return (Resolve-Path $candidate).Path }
+    }
+    throw "$Name not found in $BuildDir"
+}
+
+function Measure-Startup([string]$Path, [string[]]$Arguments, [scriptblock]$BeforeEach = {}) {
+    $wall = @()
+    $reported = @()
+    $outFile = [System.IO.Path]::GetTempFileName()
+    $errFile = [System.IO.Path]::GetTempFileName()
+    try {
+        for ($i = 0; $i -lt $Runs; $i++) {
+            & $BeforeEach
+            $sw = [System.Diagnostics.Stopwatch]::StartNew()
+            $p = Start-Process -FilePath $Path -ArgumentList $Arguments -NoNewWindow -Wait -PassThru `
+                -RedirectStandardOutput $outFile -RedirectStandardError $errFile
+            $sw.Stop()
+            if ($p.ExitCode -ne 0) { throw "$Path exited with code $($p.ExitCode)" }
+            $wall += $sw.Elapsed.TotalMilliseconds
+            $line = Get-Content $errFile | Where-Object { $_ -match '^startup: ([0-9.]+) ms' } | Select-Object -Last 1
+            if ($line -match '^startup: ([0-9.]+) ms') { $reported += [double]$Matches[1] }
+        }
+    } finally {
+        Remove-Item $outFile, $errFile -ErrorAction SilentlyContinue
+    }
+    return [pscustomobject]@{ Wall = $wall; Reported = $reported }
+}
+
+function Get-Median([double[]]$Values) {
+    if ($Values.Count -eq 0) { return [double]::NaN }
+    $sorted = $Values | Sort-Object
+    return $sorted[[int][math]::Floor(($sorted.Count - 1) / 2)]
+}
+
+$targets = @(@{ Name = 'neofetch-cli'; Args = @('--time') })
+if (-not $SkipGui) { $targets += @{ Name = 'NeoFetchPro'; Args = @('--startup-time') } }
+
+function New-Row([string]$Target, [string]$Mode, $Result) {
+    [pscustomobject]@{
+        Target           = $Target
+        Mode             = $Mode
+        'Wall median ms' = [math]::Round((Get-Median $Result.Wall), 2)
+        'Wall max ms'    = [math]::Round(($Result.Wall | Measure-Object -Maximum).Maximum, 2)
+        'Self median ms' = [math]::Round((Get-Median $Result.Reported), 2)
+    }
+}
+
+if ($ColdWarm) {
+    # Keep the user's real cache out of it.
+    $cache = Join-Path ([System.IO.Path]::GetTempPath()) "neofetch-bench-$PID.cache"
+    $env:NEOFETCH_INVENTORY_CACHE = $cache
+    $targets[0].Args += '--hardware'
+}
+
+$rows = try {
+    foreach ($t in $targets) {
+        $exe = Find-Executable $t.Name
+        Write-Verbose "Measuring $exe ($Runs runs)"
+        if ($ColdWarm) {
+            $clear = { Remove-Item $cache -ErrorAction SilentlyContinue }
+            New-Row $t.Name 'cold' (Measure-Startup $exe $t.Args $clear)
+            # Priming run: writes the cache the warm runs read.
+            & $exe @($t.Args) 2>$null | Out-Null
+            New-Row $t.Name 'warm' (Measure-Startup $exe $t.Args)
+        } else {
+            New-Row $t.Name '' (Measure-Startup $exe $t.Args)
+        }
+    }
+} finally {
+    if ($ColdWarm) {
+        Remove-Item $cache -ErrorAction SilentlyContinue
+        Remove-Item Env:NEOFETCH_INVENTORY_CACHE -ErrorAction SilentlyContinue
+    }
+}
+
+$rows | Format-Table -AutoSize
@@ -0,0 +1,280 @@
+#include "AlertEngine.h"
+#include "Logger.h"
+#include "SnapshotFormat.h"
+#include <QRegularExpression>
+#include <QStringList>
+#include <cmath>
+#include <limits>
+
+const double AlertEngine::kDefaultHysteresis = 0.05;
+
+namespace {
+
+const qint64 kNotPending = std::numeric_limits<qint64>::min();
+const double kGiB = 1024.0 * 1024.0 * 1024.0;
+const double kMiB = 1024.0 * 1024.0;
+
+// "30s", "500ms", "5m", "1h" or bare seconds; -1 if malformed.
+qint64 parseDuration(const QString &text)
+{
+    static const QRegularExpression re("^(\\d+(?:\\.\\d+)?)(ms|s|m|h)?$");
+    const QRegularExpressionMatch m = re.match(text);
+    if (!m.hasMatch()) return -1;
+    const double value = m.captured(1).toDouble();
+    const QString unit = m.captured(2);
+    const double scale = unit == "ms" ? 1 : unit == "m" ? 60000 : unit == "h" ? 3600000 : 1000;
+    return qint64(value * scale);
+}
+
+// Rows 0..n-1 of a table column, skipping rows for which value() is NaN.
+template <typename F>
+void fold(int n, F value, double &min, double &max, int &minRow, int &maxRow)
+{
+    for (int i = 0; i < n; ++i) {
+        const double v = value(i);
+        if (std::isnan(v)) continue;
+        if (minRow < 0 || v < min) {
+            min = v;
+            minRow = i;
+        }
+        if (maxRow < 0 || v > max) {
+            max = v;
+            maxRow = i;
+        }
+    }
+}
+
+} // namespace
+
+const char *AlertEngine::metricName(Metric metric)
+{
+    switch (metric) {
+    case CpuPercent: return "cpuPercent";
+    case MemoryPercent: return "memoryPercent";
+    case SwapPercent: return "swapPercent";
+    case CpuCoreBusy: return "cpuCore";
+    case VolumePercent: return "volumePercent";
+    case VolumeFree: return "volumeFree";
+    case DiskUtilization: return "diskUtilization";
+    case DiskLatency: return "diskLatency";
+    case NetworkReceive: return "networkReceive";
+    case NetworkTransmit: return "networkTransmit";
+    case NetworkErrors: return "networkErrors";
+    case ProcessCount: return "processCount";
+    case ProcessCpu: return "processCpu";
+    case CpuPressure: return "cpuPressure";
+    case MemoryPressure: return "memoryPressure";
+    case IoPressure: return "ioPressure";
+    default: return "";
+    }
+}
+
+const char *AlertEngine::metricUnit(Metric metric)
+{
+    switch (metric) {
+    case VolumeFree: return "GiB";
+    case DiskLatency: return "ms";
+    case NetworkReceive:
+    case NetworkTransmit: return "MiB/s";
+    case NetworkErrors: return "/s";
+    case ProcessCount: return "";
+    default: return "%";
+    }
+}
+
+bool AlertEngine::setRules(const QString &text, QString *error)
+{
+    static const QRegularExpression ruleRe(
+        "^(?:([^:<>=]+):)?\\s*(?:any\\s+)?([a-z][a-z ._]*?)\\s*(>=|<=|>|<)\\s*(-?\\d+(?:\\.\\d+)?)\\s*%?(.*)$",
+        QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression separators("[ ._]");
+    static const QRegularExpression whitespace("\\s+");
+    static const QRegularExpression spacedUnit("(\\d)\\s+(ms|s|m|h)\\b");
+
+    std::vector<Rule> rules;
+    QVector<QString> names;
+    quint32 used = 0;
+    const QStringList lines = text.split('\n');
+    for (int n = 0; n < lines.size(); ++n) {
+        auto fail = [&](const QString &why) {
+            if (error) *error = QString("line %1: %2").arg(n + 1).arg(why);
+            return false;
+        };
+        const QString line = lines[n].section('#', 0, 0).trimmed();
+        if (line.isEmpty()) continue;
+        const QRegularExpressionMatch m = ruleRe.match(line);
+        if (!m.hasMatch()) return fail("expected '<metric> <op> <threshold>'");
+
+        const QString key = m.captured(2).remove(separators).toLower();
+        int metric = 0;
+        while (metric < MetricCount && key != QString(metricName(Metric(metric))).toLower()) ++metric;
+        if (metric == MetricCount) return fail(QString("unknown metric '%1'").arg(m.captured(2).trimmed()));
+
+        Rule r;
+        r.metric = Metric(metric);
+        r.sign = m.captured(3).startsWith('>') ? 1 : -1;
+        r.inclusive = m.captured(3).endsWith('=');
+        const double threshold = m.captured(4).toDouble();
+        r.threshold = r.sign * threshold;
+        r.clear = r.threshold - kDefaultHysteresis * std::fabs(threshold);
+        r.forMs = 0;
+        r.cooldownMs = 0;
+
+        // "for 30 s" reads as "for 30s".
+        const QString rest = m.captured(5).replace(spacedUnit, "\\1\\2").trimmed();
+        const QStringList options = rest.isEmpty() ? QStringList() : rest.split(whitespace);
+        for (int i = 0; i < options.size(); i += 2) {
+            if (i + 1 >= options.size()) return fail(QString("'%1' needs a value").arg(options[i]));
+            const QString option = options[i].toLower();
+            const QString value = options[i + 1];
+            if (option == "for" || option == "cooldown") {
+                const qint64 ms = parseDuration(value);
+                if (ms < 0) return fail(QString("bad duration '%1'").arg(value));
+                (option == "for" ? r.forMs : r.cooldownMs) = ms;
+            } else if (option == "clear") {
+                bool ok = false;
+                const double clear = QString(value).remove('%').toDouble(&ok);
+                if (!ok) return fail(QString("bad clear value '%1'").arg(value));
+                if (r.sign * clear > r.threshold)
+                    return fail(QString("clear value must be %1 the threshold").arg(r.sign > 0 ? "at or below" : "at or above"));
+                r.clear = r.sign * clear;
+            } else {
+                return fail(QString("unknown option '%1'").arg(options[i]));
+            }
+        }
+
+        rules.push_back(r);
+        names.append(m.captured(1).trimmed().isEmpty() ? line : m.captured(1).trimmed());
+        used |= 1u << metric;
+    }
+
+    m_rules.swap(rules);
+    m_states.assign(m_rules.size(), State{ kNotPending, kNotPending, false });
+    m_names = names;
+    m_firingEvents = QVector<AlertEvent>(int(m_rules.size()));
+    m_usedMetrics = used;
+    m_table = AlertTable();
+    return true;
+}
+
+AlertEngine::Range AlertEngine::range(Metric metric, const SystemSnapshot &s)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Range r = { nan, nan, -1, -1 };
+    auto scalar = [&](double value) { fold(1, [value](int) { return value; }, r.min, r.max, r.minRow, r.maxRow); };
+    auto rows = [&](int n, auto value) { fold(n, value, r.min, r.max, r.minRow, r.maxRow); };
+
+    const VolumeTable &v = s.volumes;
+    const DiskIoTable &io = s.diskIo;
+    const NetworkTable &net = s.network;
+    switch (metric) {
+    case CpuPercent: scalar(s.cpuPercent); break;
+    case MemoryPercent: scalar(s.memoryTotal ? s.memoryPercent : nan); break;
+    case SwapPercent: {
+        const quint64 *bytes = s.memoryDetail.bytes;
+        const quint64 total = bytes[MemoryBreakdown::SwapTotal];
+        scalar(total ? bytes[MemoryBreakdown::SwapUsed] * 100.0 / double(total) : nan);
+        break;
+    }
+    case CpuCoreBusy: rows(s.cpu.size(), [&](int i) { return double(s.cpu.busy(i)); }); break;
+    case VolumePercent:
+        rows(v.size(), [&](int i) { return v.totalBytes[i] ? v.usedBytes(i) * 100.0 / double(v.totalBytes[i]) : nan; });
+        break;
+    case VolumeFree: rows(v.size(), [&](int i) { return v.totalBytes[i] ? v.freeBytes[i] / kGiB : nan; }); break;
+    case DiskUtilization: rows(io.size(), [&](int i) { return double(io.utilization[i]); }); break;
+    case DiskLatency: rows(io.size(), [&](int i) { return double(io.latencyMs[i]); }); break;
+    case NetworkReceive: rows(net.size(), [&](int i) { return net.rate[NetworkTable::RxBytes][i] / kMiB; }); break;
+    case NetworkTransmit: rows(net.size(), [&](int i) { return net.rate[NetworkTable::TxBytes][i] / kMiB; }); break;
+    case NetworkErrors:
+        rows(net.size(), [&](int i) { return double(net.rate[NetworkTable::RxErrors][i] + net.rate[NetworkTable::TxErrors][i]); });
+        break;
+    case ProcessCount: scalar(s.processes.total ? s.processes.total : nan); break;
+    case ProcessCpu: rows(s.processes.size(), [&](int i) { return double(s.processes.cpuPercent[i]); }); break;
+    case CpuPressure:
+    case MemoryPressure:
+    case IoPressure: {
+        const int resource = PressureStats::Cpu + (metric - CpuPressure);
+        scalar(s.pressure.available ? s.pressure.some[resource][PressureStats::Avg10] : nan);
+        break;
+    }
+    default: break;
+    }
+    return r;
+}
+
+QString AlertEngine::subject(Metric metric, int row, const SystemSnapshot &s)
+{
+    if (row < 0) return QString();
+    switch (metric) {
+    case CpuCoreBusy: return QString("cpu%1").arg(s.cpu.cpuId[row]);
+    case VolumePercent:
+    case VolumeFree: return s.volumes.mountPoint[row];
+    case DiskUtilization:
+    case DiskLatency: return s.diskIo.name[row];
+    case NetworkReceive:
+    case NetworkTransmit:
+    case NetworkErrors: return s.network.name[row];
+    case ProcessCpu: return QString("%1 (%2)").arg(s.processes.name[row]).arg(s.processes.pid[row]);
+    default: return QString();
+    }
+}
+
+bool AlertEngine::evaluate(const SystemSnapshot &s)
+{
+    if (m_rules.empty()) return false;
+    for (int m = 0; m < MetricCount; ++m)
+        if (m_usedMetrics & (1u << m)) m_ranges[m] = range(Metric(m), s);
+
+    const qint64 now = s.timestampMs;
+    bool changed = false;
+    for (size_t i = 0; i < m_rules.size(); ++i) {
+        const Rule &r = m_rules[i];
+        State &state = m_states[i];
+        const Range &extremes = m_ranges[r.metric];
+        // Rising rules look at the largest row, falling ones at the smallest.
+        const double value = r.sign > 0 ? extremes.max : -extremes.min;
+        if (std::isnan(value)) {
+            state.pendingSinceMs = kNotPending;
+            continue;
+        }
+
+        if (state.firing) {
+            if (r.inclusive ? value >= r.clear : value > r.clear) continue;
+            state.firing = false;
+            state.clearedMs = now;
+        } else {
+            if (!(r.inclusive ? value >= r.threshold : value > r.threshold)) {
+                state.pendingSinceMs = kNotPending;
+                continue;
+            }
+            if (state.pendingSinceMs == kNotPending) state.pendingSinceMs = now;
+            if (!m_instantaneous) {
+                if (now - state.pendingSinceMs < r.forMs) continue;
+                if (state.clearedMs != kNotPending && now - state.clearedMs < r.cooldownMs) continue;
+            }
+            state.firing = true;
+        }
+        state.pendingSinceMs = kNotPending;
+
+        // Transitions are rare; only they format text and allocate.
+        AlertEvent e;
+        e.rule = m_names[int(i)];
+        e.subject = subject(r.metric, r.sign > 0 ? extremes.maxRow : extremes.minRow, s);
+        e.value = r.sign * value;
+        e.timestampMs = now;
+        e.firing = state.firing;
+        if (e.firing) m_firingEvents[int(i)] = e;
+        else e.subject = m_firingEvents[int(i)].subject;
+        NEOFETCH_LOG(e.firing ? Logger::Warning : Logger::Info, SnapshotFormat::alertEvent(e));
+        if (m_table.recent.size() == kRecentEvents) m_table.recent.removeFirst();
+        m_table.recent.append(e);
+        changed = true;
+    }
+
+    if (changed) {
+        m_table.firing.clear();
+        for (size_t i = 0; i < m_rules.size(); ++i)
+            if (m_states[i].firing) m_table.firing.append(m_firingEvents[int(i)]);
+    }
+    return changed;
+}
@@ -0,0 +1,108 @@
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include <QString>
+#include <QVector>
+#include <vector>
+#include "SystemSnapshot.h"
+
+// Threshold rules checked against every published snapshot, one per line:
+//
+//   [name:] [any] <metric> <op> <threshold> [for <duration>] [clear <value>] [cooldown <duration>]
+//
+// e.g. "cpuPercent > 90 for 30s" or "Disk full: any volume percent > 95".
+// op is one of > >= < <=; durations take ms, s, m or h (seconds when bare);
+// # starts a comment. Metrics over a table (CPU cores, volumes, disks,
+// interfaces, processes) fire when any row crosses the threshold, and name
+// that row as the alert's subject.
+//
+// A rule fires once its condition has held for its duration and it is out
+// of its cooldown, and clears once the value is back past its clear value:
+// by default kDefaultHysteresis of the threshold on the safe side, so a
+// value hovering at the threshold does not flap. The cooldown counts from
+// the last time the rule cleared.
+//
+// setRules() compiles the text into a flat table of plain structs, and
+// evaluate() first reduces each metric the rules use to its extremes once,
+// then walks the table comparing numbers, so a tick with hundreds of rules
+// costs microseconds and allocates only when a rule changes state.
+class AlertEngine
+{
+public:
+    // Rule-syntax name and unit in metricName() and metricUnit().
+    enum Metric {
+        CpuPercent,
+        MemoryPercent,
+        SwapPercent,
+        CpuCoreBusy,
+        VolumePercent,
+        VolumeFree,
+        DiskUtilization,
+        DiskLatency,
+        NetworkReceive,
+        NetworkTransmit,
+        NetworkErrors,
+        ProcessCount,
+        ProcessCpu,
+        CpuPressure,
+        MemoryPressure,
+        IoPressure,
+        MetricCount
+    };
+
+    static const double kDefaultHysteresis;
+    static const int kRecentEvents = 20;
+
+    // Replaces the rules and forgets what was firing. On a syntax error
+    // returns false with "line N: ..." in error and keeps the old rules.
+    bool setRules(const QString &text, QString *error = nullptr);
+    int ruleCount() const { return int(m_rules.size()); }
+
+    // For one-shot checks (neofetch-cli): rules fire as soon as their
+    // condition holds, ignoring durations and cooldowns.
+    void setInstantaneous(bool instantaneous) { m_instantaneous = instantaneous; }
+
+    // Checks every rule against s, timed by s.timestampMs, and logs each
+    // rule that starts or stops firing. Returns whether table() changed.
+    bool evaluate(const SystemSnapshot &s);
+    const AlertTable &table() const { return m_table; }
+
+    static const char *metricName(Metric metric);
+    static const char *metricUnit(Metric metric);
+
+private:
+    struct Rule {
+        Metric metric;
+        double sign;       // +1 for > and >=, -1 for < and <=; values are compared times sign
+        double threshold;  // times sign
+        double clear;      // times sign
+        bool inclusive;    // >= or <=
+        qint64 forMs;
+        qint64 cooldownMs;
+    };
+    struct State {
+        qint64 pendingSinceMs; // condition holding since, or kNotPending
+        qint64 clearedMs;      // last cleared, or kNotPending
+        bool firing;
+    };
+    // Extremes of a metric over its rows; NaN when it has no rows or the
+    // platform does not report it.
+    struct Range {
+        double min, max;
+        int minRow, maxRow;
+    };
+
+    static Range range(Metric metric, const SystemSnapshot &s);
+    static QString subject(Metric metric, int row, const SystemSnapshot &s);
+
+    std::vector<Rule> m_rules;
+    std::vector<State> m_states;
+    QVector<QString> m_names;          // per rule
+    QVector<AlertEvent> m_firingEvents; // per rule, the event that set it off
+    quint32 m_usedMetrics = 0;
+    Range m_ranges[MetricCount] = {};
+    bool m_instantaneous = false;
+    AlertTable m_table;
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Number of heap allocations made by the process so far: every malloc,
+// calloc and realloc on glibc (so operator new and Qt containers too), only
+// operator new elsewhere. Defined in AllocationCounter.cpp, which only the
+// benchmarks and tests link; the shipped executables keep the allocator
+// they were built with.
+quint64 allocationCount();
+
+#endif
@@ -0,0 +1,247 @@
+#include "Benchmark.h"
+#include "AlertEngine.h"
+#include "AllocationCounter.h"
+#include "SystemBackend.h"
+#include "SystemSampler.h"
+#include "Instrumentation.h"
+#include "MetricHistory.h"
+#include "OpenMetrics.h"
+#include "SnapshotJson.h"
+#include "SnapshotTrace.h"
+#include "SyntheticSamples.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#ifndef Q_OS_WIN
+#include "ProcFile.h"
+#endif
+
+namespace {
+
+// Read syscalls issued by this process so far, from /proc/self/io, or -1.
+// Counts everything, including reads Qt makes through QFile.
+qint64 readSyscalls()
+{
+#ifndef Q_OS_WIN
+    static ProcFile io;
+    static bool opened = io.open("/proc/self/io");
+    quint64 syscr = 0;
+    if (!opened || !io.read() || !ProcParse::findKeyU64(io.begin(), io.end(), "syscr", syscr)) return -1;
+    return qint64(syscr);
+#else
+    return -1;
+#endif
+}
+
+quint64 procFileReads()
+{
+#ifndef Q_OS_WIN
+    return ProcFile::readCount();
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+BenchmarkRunner::BenchmarkRunner(qint64 minTimeMs)
+    : m_minTimeNs(minTimeMs * 1000000)
+{
+}
+
+void BenchmarkRunner::run(const QString &name, const std::function<void()> &fn)
+{
+    // The warm-up call lets collectors open their files and grow their
+    // buffers, so the measured batches show the steady state.
+    fn();
+
+    Result result;
+    result.name = name;
+    for (quint64 batch = 1;; batch *= 2) {
+        // Reading /proc/self/io is itself a syscall; one per batch is noise.
+        const qint64 syscallsBefore = readSyscalls();
+        const quint64 allocsBefore = allocationCount();
+        const quint64 procReadsBefore = procFileReads();
+        QElapsedTimer timer;
+        timer.start();
+        for (quint64 i = 0; i < batch; ++i) fn();
+        const qint64 elapsed = timer.nsecsElapsed();
+        const quint64 allocs = allocationCount() - allocsBefore;
+        const quint64 procReads = procFileReads() - procReadsBefore;
+        const qint64 syscallsAfter = readSyscalls();
+
+        if (elapsed < m_minTimeNs && batch < (quint64(1) << 30)) continue;
+        result.iterations = batch;
+        result.nsPerOp = double(elapsed) / batch;
+        result.allocsPerOp = double(allocs) / batch;
+        result.procFileReadsPerOp = double(procReads) / batch;
+        if (syscallsBefore >= 0 && syscallsAfter >= 0)
+            result.readSyscallsPerOp = double(syscallsAfter - syscallsBefore - 1) / batch;
+        break;
+    }
+    m_results.append(result);
+}
+
+void BenchmarkRunner::addCounter(const QString &name, double value)
+{
+    if (!m_results.isEmpty()) m_results.last().counters.append(qMakePair(name, value));
+}
+
+QByteArray BenchmarkRunner::toJson(const QString &executable, const QVector<QPair<QString, QString>> &context) const
+{
+    QJsonObject ctx;
+    ctx["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    ctx["executable"] = executable;
+    ctx["host_name"] = QSysInfo::machineHostName();
+    ctx["num_cpus"] = QThread::idealThreadCount();
+    ctx["kernel"] = QSysInfo::kernelType() + ' ' + QSysInfo::kernelVersion();
+    for (const auto &kv : context) ctx[kv.first] = kv.second;
+
+    QJsonArray benchmarks;
+    for (const Result &r : m_results) {
+        QJsonObject b;
+        b["name"] = r.name;
+        b["run_name"] = r.name;
+        b["run_type"] = "iteration";
+        b["iterations"] = double(r.iterations);
+        b["real_time"] = r.nsPerOp;
+        b["cpu_time"] = r.nsPerOp;
+        b["time_unit"] = "ns";
+        b["allocs_per_iter"] = r.allocsPerOp;
+        b["read_syscalls_per_iter"] = r.readSyscallsPerOp >= 0 ? QJsonValue(r.readSyscallsPerOp) : QJsonValue();
+        b["procfile_reads_per_iter"] = r.procFileReadsPerOp;
+        for (const auto &counter : r.counters) b[counter.first] = counter.second;
+        benchmarks.append(b);
+    }
+
+    QJsonObject root;
+    root["context"] = ctx;
+    root["benchmarks"] = benchmarks;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+namespace Benchmarks {
+
+void runCollectors(BenchmarkRunner &runner, SystemBackend &backend)
+{
+    SystemInventory inv;
+    const struct {
+        const char *name;
+        void (SystemBackend::*fn)(SystemInventory &);
+    } inventoryCollectors[] = {
+        { "fetchCpuInfo", &SystemBackend::fetchCpuInfo },
+        { "fetchGpuInfo", &SystemBackend::fetchGpuInfo },
+        { "fetchDisplayInfo", &SystemBackend::fetchDisplayInfo },
+        { "fetchOsInfo", &SystemBackend::fetchOsInfo },
+        { "fetchKernelInfo", &SystemBackend::fetchKernelInfo },
+        { "fetchShellInfo", &SystemBackend::fetchShellInfo },
+        { "fetchUserInfo", &SystemBackend::fetchUserInfo },
+        { "fetchDiskHardwareInfo", &SystemBackend::fetchDiskHardwareInfo },
+        { "fetchMemoryHardwareInfo", &SystemBackend::fetchMemoryHardwareInfo },
+        { "fetchNetworkInfo", &SystemBackend::fetchNetworkInfo },
+    };
+    for (const auto &c : inventoryCollectors)
+        runner.run(QString("inventory/%1").arg(c.name), [&]() { (backend.*c.fn)(inv); });
+    runner.run("inventory/bootId", [&]() { backend.bootId(); });
+    runner.run("inventory/hardwareFingerprint", [&]() { backend.hardwareFingerprint(); });
+
+    SystemSnapshot s;
+    const struct {
+        const char *name;
+        void (SystemBackend::*fn)(SystemSnapshot &);
+    } metricCollectors[] = {
+        { "fetchUptime", &SystemBackend::fetchUptime },
+        { "fetchDiskInfo", &SystemBackend::fetchDiskInfo },
+        { "fetchCpuUsage", &SystemBackend::fetchCpuUsage },
+        { "fetchMemoryUsage", &SystemBackend::fetchMemoryUsage },
+        { "fetchProcesses", &SystemBackend::fetchProcesses },
+        { "fetchNetworkUsage", &SystemBackend::fetchNetworkUsage },
+        { "fetchDiskIo", &SystemBackend::fetchDiskIo },
+        { "fetchPressure", &SystemBackend::fetchPressure },
+    };
+    for (const auto &c : metricCollectors)
+        runner.run(QString("metrics/%1").arg(c.name), [&]() { (backend.*c.fn)(s); });
+
+    runner.run("cycle/collectMetrics", [&]() { backend.collectMetrics(s); });
+    // The same cycle with every collector timed, to keep the cost of the
+    // self-instrumentation in view.
+    Instrumentation instrumentation;
+    runner.run("cycle/collectMetrics+instrumentation", [&]() { backend.collectMetrics(s, &instrumentation); });
+    runner.run("instrumentation/probe", [&]() { ProbeTimer probe(&instrumentation, Instrumentation::UiUpdate); });
+    runner.run("cycle/collectQuickInventory", [&]() { backend.collectQuickInventory(inv); });
+    runner.run("cycle/collectInventory", [&]() { backend.collectInventory(inv); });
+}
+
+void runSampler(BenchmarkRunner &runner, std::unique_ptr<SystemBackend> backend)
+{
+    MetricHistory history;
+    SystemSampler sampler(std::move(backend), &history);
+    runner.run("cycle/samplerTick", [&]() { sampler.sampleOnce(); });
+
+    SystemSnapshotPtr before = sampler.latest();
+    sampler.sampleOnce();
+    SystemSnapshotPtr after = sampler.latest();
+    volatile int changed = 0;
+    runner.run("cycle/changedFields", [&]() { changed = int(SystemSnapshot::changedFields(*before, *after)); });
+
+    QByteArray body;
+    runner.run("export/openmetrics", [&]() { OpenMetrics::render(*after, body); });
+    runner.run("export/json", [&]() { SnapshotJson::render(*after, SnapshotJson::AllFields, body); });
+
+    // Every metric, half the rules firing from the warm-up call on and half
+    // never: the steady state of a large rule set, with no transitions.
+    const int kAlertRules = 256;
+    QString rules;
+    for (int i = 0; i < kAlertRules; ++i) {
+        rules += QString("%1 %2 -1000000000 for 30s\n").arg(AlertEngine::metricName(AlertEngine::Metric(i % AlertEngine::MetricCount)))
+            .arg(i % 2 ? ">" : "<");
+    }
+    AlertEngine alerts;
+    alerts.setRules(rules);
+    alerts.setInstantaneous(true);
+    runner.run("alerts/evaluate256", [&]() { alerts.evaluate(*after); });
+}
+
+void runTrace(BenchmarkRunner &runner)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid()) return;
+
+    // Three hours, every sample recorded (no throttling); the round trip
+    // itself is checked by tst_snapshottrace.
+    const QString path = dir.filePath("synthetic.trace");
+    {
+        TraceWriter writer(0);
+        SyntheticSamples samples;
+        writer.open(path);
+        for (int i = 0; i < SyntheticSamples::kSamples; ++i) writer.append(*samples.next());
+    }
+    const double fileBytes = double(QFileInfo(path).size());
+
+    // Steady-state cost per sample, cycling through ten minutes of them.
+    std::vector<SystemSnapshotPtr> window;
+    SyntheticSamples samples;
+    for (int i = 0; i < 600; ++i) window.push_back(samples.next());
+    TraceWriter writer(0);
+    writer.open(dir.filePath("append.trace"));
+    size_t next = 0;
+    runner.run("trace/append", [&]() { writer.append(*window[next++ % window.size()]); });
+    runner.addCounter("bytes_per_sample", fileBytes / SyntheticSamples::kSamples);
+    writer.close();
+
+    TraceReader reader;
+    reader.open(path);
+    runner.run("trace/next", [&]() {
+        if (!reader.next()) reader.seek(0);
+    });
+    const qint64 middle = (reader.startMs() + reader.endMs()) / 2;
+    runner.run("trace/seek", [&]() { reader.seek(middle); });
+}
+
+} // namespace Benchmarks
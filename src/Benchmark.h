@@ -0,0 +1,70 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include <memory>
+
+class SystemBackend;
+
+// A small harness for the benchmarks executable. Each case runs for at least
+// the minimum time after a warm-up call, and reports time, allocations and
+// read syscalls per operation as JSON in the layout Google Benchmark uses,
+// so its compare.py can diff two runs.
+class BenchmarkRunner
+{
+public:
+    struct Result {
+        QString name;
+        quint64 iterations = 0;
+        double nsPerOp = 0;
+        double allocsPerOp = 0;
+        double readSyscallsPerOp = -1;   // -1 where /proc/self/io is unavailable
+        double procFileReadsPerOp = 0;
+        // Extra numbers a case reports, e.g. a compression ratio.
+        QVector<QPair<QString, double>> counters;
+    };
+
+    explicit BenchmarkRunner(qint64 minTimeMs = 200);
+
+    // Calls fn once to warm up, then in growing batches until a batch takes
+    // at least the minimum time, and records the last batch.
+    void run(const QString &name, const std::function<void()> &fn);
+
+    // Attaches a named counter to the last recorded case; it is written as
+    // an extra key of that case, as Google Benchmark does with its user
+    // counters.
+    void addCounter(const QString &name, double value);
+
+    const QVector<Result> &results() const { return m_results; }
+
+    // {"context": {...}, "benchmarks": [...]}; context is extended with the
+    // given key/value pairs (e.g. the fixture used).
+    QByteArray toJson(const QString &executable, const QVector<QPair<QString, QString>> &context = {}) const;
+
+private:
+    qint64 m_minTimeNs;
+    QVector<Result> m_results;
+};
+
+namespace Benchmarks {
+
+// Every inventory and metric collector of backend on its own, then a full
+// metrics cycle and a full inventory pass. Against a LinuxBackend rooted at
+// a fixture tree the numbers do not depend on the machine's state.
+void runCollectors(BenchmarkRunner &runner, SystemBackend &backend);
+
+// Regular SystemSampler ticks (pooled snapshot, metrics, history append,
+// publication), the consumer's diff of two consecutive snapshots, the
+// exports and alert evaluation.
+void runSampler(BenchmarkRunner &runner, std::unique_ptr<SystemBackend> backend);
+
+// Recording and replaying snapshots (SnapshotTrace.h) on three hours of
+// synthetic one-second samples. Reports the bytes per recorded sample.
+void runTrace(BenchmarkRunner &runner);
+
+} // namespace Benchmarks
+
+#endif
@@ -0,0 +1,88 @@
+#include "FreeSpaceProbe.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct FreeSpaceProbe::State
+{
+    Query query;
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+    Result result;
+};
+
+namespace {
+
+// The one thread that runs every probe's queries, in the order they were
+// started. It is never stopped: it may be stuck in a query that does not
+// return, so neither it nor its queue is torn down at exit.
+class Worker
+{
+public:
+    static Worker &instance()
+    {
+        static Worker *worker = new Worker;
+        return *worker;
+    }
+
+    void post(std::shared_ptr<FreeSpaceProbe::State> state)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(state));
+        m_pending.notify_one();
+    }
+
+private:
+    Worker() { std::thread([this]() { loop(); }).detach(); }
+
+    void loop()
+    {
+        for (;;) {
+            std::shared_ptr<FreeSpaceProbe::State> state;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_pending.wait(lock, [this]() { return !m_queue.empty(); });
+                state = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            const FreeSpaceProbe::Result r = state->query();
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->query = nullptr;
+            state->result = r;
+            state->finished = true;
+            state->done.notify_one();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_pending;
+    std::deque<std::shared_ptr<FreeSpaceProbe::State>> m_queue;
+};
+
+} // namespace
+
+bool FreeSpaceProbe::run(const Query &query, int timeoutMs, Result &result)
+{
+    // An outstanding query has had its deadline already; only look whether
+    // it has come back.
+    int waitMs = 0;
+    if (!m_state) {
+        waitMs = timeoutMs;
+        // The queue holds its own reference, so the state outlives this
+        // probe if the backend goes away while the query hangs.
+        m_state = std::make_shared<State>();
+        m_state->query = query;
+        Worker::instance().post(m_state);
+    }
+
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    if (!m_state->done.wait_for(lock, std::chrono::milliseconds(waitMs), [this]() { return m_state->finished; }))
+        return false;
+    result = m_state->result;
+    lock.unlock();
+    m_state.reset();
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef FREESPACEPROBE_H
+#define FREESPACEPROBE_H
+
+#include <QtGlobal>
+#include <functional>
+#include <memory>
+
+// Runs a free-space query that may never return (statvfs() on an NFS mount
+// whose server is gone, GetDiskFreeSpaceExW() on a disconnected share) on a
+// shared worker thread and waits a bounded time for it.
+//
+// A query that misses its deadline stays queued or running, and until it
+// returns run() does not queue another one for this probe: each probe has
+// at most one query outstanding, so the queue never holds more than one
+// entry per remote filesystem. Its result is picked up by whichever later
+// run() finds it finished. Queries run one at a time, so while a dead
+// server blocks the worker the other probes miss their deadlines too and
+// keep their previous figures.
+class FreeSpaceProbe
+{
+public:
+    struct Result {
+        bool ok = false;
+        quint64 totalBytes = 0;
+        quint64 freeBytes = 0;
+    };
+    using Query = std::function<Result()>;
+
+    // Queues query and waits up to timeoutMs for it, unless an earlier one
+    // is still outstanding, which is only checked. Returns true and fills
+    // result when a query finished; false while one is still running.
+    bool run(const Query &query, int timeoutMs, Result &result);
+
+    // One outstanding query; shared with the worker.
+    struct State;
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "HardwareWatcher.h"
+#include <QCoreApplication>
+#include <QSocketNotifier>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#endif
+
+namespace {
+
+#ifdef Q_OS_LINUX
+// Subsystems whose devices show up in the inventory.
+bool isInventorySubsystem(const char *subsystem)
+{
+    static const char *const kSubsystems[] = { "block", "net", "cpu", "memory", "drm", "pci", "nvme" };
+    for (const char *s : kSubsystems) {
+        if (std::strcmp(subsystem, s) == 0) return true;
+    }
+    return false;
+}
+#endif
+
+} // namespace
+
+HardwareWatcher::HardwareWatcher(QObject *parent)
+    : QObject(parent), m_netlinkFd(-1), m_notifier(nullptr)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(1000);
+    connect(&m_debounce, &QTimer::timeout, this, &HardwareWatcher::hardwareChanged);
+
+#ifdef Q_OS_LINUX
+    m_netlinkFd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (m_netlinkFd >= 0) {
+        sockaddr_nl addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = 1; // kernel uevent multicast group
+        if (::bind(m_netlinkFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+            m_notifier = new QSocketNotifier(m_netlinkFd, QSocketNotifier::Read, this);
+            connect(m_notifier, &QSocketNotifier::activated, this, &HardwareWatcher::readUevents);
+        } else {
+            ::close(m_netlinkFd);
+            m_netlinkFd = -1;
+        }
+    }
+#endif
+
+    if (QCoreApplication::instance()) QCoreApplication::instance()->installNativeEventFilter(this);
+}
+
+HardwareWatcher::~HardwareWatcher()
+{
+    if (QCoreApplication::instance()) QCoreApplication::instance()->removeNativeEventFilter(this);
+#ifdef Q_OS_LINUX
+    if (m_netlinkFd >= 0) ::close(m_netlinkFd);
+#endif
+}
+
+void HardwareWatcher::readUevents()
+{
+#ifdef Q_OS_LINUX
+    // Each datagram is "ACTION@DEVPATH" followed by NUL-separated KEY=VALUE
+    // pairs. Drain everything that is queued before deciding.
+    char buf[8192];
+    for (;;) {
+        ssize_t n = ::recv(m_netlinkFd, buf, sizeof(buf) - 1, 0);
+        if (n <= 0) break;
+        buf[n] = '\0';
+
+        const char *action = nullptr;
+        const char *subsystem = nullptr;
+        for (const char *p = buf; p < buf + n; p += std::strlen(p) + 1) {
+            if (std::strncmp(p, "ACTION=", 7) == 0) action = p + 7;
+            else if (std::strncmp(p, "SUBSYSTEM=", 10) == 0) subsystem = p + 10;
+        }
+        if (!action || !subsystem || !isInventorySubsystem(subsystem)) continue;
+        // Monitor hotplug is reported as a "change" on the drm device.
+        bool relevant = std::strcmp(action, "add") == 0 || std::strcmp(action, "remove") == 0
+            || (std::strcmp(action, "change") == 0 && std::strcmp(subsystem, "drm") == 0);
+        if (relevant) m_debounce.start();
+    }
+#endif
+}
+
+bool HardwareWatcher::nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+{
+    Q_UNUSED(result);
+#ifdef Q_OS_WIN
+    if (eventType == "windows_generic_MSG") {
+        MSG *msg = static_cast<MSG *>(message);
+        if (msg->message == WM_DEVICECHANGE || msg->message == WM_DISPLAYCHANGE) m_debounce.start();
+    }
+#else
+    Q_UNUSED(eventType);
+    Q_UNUSED(message);
+#endif
+    return false;
+}
@@ -0,0 +1,37 @@
+#ifndef HARDWAREWATCHER_H
+#define HARDWAREWATCHER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QAbstractNativeEventFilter>
+
+class QSocketNotifier;
+
+// Emits hardwareChanged() when devices are added or removed, so the cached
+// inventory can be invalidated instead of being re-probed on every tick.
+// On Linux this listens to kernel uevents on a netlink socket; on Windows it
+// watches WM_DEVICECHANGE / WM_DISPLAYCHANGE broadcasts to top-level windows.
+// Bursts of events are coalesced into one signal.
+class HardwareWatcher : public QObject, public QAbstractNativeEventFilter
+{
+    Q_OBJECT
+
+public:
+    explicit HardwareWatcher(QObject *parent = nullptr);
+    ~HardwareWatcher() override;
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
+
+signals:
+    void hardwareChanged();
+
+private slots:
+    void readUevents();
+
+private:
+    QTimer m_debounce;
+    int m_netlinkFd;
+    QSocketNotifier *m_notifier;
+};
+
+#endif
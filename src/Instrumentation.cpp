@@ -0,0 +1,67 @@
+#include "Instrumentation.h"
+#include <algorithm>
+
+Instrumentation::Instrumentation()
+    : m_probeCostNs(0)
+{
+    for (std::atomic<quint64> &counter : m_counters) counter.store(0, std::memory_order_relaxed);
+
+    // Time a batch of probes into a scratch histogram: two clock reads and
+    // a record(), the same as every ProbeTimer.
+    const int kCalibrationRounds = 256;
+    LatencyHistogram scratch;
+    const qint64 start = now();
+    for (int i = 0; i < kCalibrationRounds; ++i) {
+        const qint64 t = now();
+        scratch.record(now() - t);
+    }
+    m_probeCostNs = double(now() - start) / kCalibrationRounds;
+}
+
+double Instrumentation::overheadPerTickNs() const
+{
+    // Every tick times the metric collectors and the tick itself. The CLI
+    // samples without a sampler, so fall back to the collector count.
+    quint64 probes = 0;
+    for (int p = Uptime; p <= SamplerTick; ++p) probes += m_probes[p].count();
+    const quint64 ticks = std::max(m_probes[SamplerTick].count(), m_probes[CpuUsage].count());
+    return ticks ? m_probeCostNs * double(probes) / double(ticks) : 0.0;
+}
+
+const char *Instrumentation::probeName(Probe probe)
+{
+    switch (probe) {
+    case Uptime: return "fetchUptime";
+    case DiskUsage: return "fetchDiskInfo";
+    case CpuUsage: return "fetchCpuUsage";
+    case MemoryUsage: return "fetchMemoryUsage";
+    case ProcessUsage: return "fetchProcesses";
+    case NetworkUsage: return "fetchNetworkUsage";
+    case DiskIoUsage: return "fetchDiskIo";
+    case PressureUsage: return "fetchPressure";
+    case AlertRules: return "Alert rules";
+    case SamplerTick: return "Sampler tick";
+    case QuickInventory: return "Quick inventory";
+    case GpuInventory: return "GPU";
+    case DisplayInventory: return "Display";
+    case NetworkInventory: return "Network";
+    case DiskHardwareInventory: return "Disk hardware";
+    case MemoryHardwareInventory: return "Memory hardware";
+    case UiUpdate: return "UI update";
+    default: return "";
+    }
+}
+
+const char *Instrumentation::counterName(Counter counter)
+{
+    switch (counter) {
+    case SamplerWakeups: return "sampler wakeups";
+    case PressureWakeups: return "pressure wakeups";
+    case SnapshotsPublished: return "snapshots published";
+    case SnapshotsApplied: return "snapshots applied";
+    case PropertySignals: return "property signals";
+    case UiRefreshes: return "UI refreshes";
+    case LabelUpdates: return "label updates";
+    default: return "";
+    }
+}
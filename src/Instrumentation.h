@@ -0,0 +1,108 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+#include "LatencyHistogram.h"
+
+// Self-instrumentation of the sampling pipeline: a latency histogram per
+// collector and stage, and counters for publications and UI refreshes.
+//
+// Each probe has a single writer (the sampler thread for the collectors,
+// the GUI thread for UiUpdate); counters may be bumped from any thread and
+// everything may be read from any thread. The cost of one timed probe is
+// calibrated once at construction so the overhead per tick can be reported
+// next to the numbers it distorts.
+class Instrumentation
+{
+public:
+    enum Probe {
+        // Metric collectors, every tick.
+        Uptime,
+        DiskUsage,
+        CpuUsage,
+        MemoryUsage,
+        ProcessUsage,
+        NetworkUsage,
+        DiskIoUsage,
+        PressureUsage,
+        // AlertEngine::evaluate(), every tick.
+        AlertRules,
+        // A regular sampler tick, including the collectors above, history
+        // and publication; inventory passes are not included.
+        SamplerTick,
+        QuickInventory,
+        // Slow inventory collectors, in SystemBackend::SlowInventoryStep order.
+        GpuInventory,
+        DisplayInventory,
+        NetworkInventory,
+        DiskHardwareInventory,
+        MemoryHardwareInventory,
+        // MainWindow::updateData().
+        UiUpdate,
+        ProbeCount
+    };
+
+    enum Counter {
+        SamplerWakeups,     // scheduled sampler ticks
+        PressureWakeups,    // ticks forced by a pressure trigger
+        SnapshotsPublished, // by the sampler
+        SnapshotsApplied,   // picked up by the GUI thread with something changed
+        PropertySignals,    // per-property change signals emitted
+        UiRefreshes,        // updateData() calls
+        LabelUpdates,       // widgets whose text actually changed
+        CounterCount
+    };
+
+    Instrumentation();
+
+    static qint64 now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(Probe probe, qint64 ns) { m_probes[probe].record(ns); }
+    void count(Counter counter, quint64 n = 1) { m_counters[counter].fetch_add(n, std::memory_order_relaxed); }
+
+    const LatencyHistogram &histogram(Probe probe) const { return m_probes[probe]; }
+    quint64 counter(Counter counter) const { return m_counters[counter].load(std::memory_order_relaxed); }
+
+    // Calibrated cost of one now()/now()/record() sequence.
+    double probeCostNs() const { return m_probeCostNs; }
+    // Instrumentation time per sampler tick, from the calibrated probe cost
+    // and the number of probes recorded per tick.
+    double overheadPerTickNs() const;
+
+    static const char *probeName(Probe probe);
+    static const char *counterName(Counter counter);
+
+private:
+    Q_DISABLE_COPY(Instrumentation)
+
+    LatencyHistogram m_probes[ProbeCount];
+    std::atomic<quint64> m_counters[CounterCount];
+    double m_probeCostNs;
+};
+
+// Times a scope into probe; does nothing when instrumentation is null.
+class ProbeTimer
+{
+public:
+    ProbeTimer(Instrumentation *instrumentation, Instrumentation::Probe probe)
+        : m_instrumentation(instrumentation), m_probe(probe), m_start(instrumentation ? Instrumentation::now() : 0) {}
+    ~ProbeTimer()
+    {
+        if (m_instrumentation) m_instrumentation->record(m_probe, Instrumentation::now() - m_start);
+    }
+
+private:
+    Q_DISABLE_COPY(ProbeTimer)
+
+    Instrumentation *m_instrumentation;
+    Instrumentation::Probe m_probe;
+    qint64 m_start;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "InventoryCache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+const char kMagic[8] = { 'N', 'F', 'I', 'N', 'V', 'C', 'A', 'C' };
+// Bump whenever SystemInventory or the serialisation below changes.
+const quint32 kVersion = 1;
+
+struct Header {
+    char magic[8];
+    quint32 version;
+    quint32 bootIdSize;
+    quint32 payloadSize;
+    quint32 reserved;
+    quint64 fingerprint;
+    quint64 checksum; // of boot id + payload
+};
+
+const QDataStream::Version kStreamVersion = QDataStream::Qt_5_12;
+
+QByteArray serialise(const SystemInventory &inv)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << inv.cpuInfo << inv.gpuInfo << inv.displayInfo << inv.osInfo << inv.kernelInfo
+        << inv.shellInfo << inv.username << inv.currentDir << inv.networkInfo;
+    out << quint32(inv.diskDevices.size());
+    for (const DiskDevice &d : inv.diskDevices)
+        out << d.model << d.sizeBytes << d.interfaceType << d.serial;
+    out << quint32(inv.memoryModules.size());
+    for (const MemoryModule &m : inv.memoryModules)
+        out << m.manufacturer << m.capacityBytes << m.speedMHz << m.partNumber;
+    out << inv.diskDevicesNote << inv.memoryModulesNote;
+    return payload;
+}
+
+bool deserialise(const QByteArray &payload, SystemInventory &inv)
+{
+    QDataStream in(payload);
+    in.setVersion(kStreamVersion);
+    in >> inv.cpuInfo >> inv.gpuInfo >> inv.displayInfo >> inv.osInfo >> inv.kernelInfo
+       >> inv.shellInfo >> inv.username >> inv.currentDir >> inv.networkInfo;
+
+    // Counts are bounded by the payload size so a corrupt file cannot make
+    // us reserve gigabytes.
+    quint32 count = 0;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count > quint32(payload.size())) return false;
+    inv.diskDevices.resize(int(count));
+    for (DiskDevice &d : inv.diskDevices)
+        in >> d.model >> d.sizeBytes >> d.interfaceType >> d.serial;
+    in >> count;
+    if (in.status() != QDataStream::Ok || count > quint32(payload.size())) return false;
+    inv.memoryModules.resize(int(count));
+    for (MemoryModule &m : inv.memoryModules)
+        in >> m.manufacturer >> m.capacityBytes >> m.speedMHz >> m.partNumber;
+    in >> inv.diskDevicesNote >> inv.memoryModulesNote;
+    return in.status() == QDataStream::Ok && in.atEnd();
+}
+
+} // namespace
+
+QString InventoryCache::defaultPath()
+{
+    const QString overridePath = qEnvironmentVariable("NEOFETCH_INVENTORY_CACHE");
+    if (!overridePath.isEmpty()) return overridePath;
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/NeoFetchPro/inventory.cache";
+}
+
+quint64 InventoryCache::hash(const void *data, size_t size, quint64 seed)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    quint64 h = seed;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::shared_ptr<SystemInventory> InventoryCache::load(const QByteArray &bootId, quint64 fingerprint) const
+{
+    if (m_path.isEmpty() || bootId.isEmpty()) return nullptr;
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(Header))) return nullptr;
+    const uchar *data = file.map(0, file.size());
+    if (!data) return nullptr;
+
+    // Validate the fixed header first; the payload is only hashed and
+    // parsed if the cache is for this boot and this hardware.
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    const qint64 expectedSize = qint64(sizeof(Header)) + header.bootIdSize + header.payloadSize;
+    const uchar *body = data + sizeof(Header);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+        || header.fingerprint != fingerprint || expectedSize != file.size()
+        || header.bootIdSize != quint32(bootId.size())
+        || std::memcmp(body, bootId.constData(), size_t(bootId.size())) != 0
+        || hash(body, header.bootIdSize + header.payloadSize) != header.checksum) {
+        return nullptr;
+    }
+
+    // Parse straight out of the mapping; deserialise() copies what it keeps.
+    const QByteArray payload = QByteArray::fromRawData(reinterpret_cast<const char *>(body) + header.bootIdSize,
+                                                       int(header.payloadSize));
+    auto inv = std::make_shared<SystemInventory>();
+    if (!deserialise(payload, *inv)) return nullptr;
+    inv->cached = true;
+    return inv;
+}
+
+bool InventoryCache::save(const SystemInventory &inventory, const QByteArray &bootId, quint64 fingerprint) const
+{
+    if (m_path.isEmpty() || bootId.isEmpty()) return false;
+    const QByteArray payload = serialise(inventory);
+
+    QByteArray body = bootId + payload;
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.bootIdSize = quint32(bootId.size());
+    header.payloadSize = quint32(payload.size());
+    header.fingerprint = fingerprint;
+    header.checksum = hash(body.constData(), size_t(body.size()));
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(body);
+    return file.commit();
+}
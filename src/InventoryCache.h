@@ -0,0 +1,42 @@
+#ifndef INVENTORYCACHE_H
+#define INVENTORYCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <memory>
+#include "SystemSnapshot.h"
+
+// The last complete SystemInventory, kept on disk so a warm start can show
+// the hardware details without probing WMI, SMBIOS or sysfs again.
+//
+// The file is a fixed header (magic, format version, payload size and
+// checksum, hardware fingerprint) followed by the boot id and the
+// serialised inventory. It is only trusted if it was written during the
+// current boot on hardware with the same fingerprint; anything else,
+// including a truncated or corrupted file, is a miss.
+class InventoryCache
+{
+public:
+    // $NEOFETCH_INVENTORY_CACHE if set, otherwise a file in the user's
+    // cache directory.
+    static QString defaultPath();
+
+    explicit InventoryCache(const QString &path) : m_path(path) {}
+
+    const QString &path() const { return m_path; }
+
+    // Maps the file and returns the cached inventory, marked as cached, or
+    // nullptr on a miss.
+    std::shared_ptr<SystemInventory> load(const QByteArray &bootId, quint64 fingerprint) const;
+    // Replaces the file atomically.
+    bool save(const SystemInventory &inventory, const QByteArray &bootId, quint64 fingerprint) const;
+
+    // 64-bit FNV-1a, also used by the backends to build fingerprints.
+    static const quint64 kHashSeed = 14695981039346656037ULL;
+    static quint64 hash(const void *data, size_t size, quint64 seed = kHashSeed);
+
+private:
+    QString m_path;
+};
+
+#endif
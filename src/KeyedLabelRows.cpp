@@ -0,0 +1,53 @@
+#include "KeyedLabelRows.h"
+#include <QSet>
+
+KeyedLabelRows::KeyedLabelRows(QVBoxLayout* layout, Factory factory)
+    : m_layout(layout), m_factory(std::move(factory))
+{
+}
+
+int KeyedLabelRows::reconcile(const QVector<Row>& rows) {
+    int touched = 0;
+
+    QSet<QString> wanted;
+    wanted.reserve(rows.size());
+    for (const Row& row : rows) wanted.insert(row.key);
+
+    // Drop rows whose key disappeared.
+    for (auto it = m_labels.begin(); it != m_labels.end();) {
+        if (wanted.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        m_layout->removeWidget(it.value());
+        delete it.value();
+        it = m_labels.erase(it);
+        ++touched;
+    }
+
+    // Place the rest in order. A key listed twice (e.g. an over-mounted
+    // path) keeps its first row.
+    int pos = 0;
+    for (const Row& row : rows) {
+        if (!wanted.remove(row.key)) continue;
+        QLabel*& label = m_labels[row.key];
+        if (!label) {
+            label = m_factory();
+            label->setText(row.text);
+            m_layout->insertWidget(pos++, label);
+            ++touched;
+            continue;
+        }
+        if (m_layout->indexOf(label) != pos) {
+            m_layout->removeWidget(label);
+            m_layout->insertWidget(pos, label);
+            ++touched;
+        }
+        ++pos;
+        if (label->text() != row.text) {
+            label->setText(row.text);
+            ++touched;
+        }
+    }
+    return touched;
+}
@@ -0,0 +1,39 @@
+#ifndef KEYEDLABELROWS_H
+#define KEYEDLABELROWS_H
+
+#include <QHash>
+#include <QLabel>
+#include <QString>
+#include <QVBoxLayout>
+#include <QVector>
+#include <functional>
+
+// Keeps one label per key (drive letter, mount point, device) in a layout and
+// reuses it across refreshes. reconcile() only creates or deletes labels when
+// the set of keys changes, only moves them when the order changes, and only
+// calls setText() when the text differs, so a steady refresh does not
+// trigger relayout or style recomputation.
+class KeyedLabelRows
+{
+public:
+    struct Row {
+        QString key;
+        QString text;
+    };
+    using Factory = std::function<QLabel*()>;
+
+    KeyedLabelRows(QVBoxLayout* layout, Factory factory);
+
+    // Makes the layout show exactly rows, in order. Returns the number of
+    // widgets created, deleted, moved or re-texted.
+    int reconcile(const QVector<Row>& rows);
+
+    int count() const { return m_labels.size(); }
+
+private:
+    QVBoxLayout* m_layout;
+    Factory m_factory;
+    QHash<QString, QLabel*> m_labels;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "LatencyHistogram.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0), m_sumNs(0), m_maxNs(0)
+{
+    for (std::atomic<quint32> &bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketIndex(quint64 ns)
+{
+    // Values below kSubBuckets get one bucket each; above that, the top
+    // kSubBucketBits bits after the leading one pick the linear sub-bucket.
+    if (ns < quint64(kSubBuckets)) return int(ns);
+    const int msb = 63 - int(qCountLeadingZeroBits(ns));
+    if (msb > kMaxExponent) return kBucketCount - 1;
+    const int shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + int((ns >> shift) - quint64(kSubBuckets));
+}
+
+quint64 LatencyHistogram::bucketLowerBound(int index)
+{
+    const int group = index / kSubBuckets;
+    const quint64 sub = quint64(index % kSubBuckets);
+    if (group == 0) return sub;
+    return (quint64(kSubBuckets) + sub) << (group - 1);
+}
+
+void LatencyHistogram::record(qint64 ns)
+{
+    const quint64 v = ns > 0 ? quint64(ns) : 0;
+    m_buckets[bucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.fetch_add(v, std::memory_order_relaxed);
+    // Single writer, so a plain compare is enough.
+    if (v > m_maxNs.load(std::memory_order_relaxed)) m_maxNs.store(v, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+    Summary s;
+    quint64 counts[kBucketCount];
+    for (int i = 0; i < kBucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        s.count += counts[i];
+    }
+    if (s.count == 0) return s;
+    s.maxNs = double(m_maxNs.load(std::memory_order_relaxed));
+    s.meanNs = double(m_sumNs.load(std::memory_order_relaxed)) / double(s.count);
+
+    // Each percentile is reported as the middle of the bucket holding that
+    // rank, capped by the exact maximum.
+    auto percentile = [&](double p) {
+        const quint64 rank = std::max<quint64>(1, quint64(std::ceil(p * double(s.count))));
+        quint64 seen = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen < rank) continue;
+            const double lower = double(bucketLowerBound(i));
+            const double upper = i + 1 < kBucketCount ? double(bucketLowerBound(i + 1)) : s.maxNs;
+            return std::min((lower + upper) / 2, s.maxNs);
+        }
+        return s.maxNs;
+    };
+    s.p50Ns = percentile(0.50);
+    s.p99Ns = percentile(0.99);
+    return s;
+}
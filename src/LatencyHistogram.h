@@ -0,0 +1,50 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <atomic>
+
+// Fixed-size log-linear histogram of durations in nanoseconds. Every power
+// of two is split into kSubBuckets linear buckets, so any recorded value is
+// within 1/kSubBuckets of its bucket's bounds, from 1 ns up to ~18 minutes
+// (larger values land in the last bucket). record() is a few relaxed atomic
+// increments with no allocation or locking.
+//
+// Meant for a single writer; summary() may run concurrently on any thread
+// and then sees a slightly inconsistent but harmless mix of counts.
+class LatencyHistogram
+{
+public:
+    static const int kSubBucketBits = 4;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kMaxExponent = 40;
+    static const int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    struct Summary {
+        quint64 count = 0;
+        double meanNs = 0;
+        double p50Ns = 0;
+        double p99Ns = 0;
+        double maxNs = 0;
+    };
+
+    LatencyHistogram();
+
+    void record(qint64 ns);
+    Summary summary() const;
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+
+    static int bucketIndex(quint64 ns);
+    // Smallest value that maps to bucket index.
+    static quint64 bucketLowerBound(int index);
+
+private:
+    Q_DISABLE_COPY(LatencyHistogram)
+
+    std::atomic<quint32> m_buckets[kBucketCount];
+    std::atomic<quint64> m_count;
+    std::atomic<quint64> m_sumNs;
+    std::atomic<quint64> m_maxNs;
+};
+
+#endif
@@ -0,0 +1,808 @@
+#include "LinuxBackend.h"
+#include "InventoryCache.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QSysInfo>
+#include <sys/statvfs.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <unistd.h>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+// Fields of /proc/self/mountinfo escape blanks and backslashes as \ooo.
+size_t unescapeMountField(const char *p, const char *end, char *out, size_t cap)
+{
+    size_t n = 0;
+    while (p < end && *p != ' ' && *p != '\n' && n + 1 < cap) {
+        if (*p == '\\' && end - p >= 4) {
+            out[n++] = char(((p[1] - '0') << 6) | ((p[2] - '0') << 3) | (p[3] - '0'));
+            p += 4;
+        } else {
+            out[n++] = *p++;
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// Filesystems whose statvfs() goes over the network and blocks for as long
+// as the server does not answer.
+bool isRemoteFilesystem(const char *fsType)
+{
+    static const char *const prefixes[] = {
+        "nfs", "cifs", "smb", "9p", "ceph", "afs", "glusterfs", "lustre", "davfs", "fuse.sshfs", "fuse.rclone"
+    };
+    for (const char *prefix : prefixes)
+        if (std::strncmp(fsType, prefix, std::strlen(prefix)) == 0) return true;
+    return false;
+}
+
+// /proc/net/dev prints the kernel's 64-bit link statistics.
+const int kNetCounterBits = 64;
+const int kLongBits = int(sizeof(unsigned long) * 8);
+
+// Filesystems that hold no user data: kernel interfaces and memory-backed
+// scratch space. Anything else with blocks to report is a volume, whatever
+// its source looks like (ZFS and btrfs subvolumes, bcachefs, FUSE
+// filesystems over a disk, and overlay, which is / inside a container).
+bool isPseudoFilesystem(const char *fsType)
+{
+    static const char *const types[] = {
+        "autofs", "binfmt_misc", "bpf", "cgroup", "cgroup2", "configfs", "debugfs", "devpts", "devtmpfs",
+        "efivarfs", "fusectl", "hugetlbfs", "mqueue", "nsfs", "proc", "pstore", "ramfs",
+        "rpc_pipefs", "securityfs", "selinuxfs", "sysfs", "tmpfs", "tracefs", "fuse.lxcfs", "fuse.gvfsd-fuse",
+        "fuse.portal"
+    };
+    for (const char *type : types)
+        if (std::strcmp(fsType, type) == 0) return true;
+    return false;
+}
+
+// Remote filesystems that take longer keep their previous figures.
+const int kRemoteFreeSpaceTimeoutMs = 100;
+
+FreeSpaceProbe::Result freeSpace(const char *path)
+{
+    FreeSpaceProbe::Result r;
+    struct statvfs vfs;
+    if (statvfs(path, &vfs) == 0 && vfs.f_blocks != 0) {
+        r.ok = true;
+        r.totalBytes = quint64(vfs.f_blocks) * vfs.f_frsize;
+        r.freeBytes = quint64(vfs.f_bfree) * vfs.f_frsize;
+    }
+    return r;
+}
+
+// Returns the 1-based string from the unformatted area of an SMBIOS
+// structure, or an empty string.
+QString smbiosString(const QByteArray &raw, int index)
+{
+    if (index <= 0 || raw.size() < 2) return QString();
+    int pos = quint8(raw[1]);
+    for (int i = 1; pos < raw.size(); ++i) {
+        int end = raw.indexOf('\0', pos);
+        if (end < 0) end = raw.size();
+        if (i == index) return QString::fromLatin1(raw.constData() + pos, end - pos).trimmed();
+        if (end == pos) break;
+        pos = end + 1;
+    }
+    return QString();
+}
+
+quint16 smbiosWord(const QByteArray &raw, int offset)
+{
+    if (offset + 1 >= raw.size()) return 0;
+    return quint16(quint8(raw[offset]) | (quint8(raw[offset + 1]) << 8));
+}
+
+} // namespace
+
+LinuxBackend::LinuxBackend(const QByteArray &root)
+    : m_root(root), m_procDir(nullptr), m_clockTicks(sysconf(_SC_CLK_TCK)), m_pageSize(sysconf(_SC_PAGESIZE)), m_netReadNs(0), m_diskStatsNs(0)
+{
+    m_stat.open(path("/proc/stat").constData());
+    m_meminfo.open(path("/proc/meminfo").constData());
+    m_uptime.open(path("/proc/uptime").constData());
+    m_mounts.open(path("/proc/self/mountinfo").constData());
+    m_netDev.open(path("/proc/net/dev").constData());
+    m_diskStats.open(path("/proc/diskstats").constData());
+    m_pressure[PressureStats::Cpu].open(path("/proc/pressure/cpu").constData());
+    m_pressure[PressureStats::Memory].open(path("/proc/pressure/memory").constData());
+    m_pressure[PressureStats::Io].open(path("/proc/pressure/io").constData());
+    std::fill(std::begin(m_pressureTriggers), std::end(m_pressureTriggers), -1);
+    m_procDir = opendir(path("/proc").constData());
+}
+
+LinuxBackend::~LinuxBackend()
+{
+    for (int fd : m_pressureTriggers)
+        if (fd >= 0) close(fd);
+    if (m_procDir) closedir(m_procDir);
+}
+
+QByteArray LinuxBackend::path(const char *relative) const
+{
+    return m_root + relative;
+}
+
+QByteArray LinuxBackend::readSmallFile(const QByteArray &path) const
+{
+    QFile f(QString::fromLocal8Bit(path));
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    return f.readAll().trimmed();
+}
+
+void LinuxBackend::fetchCpuInfo(SystemInventory &s)
+{
+    const QByteArray cpuinfo = readSmallFile(path("/proc/cpuinfo"));
+    // x86 reports "model name"; many ARM kernels only have "Hardware" or
+    // "Model".
+    for (const char *key : { "model name", "Hardware", "Model" }) {
+        for (const QByteArray &line : cpuinfo.split('\n')) {
+            if (!line.startsWith(key)) continue;
+            int colon = line.indexOf(':');
+            if (colon < 0) continue;
+            s.cpuInfo = QString::fromUtf8(line.mid(colon + 1).trimmed());
+            return;
+        }
+    }
+    s.cpuInfo = "Unknown CPU";
+}
+
+void LinuxBackend::fetchGpuInfo(SystemInventory &s)
+{
+    QStringList gpus;
+    QDir drm(QString::fromLocal8Bit(path("/sys/class/drm")));
+    const QStringList cards = drm.entryList(QStringList() << "card*", QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString &card : cards) {
+        if (card.contains('-')) continue; // connectors, e.g. card0-HDMI-A-1
+        const QByteArray dev = path("/sys/class/drm/") + card.toLocal8Bit() + "/device/";
+        QString driver;
+        for (const QByteArray &line : readSmallFile(dev + "uevent").split('\n')) {
+            if (line.startsWith("DRIVER=")) driver = QString::fromLatin1(line.mid(7));
+        }
+        QString vendor = QString::fromLatin1(readSmallFile(dev + "vendor")).remove("0x");
+        QString device = QString::fromLatin1(readSmallFile(dev + "device")).remove("0x");
+        if (driver.isEmpty() && vendor.isEmpty()) continue;
+        gpus.append(QString("%1 (%2:%3)").arg(driver.isEmpty() ? "Unknown" : driver).arg(vendor).arg(device));
+    }
+    s.gpuInfo = gpus.isEmpty() ? "Unknown" : gpus.join(", ");
+}
+
+void LinuxBackend::fetchDisplayInfo(SystemInventory &s)
+{
+    QStringList displays;
+    QDir drm(QString::fromLocal8Bit(path("/sys/class/drm")));
+    const QStringList connectors = drm.entryList(QStringList() << "card*-*", QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString &connector : connectors) {
+        const QByteArray dir = path("/sys/class/drm/") + connector.toLocal8Bit() + "/";
+        if (readSmallFile(dir + "status") != "connected") continue;
+        const QByteArray modes = readSmallFile(dir + "modes");
+        QString name = connector.section('-', 1);
+        QString res = QString::fromLatin1(modes.left(modes.indexOf('\n') < 0 ? modes.size() : modes.indexOf('\n')));
+        displays.append(res.isEmpty() ? name : QString("%1 - %2").arg(name).arg(res));
+    }
+    s.displayInfo = displays.isEmpty() ? "Unknown" : displays.join('\n');
+}
+
+void LinuxBackend::fetchOsInfo(SystemInventory &s)
+{
+    s.osInfo = QSysInfo::prettyProductName();
+}
+
+void LinuxBackend::fetchKernelInfo(SystemInventory &s)
+{
+    s.kernelInfo = QString("Linux %1").arg(QSysInfo::kernelVersion());
+}
+
+void LinuxBackend::fetchShellInfo(SystemInventory &s)
+{
+    const QString shell = QString::fromLocal8Bit(qgetenv("SHELL"));
+    s.shellInfo = shell.isEmpty() ? "Unknown" : QFileInfo(shell).fileName();
+}
+
+void LinuxBackend::fetchUserInfo(SystemInventory &s)
+{
+    QString user = QString::fromLocal8Bit(qgetenv("USER"));
+    if (user.isEmpty()) {
+        if (const passwd *pw = getpwuid(geteuid())) user = QString::fromLocal8Bit(pw->pw_name);
+    }
+    if (!user.isEmpty()) s.username = user;
+    s.currentDir = QDir::homePath();
+}
+
+void LinuxBackend::fetchDiskHardwareInfo(SystemInventory &s)
+{
+    s.diskDevices.clear();
+    QDir block(QString::fromLocal8Bit(path("/sys/block")));
+    const QStringList devices = block.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    for (const QString &name : devices) {
+        if (name.startsWith("loop") || name.startsWith("ram") || name.startsWith("zram") || name.startsWith("dm-"))
+            continue;
+        const QByteArray dir = path("/sys/block/") + name.toLocal8Bit() + "/";
+        DiskDevice disk;
+        disk.model = QString::fromUtf8(readSmallFile(dir + "device/model"));
+        if (disk.model.isEmpty()) continue; // virtual device without backing hardware
+
+        disk.sizeBytes = readSmallFile(dir + "size").toULongLong() * 512;
+        disk.interfaceType = "SCSI";
+        if (name.startsWith("nvme")) disk.interfaceType = "NVMe";
+        else if (QFileInfo(QString::fromLocal8Bit(dir)).canonicalFilePath().contains("/usb")) disk.interfaceType = "USB";
+        disk.serial = QString::fromUtf8(readSmallFile(dir + "device/serial"));
+        s.diskDevices.append(disk);
+    }
+    s.diskDevicesNote = s.diskDevices.isEmpty() ? "No disks found" : QString();
+}
+
+void LinuxBackend::fetchMemoryHardwareInfo(SystemInventory &s)
+{
+    // SMBIOS type 17 (Memory Device) entries. The kernel exposes them raw,
+    // but normally only to root.
+    s.memoryModules.clear();
+    QDir dmi(QString::fromLocal8Bit(path("/sys/firmware/dmi/entries")));
+    const QStringList entries = dmi.entryList(QStringList() << "17-*", QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString &entry : entries) {
+        QFile f(dmi.filePath(entry + "/raw"));
+        if (!f.open(QIODevice::ReadOnly)) continue;
+        const QByteArray raw = f.readAll();
+        if (raw.size() < 0x1B) continue;
+
+        quint16 size = smbiosWord(raw, 0x0C);
+        if (size == 0 || size == 0xFFFF) continue; // empty slot / unknown
+        MemoryModule module;
+        if (size == 0x7FFF && raw.size() >= 0x20) {
+            quint32 ext = quint32(smbiosWord(raw, 0x1C)) | (quint32(smbiosWord(raw, 0x1E)) << 16);
+            module.capacityBytes = quint64(ext & 0x7FFFFFFF) * 1024 * 1024;
+        } else if (size & 0x8000) {
+            module.capacityBytes = quint64(size & 0x7FFF) * 1024;
+        } else {
+            module.capacityBytes = quint64(size) * 1024 * 1024;
+        }
+        module.manufacturer = smbiosString(raw, quint8(raw[0x17]));
+        module.partNumber = smbiosString(raw, quint8(raw[0x1A]));
+        module.speedMHz = smbiosWord(raw, 0x15);
+        s.memoryModules.append(module);
+    }
+    if (!s.memoryModules.isEmpty()) s.memoryModulesNote.clear();
+    else if (entries.isEmpty()) s.memoryModulesNote = "No memory modules found";
+    else s.memoryModulesNote = "Memory module details require root";
+}
+
+void LinuxBackend::fetchNetworkInfo(SystemInventory &s)
+{
+    QDir net(QString::fromLocal8Bit(path("/sys/class/net")));
+    QStringList adapters = net.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    adapters.removeAll("lo");
+    s.networkInfo = adapters.isEmpty() ? "No adapters" : adapters.join(", ");
+}
+
+QByteArray LinuxBackend::bootId()
+{
+    return readSmallFile(path("/proc/sys/kernel/random/boot_id"));
+}
+
+quint64 LinuxBackend::hardwareFingerprint()
+{
+    // Directory listings and a few tiny sysfs attributes: enough to notice
+    // a disk, DIMM bank, CPU or monitor coming or going, without reading
+    // SMBIOS or the per-device details.
+    quint64 h = InventoryCache::kHashSeed;
+    auto mix = [&h](const QByteArray &bytes) {
+        h = InventoryCache::hash(bytes.constData(), size_t(bytes.size()), h);
+        h = InventoryCache::hash("\n", 1, h);
+    };
+    auto list = [this](const char *dir, const QStringList &filters) {
+        return QDir(QString::fromLocal8Bit(path(dir))).entryList(filters, QDir::Dirs | QDir::NoDotAndDotDot | QDir::System, QDir::Name);
+    };
+
+    for (const QString &name : list("/sys/block", QStringList())) {
+        mix(name.toLocal8Bit());
+        mix(readSmallFile(path("/sys/block/") + name.toLocal8Bit() + "/size"));
+    }
+    for (const QString &name : list("/sys/class/drm", QStringList() << "card*-*")) {
+        mix(name.toLocal8Bit());
+        mix(readSmallFile(path("/sys/class/drm/") + name.toLocal8Bit() + "/status"));
+    }
+    for (const QString &name : list("/sys/class/net", QStringList())) mix(name.toLocal8Bit());
+    mix(readSmallFile(path("/sys/devices/system/cpu/online")));
+
+    quint64 memTotalKb = 0;
+    if (m_meminfo.read()) ProcParse::findKeyU64(m_meminfo.begin(), m_meminfo.end(), "MemTotal", memTotalKb);
+    h = InventoryCache::hash(&memTotalKb, sizeof(memTotalKb), h);
+    return h;
+}
+
+void LinuxBackend::fetchUptime(SystemSnapshot &s)
+{
+    if (!m_uptime.read()) return;
+    quint64 seconds = 0, hundredths = 0;
+    ProcParse::parseFixed2(m_uptime.begin(), m_uptime.end(), seconds, hundredths);
+    s.uptimeSeconds = seconds;
+}
+
+void LinuxBackend::readMountTable()
+{
+    std::vector<Mount> previous;
+    previous.swap(m_mountTable);
+    if (!m_mounts.read()) return;
+
+    char mountPoint[PATH_MAX];
+    char fsType[64];
+    char source[PATH_MAX];
+    char resolved[PATH_MAX];
+    const char *end = m_mounts.end();
+    for (const char *p = m_mounts.begin(); p < end; p = ProcParse::nextLine(p, end)) {
+        // "36 35 98:0 / /mnt/data rw,noatime master:1 - ext4 /dev/sda1 rw": mount
+        // ID, parent ID, device, root, mount point, options, optional fields
+        // up to "-", then filesystem type and source.
+        quint64 id = 0, major = 0, minor = 0;
+        const char *q = ProcParse::parseU64(p, end, id);
+        q = ProcParse::skipToken(q, end);
+        q = ProcParse::parseU64(q, end, major);
+        if (q < end && *q == ':') ++q;
+        q = ProcParse::parseU64(q, end, minor);
+        q = ProcParse::skipSpaces(ProcParse::skipToken(q, end), end);
+        const size_t mountLen = unescapeMountField(q, end, mountPoint, sizeof(mountPoint));
+        do {
+            q = ProcParse::skipSpaces(ProcParse::skipToken(q, end), end);
+        } while (q < end && *q != '\n' && !(q[0] == '-' && (q + 1 == end || q[1] == ' ')));
+        q = ProcParse::skipSpaces(ProcParse::skipToken(q, end), end);
+        unescapeMountField(q, end, fsType, sizeof(fsType));
+        q = ProcParse::skipSpaces(ProcParse::skipToken(q, end), end);
+        const size_t sourceLen = unescapeMountField(q, end, source, sizeof(source));
+        if (mountLen == 0) continue;
+
+        // Skips proc, sysfs, tmpfs, cgroup and friends; ones not
+        // listed there but without any blocks are dropped after statvfs().
+        if (isPseudoFilesystem(fsType)) continue;
+        const bool remote = isRemoteFilesystem(fsType);
+        // Bind mounts and further mounts of a filesystem already listed
+        // share its device and its free space: the first one (in mount
+        // order, so / comes first) stands for all. A container host can have
+        // hundreds of overlay and bind mounts over a few devices.
+        const quint64 deviceId = (major << 32) | minor;
+        if (std::any_of(m_mountTable.begin(), m_mountTable.end(), [&](const Mount &m) { return m.deviceId == deviceId; }))
+            continue;
+
+        auto kept = std::find_if(previous.begin(), previous.end(), [&](const Mount &m) {
+            return m.id == id && m.deviceId == deviceId;
+        });
+        if (kept != previous.end()) {
+            m_mountTable.push_back(std::move(*kept));
+            continue;
+        }
+        Mount m;
+        m.id = id;
+        m.deviceId = deviceId;
+        m.path = QByteArray(mountPoint, int(mountLen));
+        m.mountPoint = QString::fromLocal8Bit(mountPoint, int(mountLen));
+        m.fsType = QString::fromLatin1(fsType);
+        m.remote = remote;
+        // /proc/diskstats uses kernel names; realpath() turns /dev/mapper/*
+        // and /dev/disk/by-*/ links into them ("dm-0", "sda1"). A ZFS
+        // dataset's source is "pool/name" and has no device of its own.
+        if (!remote && sourceLen > 5 && std::memcmp(source, "/dev/", 5) == 0) {
+            const char *full = realpath(source, resolved) ? resolved : source;
+            m.device = QString::fromLatin1(std::strrchr(full, '/') + 1);
+        }
+        m_mountTable.push_back(std::move(m));
+    }
+}
+
+void LinuxBackend::fetchDiskInfo(SystemSnapshot &s)
+{
+    if (!m_mounts.isOpen()) return;
+    // The kernel raises POLLPRI on mountinfo whenever a mount is added,
+    // removed or changed, so the table is only parsed then; a tick costs one
+    // poll() and one statvfs() per filesystem.
+    pollfd pfd = { m_mounts.fd(), POLLPRI, 0 };
+    if (!m_mountTableRead || (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLPRI | POLLERR)))) {
+        readMountTable();
+        m_mountTableRead = true;
+    }
+
+    // Rows are overwritten in place from the cached strings, so an
+    // unchanged mount table costs no allocations.
+    VolumeTable &v = s.volumes;
+    int n = 0;
+    for (Mount &m : m_mountTable) {
+        if (m.remote) {
+            // An unreachable server keeps the last figures.
+            const QByteArray path = m.path;
+            FreeSpaceProbe::Result r;
+            if (m.probe.run([path]() { return freeSpace(path.constData()); }, kRemoteFreeSpaceTimeoutMs, r)) {
+                m.totalBytes = r.totalBytes;
+                m.freeBytes = r.freeBytes;
+            }
+        } else {
+            const FreeSpaceProbe::Result r = freeSpace(m.path.constData());
+            m.totalBytes = r.totalBytes;
+            m.freeBytes = r.freeBytes;
+        }
+        if (m.totalBytes == 0) continue;
+
+        if (v.size() <= n) v.resize(n + 1);
+        if (v.mountPoint[n] != m.mountPoint) v.mountPoint[n] = m.mountPoint;
+        if (v.fsType[n] != m.fsType) v.fsType[n] = m.fsType;
+        if (v.device[n] != m.device) v.device[n] = m.device;
+        v.totalBytes[n] = m.totalBytes;
+        v.freeBytes[n] = m.freeBytes;
+        ++n;
+    }
+    v.resize(n);
+}
+
+void LinuxBackend::fetchCpuUsage(SystemSnapshot &s)
+{
+    if (!m_stat.read()) return;
+    const char *p = m_stat.begin();
+    const char *end = m_stat.end();
+    CpuTable &cpu = s.cpu;
+
+    // The aggregate "cpu" line comes first, followed by one "cpuN" line per
+    // online CPU. Fields: user nice system idle iowait irq softirq steal;
+    // guest time is already counted in user and nice, so it is not read.
+    const int stride = CpuTable::StateCount;
+    quint64 ticks[CpuTable::StateCount];
+    int rows = 0;
+    for (; ProcParse::startsWith(p, end, "cpu"); p = ProcParse::nextLine(p, end)) {
+        const char *q = p + 3;
+        int id = -1;
+        if (q < end && *q >= '0' && *q <= '9') {
+            quint64 n = 0;
+            q = ProcParse::parseU64(q, end, n);
+            id = int(n);
+        }
+        for (quint64 &field : ticks) q = ProcParse::parseU64(q, end, field);
+
+        const int row = id < 0 ? -1 : rows++;
+        const size_t offset = size_t(row + 1) * stride;
+        if (m_prevCpuTicks.size() < offset + stride) m_prevCpuTicks.resize(offset + stride, 0);
+        quint64 *prev = m_prevCpuTicks.data() + offset;
+
+        bool known = prev[CpuTable::Idle] != 0;
+        if (row >= 0) {
+            if (row >= cpu.size()) cpu.resize(row + 1);
+            if (row >= int(m_prevCpuIds.size())) m_prevCpuIds.resize(row + 1, -1);
+            cpu.cpuId[row] = id;
+            // A CPU went offline or came back: this row now tracks a
+            // different CPU, so there is no earlier reading to diff against.
+            if (m_prevCpuIds[row] != id) {
+                m_prevCpuIds[row] = id;
+                known = false;
+            }
+            if (!known) {
+                for (QVector<float> &column : cpu.share) column[row] = 0.0f;
+            }
+        }
+        if (known) cpu.setFromTicks(row, prev, ticks);
+        std::copy(ticks, ticks + stride, prev);
+    }
+    cpu.resize(rows);
+    s.cpuPercent = int(cpu.totalBusy());
+}
+
+void LinuxBackend::fetchMemoryUsage(SystemSnapshot &s)
+{
+    if (!m_meminfo.read()) return;
+
+    // One pass over the file, matching each "Key:" against the few that are
+    // kept; values are in kB except the huge page counts.
+    enum Key { MemTotal, MemAvailable, Buffers, Cached, Shmem, Slab, SwapTotal, SwapFree, Dirty, Writeback,
+               HugePagesTotal, HugePagesFree, HugePageSize, KeyCount };
+    static const char *const names[KeyCount] = {
+        "MemTotal", "MemAvailable", "Buffers", "Cached", "Shmem", "Slab", "SwapTotal", "SwapFree", "Dirty",
+        "Writeback", "HugePages_Total", "HugePages_Free", "Hugepagesize"
+    };
+    quint64 values[KeyCount] = {};
+    const char *end = m_meminfo.end();
+    for (const char *p = m_meminfo.begin(); p < end; p = ProcParse::nextLine(p, end)) {
+        const char *colon = static_cast<const char *>(std::memchr(p, ':', size_t(end - p)));
+        if (!colon) break;
+        const size_t length = size_t(colon - p);
+        for (int k = 0; k < KeyCount; ++k) {
+            if (std::strlen(names[k]) == length && std::memcmp(p, names[k], length) == 0) {
+                ProcParse::parseU64(colon + 1, end, values[k]);
+                break;
+            }
+        }
+    }
+    if (values[MemTotal] == 0) return;
+    s.memoryTotal = values[MemTotal] * 1024;
+    s.memoryUsed = (values[MemTotal] - values[MemAvailable]) * 1024;
+    s.memoryPercent = (int)((s.memoryUsed * 100) / s.memoryTotal);
+
+    quint64 *bytes = s.memoryDetail.bytes;
+    bytes[MemoryBreakdown::Available] = values[MemAvailable] * 1024;
+    bytes[MemoryBreakdown::Cached] = values[Cached] * 1024;
+    bytes[MemoryBreakdown::Buffers] = values[Buffers] * 1024;
+    bytes[MemoryBreakdown::Shmem] = values[Shmem] * 1024;
+    bytes[MemoryBreakdown::Slab] = values[Slab] * 1024;
+    bytes[MemoryBreakdown::SwapTotal] = values[SwapTotal] * 1024;
+    bytes[MemoryBreakdown::SwapUsed] = (values[SwapTotal] - qMin(values[SwapFree], values[SwapTotal])) * 1024;
+    bytes[MemoryBreakdown::Dirty] = values[Dirty] * 1024;
+    bytes[MemoryBreakdown::Writeback] = values[Writeback] * 1024;
+    bytes[MemoryBreakdown::HugePagesTotal] = values[HugePagesTotal] * values[HugePageSize] * 1024;
+    bytes[MemoryBreakdown::HugePagesFree] = values[HugePagesFree] * values[HugePageSize] * 1024;
+}
+
+void LinuxBackend::fetchProcesses(SystemSnapshot &s)
+{
+    if (!m_procDir) return;
+    rewinddir(m_procDir);
+    const int procFd = dirfd(m_procDir);
+    m_processes.begin(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    // One openat/read/close per process; the stat line fits on the stack.
+    char relative[32];
+    char line[2048];
+    while (const dirent *entry = readdir(m_procDir)) {
+        const char *name = entry->d_name;
+        if (*name < '1' || *name > '9') continue;
+        qint64 pid = 0;
+        const char *c = name;
+        for (; *c >= '0' && *c <= '9'; ++c) pid = pid * 10 + (*c - '0');
+        if (*c) continue;
+
+        std::snprintf(relative, sizeof(relative), "%s/stat", name);
+        const int fd = openat(procFd, relative, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue; // exited since the listing
+        const ssize_t n = read(fd, line, sizeof(line));
+        close(fd);
+        if (n <= 0) continue;
+
+        // "pid (comm) state ppid ...": comm may hold spaces and parentheses,
+        // so fields are counted from the last ')'.
+        const char *end = line + n;
+        const char *commBegin = static_cast<const char *>(std::memchr(line, '(', size_t(n)));
+        const char *commEnd = static_cast<const char *>(memrchr(line, ')', size_t(n)));
+        if (!commBegin || !commEnd || commEnd < commBegin) continue;
+        const char *p = commEnd + 1;
+        quint64 utime = 0, stime = 0, startTime = 0, rssPages = 0;
+        for (int field = 3; field < 14; ++field) p = ProcParse::skipToken(p, end);
+        p = ProcParse::parseU64(p, end, utime);     // 14
+        p = ProcParse::parseU64(p, end, stime);     // 15
+        for (int field = 16; field < 22; ++field) p = ProcParse::skipToken(p, end);
+        p = ProcParse::parseU64(p, end, startTime); // 22
+        p = ProcParse::skipToken(p, end);           // 23, vsize
+        ProcParse::parseU64(p, end, rssPages);      // 24
+
+        ProcessTracker::Entry &e = m_processes.add(pid, startTime);
+        e.cpuTime = utime + stime;
+        e.rssBytes = rssPages * quint64(m_pageSize);
+        if (e.name.isEmpty()) e.name = QString::fromUtf8(commBegin + 1, int(commEnd - commBegin - 1));
+    }
+
+    const int cpuCount = m_prevCpuIds.empty() ? int(sysconf(_SC_NPROCESSORS_ONLN)) : int(m_prevCpuIds.size());
+    m_processes.finish(double(m_clockTicks), cpuCount, processLimit(), s.processes);
+}
+
+LinuxBackend::NetInterface *LinuxBackend::findNetInterface(const char *name, size_t length, size_t hint)
+{
+    auto matches = [name, length](const NetInterface &i) {
+        return std::strlen(i.name) == length && std::memcmp(i.name, name, length) == 0;
+    };
+    if (hint < m_netInterfaces.size() && matches(m_netInterfaces[hint])) return &m_netInterfaces[hint];
+    for (NetInterface &i : m_netInterfaces)
+        if (matches(i)) return &i;
+
+    // New name: a new interface, or a known one that was renamed.
+    const QByteArray ifName(name, int(length));
+    const int ifIndex = readSmallFile(path("/sys/class/net/") + ifName + "/ifindex").toInt();
+    NetInterface *found = nullptr;
+    if (ifIndex > 0) {
+        for (NetInterface &i : m_netInterfaces)
+            if (i.ifIndex == ifIndex) found = &i;
+    }
+    if (!found) {
+        m_netInterfaces.emplace_back();
+        found = &m_netInterfaces.back();
+        found->ifIndex = ifIndex;
+        std::fill(std::begin(found->counters), std::end(found->counters), 0);
+        found->seen = false;
+    }
+    std::memcpy(found->name, name, length);
+    found->name[length] = '\0';
+    found->displayName = QString::fromLocal8Bit(ifName);
+    return found;
+}
+
+void LinuxBackend::fetchNetworkUsage(SystemSnapshot &s)
+{
+    if (!m_netDev.read()) return;
+    const qint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const double seconds = m_netReadNs ? (now - m_netReadNs) / 1e9 : 0.0;
+    m_netReadNs = now;
+    for (NetInterface &i : m_netInterfaces) i.seen = false;
+
+    NetworkTable &net = s.network;
+    int rows = 0;
+    const char *end = m_netDev.end();
+    // Two header lines, then "  eth0: <8 receive counters> <8 transmit counters>".
+    const char *p = ProcParse::nextLine(ProcParse::nextLine(m_netDev.begin(), end), end);
+    for (; p < end; p = ProcParse::nextLine(p, end)) {
+        const char *name = ProcParse::skipSpaces(p, end);
+        const char *colon = name;
+        while (colon < end && *colon != ':' && *colon != '\n') ++colon;
+        if (colon >= end || *colon != ':') continue;
+        const size_t length = size_t(colon - name);
+        if (length == 0 || length >= sizeof(NetInterface::name)) continue;
+        if (length == 2 && std::memcmp(name, "lo", 2) == 0) continue;
+
+        quint64 fields[16];
+        const char *q = colon + 1;
+        for (quint64 &field : fields) q = ProcParse::parseU64(q, end, field);
+        quint64 counters[NetworkTable::CounterCount];
+        counters[NetworkTable::RxBytes] = fields[0];
+        counters[NetworkTable::RxPackets] = fields[1];
+        counters[NetworkTable::RxErrors] = fields[2];
+        counters[NetworkTable::RxDrops] = fields[3];
+        counters[NetworkTable::TxBytes] = fields[8];
+        counters[NetworkTable::TxPackets] = fields[9];
+        counters[NetworkTable::TxErrors] = fields[10];
+        counters[NetworkTable::TxDrops] = fields[11];
+
+        const size_t known = m_netInterfaces.size();
+        NetInterface *iface = findNetInterface(name, length, size_t(rows));
+        const bool hasBaseline = m_netInterfaces.size() == known;
+
+        if (rows >= net.size()) net.resize(rows + 1);
+        net.ifIndex[rows] = iface->ifIndex;
+        net.name[rows] = iface->displayName;
+        net.setFromCounters(rows, iface->counters, counters, hasBaseline ? seconds : 0.0, kNetCounterBits);
+        std::copy(counters, counters + NetworkTable::CounterCount, iface->counters);
+        iface->seen = true;
+        ++rows;
+    }
+    net.resize(rows);
+
+    // Interfaces that went away; ones that come back get a new ifindex and
+    // start without a baseline.
+    m_netInterfaces.erase(std::remove_if(m_netInterfaces.begin(), m_netInterfaces.end(),
+                                         [](const NetInterface &i) { return !i.seen; }), m_netInterfaces.end());
+}
+
+void LinuxBackend::fetchDiskIo(SystemSnapshot &s)
+{
+    if (!m_diskStats.read()) return;
+    const qint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const double seconds = m_diskStatsNs ? (now - m_diskStatsNs) / 1e9 : 0.0;
+    m_diskStatsNs = now;
+    for (BlockDevice &d : m_blockDevices) d.seen = false;
+
+    DiskIoTable &io = s.diskIo;
+    int rows = 0;
+    // The file keeps its order, so the entry after the last match is almost
+    // always the next one; a host with hundreds of devices stays linear.
+    size_t next = 0;
+    const char *end = m_diskStats.end();
+    // "   8       1 sda1 <reads> <merged> <sectors> <ms> <writes> <merged>
+    // <sectors> <ms> <in flight> <io ms> ...". Sectors are 512 bytes here
+    // whatever the device's own sector size.
+    for (const char *p = m_diskStats.begin(); p < end; p = ProcParse::nextLine(p, end)) {
+        const char *name = ProcParse::skipSpaces(ProcParse::skipToken(ProcParse::skipToken(p, end), end), end);
+        const char *nameEnd = ProcParse::skipToken(name, end);
+        const size_t length = size_t(nameEnd - name);
+        if (length == 0 || length >= sizeof(BlockDevice::name)) continue;
+
+        quint64 fields[10];
+        const char *q = nameEnd;
+        for (quint64 &field : fields) q = ProcParse::parseU64(q, end, field);
+        // Loop and ram devices that were never used; there can be hundreds.
+        if (fields[0] == 0 && fields[4] == 0) continue;
+        const quint64 counters[BlockDevice::CounterCount] = {
+            fields[0], fields[2], fields[3], fields[4], fields[6], fields[7], fields[9]
+        };
+
+        auto matches = [&](const BlockDevice &d) {
+            return std::strncmp(d.name, name, length) == 0 && d.name[length] == '\0';
+        };
+        BlockDevice *dev = next < m_blockDevices.size() && matches(m_blockDevices[next]) ? &m_blockDevices[next] : nullptr;
+        for (size_t i = 0; !dev && i < m_blockDevices.size(); ++i)
+            if (matches(m_blockDevices[i])) dev = &m_blockDevices[i];
+        const bool hasBaseline = dev != nullptr;
+        if (!dev) {
+            m_blockDevices.emplace_back();
+            dev = &m_blockDevices.back();
+            std::memcpy(dev->name, name, length);
+            dev->name[length] = '\0';
+        }
+        next = size_t(dev - m_blockDevices.data()) + 1;
+
+        if (rows >= io.size()) io.resize(rows + 1);
+        if (io.name[rows] != QLatin1String(name, int(length))) io.name[rows] = QString::fromLatin1(name, int(length));
+        if (hasBaseline && seconds > 0) {
+            // Request and sector counts are unsigned long, the millisecond
+            // totals unsigned int.
+            static const int bits[BlockDevice::CounterCount] = {
+                kLongBits, kLongBits, 32, kLongBits, kLongBits, 32, 32
+            };
+            quint64 d[BlockDevice::CounterCount];
+            for (int i = 0; i < BlockDevice::CounterCount; ++i) d[i] = counterDelta(dev->counters[i], counters[i], bits[i]);
+            const quint64 completed = d[BlockDevice::Reads] + d[BlockDevice::Writes];
+            io.rate[DiskIoTable::ReadBytes][rows] = float(d[BlockDevice::SectorsRead] * 512 / seconds);
+            io.rate[DiskIoTable::WriteBytes][rows] = float(d[BlockDevice::SectorsWritten] * 512 / seconds);
+            io.rate[DiskIoTable::Reads][rows] = float(d[BlockDevice::Reads] / seconds);
+            io.rate[DiskIoTable::Writes][rows] = float(d[BlockDevice::Writes] / seconds);
+            io.latencyMs[rows] = completed ? float(double(d[BlockDevice::ReadMs] + d[BlockDevice::WriteMs]) / completed) : 0.0f;
+            io.utilization[rows] = float(qMin(100.0, d[BlockDevice::IoMs] / (seconds * 10)));
+        } else {
+            for (QVector<float> &column : io.rate) column[rows] = 0;
+            io.latencyMs[rows] = 0;
+            io.utilization[rows] = 0;
+        }
+        std::copy(counters, counters + BlockDevice::CounterCount, dev->counters);
+        dev->seen = true;
+        ++rows;
+    }
+    io.resize(rows);
+
+    m_blockDevices.erase(std::remove_if(m_blockDevices.begin(), m_blockDevices.end(),
+                                        [](const BlockDevice &d) { return !d.seen; }), m_blockDevices.end());
+}
+
+void LinuxBackend::fetchPressure(SystemSnapshot &s)
+{
+    // "some avg10=0.31 avg60=0.12 avg300=0.05 total=1234567" and the same
+    // for "full"; kernels before 5.13 have no full line for cpu.
+    PressureStats &psi = s.pressure;
+    psi = PressureStats();
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        ProcFile &file = m_pressure[r];
+        if (!file.isOpen() || !file.read()) continue;
+        psi.available = true;
+        const char *end = file.end();
+        for (const char *p = file.begin(); p < end; p = ProcParse::nextLine(p, end)) {
+            float *row = ProcParse::startsWith(p, end, "some") ? psi.some[r]
+                       : ProcParse::startsWith(p, end, "full") ? psi.full[r] : nullptr;
+            if (!row) continue;
+            const char *q = p + 4;
+            for (int w = 0; w < PressureStats::WindowCount; ++w) {
+                while (q < end && *q != '=' && *q != '\n') ++q;
+                if (q >= end || *q != '=') break;
+                quint64 whole = 0, hundredths = 0;
+                q = ProcParse::parseFixed2(q + 1, end, whole, hundredths);
+                row[w] = whole + hundredths / 100.0f;
+            }
+        }
+    }
+}
+
+QVector<int> LinuxBackend::pressureTriggers()
+{
+    QVector<int> fds;
+    // A captured tree has no kernel behind it.
+    if (!m_root.isEmpty()) return fds;
+
+    // Memory and I/O only: CPU pressure on a busy host is routine and would
+    // just shorten the interval. Tasks stalled for 10% of a 2 s window; 2 s
+    // multiples are what unprivileged processes may ask for. Kernels that
+    // refuse the trigger fall back to the regular interval.
+    static const char trigger[] = "some 200000 2000000";
+    static const char *const files[PressureStats::ResourceCount] = {
+        nullptr, "/proc/pressure/memory", "/proc/pressure/io"
+    };
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        if (!files[r]) continue;
+        if (m_pressureTriggers[r] < 0) {
+            const int fd = open(files[r], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+            if (fd >= 0 && write(fd, trigger, sizeof(trigger)) < 0) close(fd);
+            else m_pressureTriggers[r] = fd;
+        }
+        if (m_pressureTriggers[r] >= 0) fds.append(m_pressureTriggers[r]);
+    }
+    return fds;
+}
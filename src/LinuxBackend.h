@@ -0,0 +1,126 @@
+#ifndef LINUXBACKEND_H
+#define LINUXBACKEND_H
+
+#include <QByteArray>
+#include <vector>
+#include <dirent.h>
+#include "SystemBackend.h"
+#include "FreeSpaceProbe.h"
+#include "ProcFile.h"
+#include "ProcessTracker.h"
+
+// procfs/sysfs based collectors. The files read on every tick are opened
+// once and re-read in place; inventory collectors may allocate freely since
+// they only run on an inventory pass.
+//
+// All paths are resolved below root, which defaults to "/" but can point at
+// a captured tree of /proc and /sys files to run the backend headless
+// against canned data.
+class LinuxBackend : public SystemBackend
+{
+public:
+    explicit LinuxBackend(const QByteArray &root = QByteArray());
+    ~LinuxBackend() override;
+
+    void fetchCpuInfo(SystemInventory &s) override;
+    void fetchGpuInfo(SystemInventory &s) override;
+    void fetchDisplayInfo(SystemInventory &s) override;
+    void fetchOsInfo(SystemInventory &s) override;
+    void fetchKernelInfo(SystemInventory &s) override;
+    void fetchShellInfo(SystemInventory &s) override;
+    void fetchUserInfo(SystemInventory &s) override;
+    void fetchDiskHardwareInfo(SystemInventory &s) override;
+    void fetchMemoryHardwareInfo(SystemInventory &s) override;
+    void fetchNetworkInfo(SystemInventory &s) override;
+
+    QByteArray bootId() override;
+    quint64 hardwareFingerprint() override;
+
+    void fetchUptime(SystemSnapshot &s) override;
+    void fetchDiskInfo(SystemSnapshot &s) override;
+    void fetchCpuUsage(SystemSnapshot &s) override;
+    void fetchMemoryUsage(SystemSnapshot &s) override;
+    void fetchProcesses(SystemSnapshot &s) override;
+    void fetchNetworkUsage(SystemSnapshot &s) override;
+    void fetchDiskIo(SystemSnapshot &s) override;
+    void fetchPressure(SystemSnapshot &s) override;
+    QVector<int> pressureTriggers() override;
+
+private:
+    // A filesystem from /proc/self/mountinfo that is shown as a volume, with
+    // what does not change while it stays mounted.
+    struct Mount {
+        quint64 id = 0;          // mount ID; not reused while mounted
+        quint64 deviceId = 0;    // major << 32 | minor
+        QByteArray path;         // for statvfs()
+        QString mountPoint;
+        QString fsType;
+        QString device;          // see VolumeTable::device
+        bool remote = false;     // network filesystem, queried through probe
+        FreeSpaceProbe probe;
+        quint64 totalBytes = 0;  // last figures; kept while a remote query hangs
+        quint64 freeBytes = 0;
+    };
+    // Re-reads mountinfo into m_mountTable. Mounts that are still there keep
+    // their entry, including an outstanding probe.
+    void readMountTable();
+
+    // A block device from /proc/diskstats and its counters at the last
+    // reading.
+    struct BlockDevice {
+        enum Counter { Reads, SectorsRead, ReadMs, Writes, SectorsWritten, WriteMs, IoMs, CounterCount };
+        char name[32];   // NUL-terminated
+        quint64 counters[CounterCount];
+        bool seen;       // present in the current reading
+    };
+
+    // An interface from /proc/net/dev and its counters at the last reading.
+    struct NetInterface {
+        char name[16];   // IFNAMSIZ, NUL-terminated
+        int ifIndex;     // 0 if sysfs did not say
+        QString displayName;
+        quint64 counters[NetworkTable::CounterCount];
+        bool seen;       // present in the current reading
+    };
+    // Looks name up, trying row hint first since /proc/net/dev keeps its
+    // order. A name not seen before is resolved to its ifindex, so a renamed
+    // interface keeps its counters; an unknown ifindex gets a new entry.
+    NetInterface *findNetInterface(const char *name, size_t length, size_t hint);
+
+    QByteArray path(const char *relative) const;
+    QByteArray readSmallFile(const QByteArray &path) const;
+
+    QByteArray m_root;
+
+    ProcFile m_stat;
+    ProcFile m_meminfo;
+    ProcFile m_uptime;
+    ProcFile m_mounts;
+    std::vector<Mount> m_mountTable;
+    bool m_mountTableRead = false;
+    ProcFile m_netDev;
+    ProcFile m_diskStats;
+    ProcFile m_pressure[PressureStats::ResourceCount];
+    // PSI trigger descriptors, PressureStats::Resource order; -1 if none.
+    int m_pressureTriggers[PressureStats::ResourceCount];
+
+    // Previous /proc/stat reading: aggregate line first, then one row per
+    // cpuN line, and which N each row belonged to.
+    std::vector<quint64> m_prevCpuTicks;
+    std::vector<int> m_prevCpuIds;
+
+    // /proc, kept open and rewound for every process scan; each
+    // /proc/<pid>/stat is opened relative to it.
+    DIR *m_procDir;
+    ProcessTracker m_processes;
+    long m_clockTicks;
+    long m_pageSize;
+
+    std::vector<NetInterface> m_netInterfaces;
+    qint64 m_netReadNs; // steady clock time of the last /proc/net/dev reading
+
+    std::vector<BlockDevice> m_blockDevices;
+    qint64 m_diskStatsNs; // same, for /proc/diskstats
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include "Logger.h"
+#include <QDateTime>
+#include <QFile>
+#include <cstring>
+
+namespace {
+
+// Encodes UTF-16 into out without allocating; truncates on a code point
+// boundary when out is too small. Returns the number of bytes written.
+int encodeUtf8(const QChar *in, int length, char *out, int cap)
+{
+    int n = 0;
+    for (int i = 0; i < length; ++i) {
+        uint cp = in[i].unicode();
+        if (QChar::isHighSurrogate(cp) && i + 1 < length && in[i + 1].isLowSurrogate()) {
+            cp = QChar::surrogateToUcs4(ushort(cp), in[i + 1].unicode());
+            ++i;
+        }
+        int need = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        if (n + need > cap) break;
+        switch (need) {
+        case 1:
+            out[n++] = char(cp);
+            break;
+        case 2:
+            out[n++] = char(0xC0 | (cp >> 6));
+            out[n++] = char(0x80 | (cp & 0x3F));
+            break;
+        case 3:
+            out[n++] = char(0xE0 | (cp >> 12));
+            out[n++] = char(0x80 | ((cp >> 6) & 0x3F));
+            out[n++] = char(0x80 | (cp & 0x3F));
+            break;
+        default:
+            out[n++] = char(0xF0 | (cp >> 18));
+            out[n++] = char(0x80 | ((cp >> 12) & 0x3F));
+            out[n++] = char(0x80 | ((cp >> 6) & 0x3F));
+            out[n++] = char(0x80 | (cp & 0x3F));
+            break;
+        }
+    }
+    return n;
+}
+
+const char *levelTag(int level)
+{
+    static const char *const kTags[] = { "D", "I", "W", "E" };
+    return level >= 0 && level < 4 ? kTags[level] : "?";
+}
+
+void qtMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    Logger::Level level = Logger::Debug;
+    switch (type) {
+    case QtDebugMsg: level = Logger::Debug; break;
+    case QtInfoMsg: level = Logger::Info; break;
+    case QtWarningMsg: level = Logger::Warning; break;
+    case QtCriticalMsg:
+    case QtFatalMsg: level = Logger::Error; break;
+    }
+    NEOFETCH_LOG(level, message);
+}
+
+} // namespace
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_enqueuePos(0), m_dequeuePos(0), m_level(Info), m_dropped(0),
+      m_maxBytes(0), m_maxFiles(0), m_stopping(false)
+{
+    for (int i = 0; i < kCapacity; ++i) m_slots[i].sequence.store(quint64(i), std::memory_order_relaxed);
+}
+
+Logger::~Logger()
+{
+    stop();
+}
+
+Logger::Level Logger::levelFromString(const QString &name, Level fallback)
+{
+    const QString n = name.trimmed().toLower();
+    if (n == "debug") return Debug;
+    if (n == "info") return Info;
+    if (n == "warning" || n == "warn") return Warning;
+    if (n == "error") return Error;
+    if (n == "off" || n == "none") return Off;
+    return fallback;
+}
+
+void Logger::start(const QString &path, qint64 maxBytes, int maxFiles)
+{
+    stop();
+    m_path = path;
+    m_maxBytes = maxBytes;
+    m_maxFiles = qMax(1, maxFiles);
+    m_stopping = false;
+    m_flusher = std::thread(&Logger::flusherLoop, this);
+}
+
+void Logger::stop()
+{
+    if (!m_flusher.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_flusher.join();
+}
+
+void Logger::installMessageHandler()
+{
+    qInstallMessageHandler(qtMessageHandler);
+}
+
+// Bounded multi-producer queue after Dmitry Vyukov: each slot carries a
+// sequence number telling producers and the consumer whose turn it is, so
+// neither side ever takes a lock.
+Logger::Slot *Logger::acquireSlot()
+{
+    quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot *slot = &m_slots[pos & (kCapacity - 1)];
+        quint64 seq = slot->sequence.load(std::memory_order_acquire);
+        qint64 diff = qint64(seq) - qint64(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return slot;
+        } else if (diff < 0) {
+            return nullptr; // full
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::commitSlot(Slot *slot)
+{
+    quint64 seq = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(seq + 1, std::memory_order_release);
+}
+
+void Logger::log(Level level, const QString &message)
+{
+    if (!isEnabled(level)) return;
+    Slot *slot = acquireSlot();
+    if (!slot) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    slot->timestamp = QDateTime::currentMSecsSinceEpoch();
+    slot->level = level;
+    slot->length = encodeUtf8(message.constData(), message.size(), slot->text, kTextSize);
+    commitSlot(slot);
+}
+
+void Logger::log(Level level, const char *message)
+{
+    if (!isEnabled(level)) return;
+    Slot *slot = acquireSlot();
+    if (!slot) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    slot->timestamp = QDateTime::currentMSecsSinceEpoch();
+    slot->level = level;
+    slot->length = int(qMin(std::strlen(message), size_t(kTextSize)));
+    std::memcpy(slot->text, message, size_t(slot->length));
+    commitSlot(slot);
+}
+
+bool Logger::drain(QByteArray &out)
+{
+    bool any = false;
+    for (;;) {
+        Slot *slot = &m_slots[m_dequeuePos & (kCapacity - 1)];
+        if (slot->sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) break;
+
+        out += QDateTime::fromMSecsSinceEpoch(slot->timestamp).toString("yyyy-MM-dd HH:mm:ss.zzz").toLatin1();
+        out += " [";
+        out += levelTag(slot->level);
+        out += "] ";
+        out.append(slot->text, slot->length);
+        out += '\n';
+
+        slot->sequence.store(m_dequeuePos + kCapacity, std::memory_order_release);
+        ++m_dequeuePos;
+        any = true;
+    }
+    return any;
+}
+
+void Logger::flusherLoop()
+{
+    QFile file(m_path);
+    file.open(QIODevice::Append);
+    QByteArray batch;
+    quint64 reportedDrops = 0;
+
+    for (;;) {
+        bool stopping;
+        {
+            // Producers never notify; we poll so that logging stays free of
+            // syscalls on their side, and batch whatever accumulated.
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(250), [this] { return m_stopping; });
+            stopping = m_stopping;
+        }
+
+        batch.clear();
+        drain(batch);
+        quint64 drops = droppedCount();
+        if (drops != reportedDrops) {
+            batch += QString("[logger dropped %1 messages]\n").arg(drops - reportedDrops).toLatin1();
+            reportedDrops = drops;
+        }
+
+        if (!batch.isEmpty() && file.isOpen()) {
+            file.write(batch);
+            file.flush();
+            if (m_maxBytes > 0 && file.size() > m_maxBytes) {
+                file.close();
+                for (int i = m_maxFiles - 1; i > 0; --i) {
+                    const QString from = i == 1 ? m_path : QString("%1.%2").arg(m_path).arg(i - 1);
+                    const QString to = QString("%1.%2").arg(m_path).arg(i);
+                    QFile::remove(to);
+                    QFile::rename(from, to);
+                }
+                if (m_maxFiles == 1) QFile::remove(m_path);
+                file.open(QIODevice::Append);
+            }
+        }
+
+        if (stopping) break;
+    }
+}
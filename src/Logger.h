@@ -0,0 +1,87 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Process-wide structured logger. log() only copies the message into a
+// fixed-size lock-free ring buffer; a background thread drains the ring in
+// batches, appends to the log file and rotates it by size. Callers therefore
+// never block on, or perform, file I/O. If the ring is full the message is
+// dropped and counted rather than waiting for the flusher.
+class Logger
+{
+public:
+    enum Level { Debug = 0, Info, Warning, Error, Off };
+
+    static Logger &instance();
+
+    // Starts the flusher thread writing to path. Rotates to path.1 ..
+    // path.<maxFiles-1> once the file exceeds maxBytes.
+    void start(const QString &path, qint64 maxBytes = 1024 * 1024, int maxFiles = 3);
+    // Drains whatever is left and joins the flusher thread.
+    void stop();
+
+    void setLevel(Level level) { m_level.store(level, std::memory_order_relaxed); }
+    Level level() const { return Level(m_level.load(std::memory_order_relaxed)); }
+    bool isEnabled(Level level) const { return level >= m_level.load(std::memory_order_relaxed); }
+    static Level levelFromString(const QString &name, Level fallback = Info);
+
+    void log(Level level, const QString &message);
+    void log(Level level, const char *message);
+
+    // Routes qDebug()/qWarning()/... through the logger.
+    void installMessageHandler();
+
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    Logger();
+    ~Logger();
+    Q_DISABLE_COPY(Logger)
+
+    static const int kCapacity = 1024; // power of two
+    static const int kTextSize = 240;
+
+    struct Slot {
+        std::atomic<quint64> sequence;
+        qint64 timestamp;
+        int level;
+        int length;
+        char text[kTextSize];
+    };
+
+    Slot *acquireSlot();
+    void commitSlot(Slot *slot);
+    bool drain(QByteArray &out);
+    void flusherLoop();
+
+    Slot m_slots[kCapacity];
+    std::atomic<quint64> m_enqueuePos;
+    quint64 m_dequeuePos; // flusher thread only
+    std::atomic<int> m_level;
+    std::atomic<quint64> m_dropped;
+
+    QString m_path;
+    qint64 m_maxBytes;
+    int m_maxFiles;
+
+    std::thread m_flusher;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stopping;
+};
+
+// Skips formatting the message entirely when the level is disabled.
+#define NEOFETCH_LOG(level, message) \
+    do { \
+        Logger &logger_ = Logger::instance(); \
+        if (logger_.isEnabled(level)) logger_.log(level, message); \
+    } while (0)
+
+#endif
@@ -0,0 +1,185 @@
+#include "MetricHistory.h"
+#include "SnapshotFormat.h"
+#include "SystemBackend.h"
+#include <algorithm>
+
+MetricHistory::MetricHistory()
+    : m_next(0)
+{
+    m_series.reserve(kMaxSeries);
+}
+
+qint64 MetricHistory::bucketMs(Resolution resolution)
+{
+    switch (resolution) {
+    case Seconds: return 1000;
+    case Minutes: return 60 * 1000;
+    case Hours: return 60 * 60 * 1000;
+    default: return 0;
+    }
+}
+
+int MetricHistory::capacity(Resolution resolution)
+{
+    switch (resolution) {
+    case Seconds: return 10 * 60;
+    case Minutes: return 24 * 60;
+    case Hours: return 30 * 24;
+    default: return 0;
+    }
+}
+
+void MetricHistory::append(const SystemSnapshot &s)
+{
+    const quint32 ran = s.sampledMetrics;
+    const qint64 t = s.timestampMs;
+    auto sampled = [ran](SystemBackend::Metric m) { return (ran & (1u << m)) != 0; };
+    const QString none;
+
+    QMutexLocker locker(&m_mutex);
+    if (sampled(SystemBackend::CpuMetric)) {
+        add(CpuPercent, 0, none, t, s.cpuPercent);
+        for (int i = 0; i < s.cpu.size(); ++i) add(CoreBusy, s.cpu.cpuId[i], none, t, s.cpu.busy(i));
+    }
+    if (sampled(SystemBackend::MemoryMetric)) {
+        add(MemoryPercent, 0, none, t, s.memoryPercent);
+        add(MemoryUsed, 0, none, t, double(s.memoryUsed));
+    }
+    if (sampled(SystemBackend::ProcessMetric)) add(ProcessCount, 0, none, t, s.processes.total);
+    if (sampled(SystemBackend::PressureMetric) && s.pressure.available) {
+        for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+            add(PressureSome, r, none, t, s.pressure.some[r][PressureStats::Avg10]);
+            add(PressureFull, r, none, t, s.pressure.full[r][PressureStats::Avg10]);
+        }
+    }
+    if (sampled(SystemBackend::DiskMetric)) {
+        const VolumeTable &v = s.volumes;
+        for (int i = 0; i < v.size(); ++i) {
+            const quint64 total = v.totalBytes[i];
+            add(VolumeUsedPercent, -1, v.mountPoint[i], t, total ? 100.0 * double(total - v.freeBytes[i]) / double(total) : 0.0);
+        }
+    }
+    if (sampled(SystemBackend::DiskIoMetric)) {
+        const DiskIoTable &io = s.diskIo;
+        for (int i = 0; i < io.size(); ++i) {
+            add(DiskReadBytes, -1, io.name[i], t, io.rate[DiskIoTable::ReadBytes][i]);
+            add(DiskWriteBytes, -1, io.name[i], t, io.rate[DiskIoTable::WriteBytes][i]);
+            add(DiskUtilization, -1, io.name[i], t, io.utilization[i]);
+        }
+    }
+    if (sampled(SystemBackend::NetworkMetric)) {
+        const NetworkTable &net = s.network;
+        for (int i = 0; i < net.size(); ++i) {
+            add(NetworkRxBytes, -1, net.name[i], t, net.rate[NetworkTable::RxBytes][i]);
+            add(NetworkTxBytes, -1, net.name[i], t, net.rate[NetworkTable::TxBytes][i]);
+        }
+    }
+}
+
+void MetricHistory::add(Metric metric, int id, const QString &name, qint64 timestampMs, double value)
+{
+    Series *target = series(metric, id, name, timestampMs);
+    if (!target) return;
+    target->lastMs = timestampMs;
+    for (int r = 0; r < ResolutionCount; ++r) {
+        Ring &ring = target->rings[r];
+        const int cap = int(ring.timestamp.size());
+        const qint64 width = bucketMs(Resolution(r));
+        const qint64 bucket = timestampMs - timestampMs % width;
+
+        if (ring.size == 0 || bucket != ring.timestamp[ring.head]) {
+            // Roll over: start a new bucket, overwriting the oldest one once
+            // the ring is full.
+            ring.head = ring.size == 0 ? 0 : (ring.head + 1) % cap;
+            ring.size = std::min(ring.size + 1, cap);
+            ring.timestamp[ring.head] = bucket;
+            ring.count[ring.head] = 1;
+            ring.min[ring.head] = ring.max[ring.head] = float(value);
+            ring.sum[ring.head] = value;
+            continue;
+        }
+
+        ++ring.count[ring.head];
+        ring.min[ring.head] = std::min(ring.min[ring.head], float(value));
+        ring.max[ring.head] = std::max(ring.max[ring.head], float(value));
+        ring.sum[ring.head] += value;
+    }
+}
+
+MetricHistory::Series *MetricHistory::series(Metric metric, int id, const QString &name, qint64 timestampMs)
+{
+    auto matches = [&](const Series &s) { return s.metric == metric && s.id == id && (id >= 0 || s.key == name); };
+    if (m_next < m_series.size() && matches(m_series[m_next])) return &m_series[m_next++];
+    for (size_t i = 0; i < m_series.size(); ++i) {
+        if (!matches(m_series[i])) continue;
+        m_next = i + 1;
+        return &m_series[i];
+    }
+
+    Series *s = nullptr;
+    if (m_series.size() < size_t(kMaxSeries)) {
+        m_series.emplace_back();
+        s = &m_series.back();
+        for (int r = 0; r < ResolutionCount; ++r) {
+            const int cap = capacity(Resolution(r));
+            Ring &ring = s->rings[r];
+            ring.timestamp.assign(cap, 0);
+            ring.count.assign(cap, 0);
+            ring.min.assign(cap, 0.0f);
+            ring.max.assign(cap, 0.0f);
+            ring.sum.assign(cap, 0.0);
+        }
+    } else {
+        // Full: recycle the series that has gone longest without a sample,
+        // typically a volume or interface that has gone away.
+        auto oldest = std::min_element(m_series.begin(), m_series.end(),
+                                       [](const Series &a, const Series &b) { return a.lastMs < b.lastMs; });
+        if (oldest->lastMs >= timestampMs) return nullptr;
+        s = &*oldest;
+        for (Ring &ring : s->rings) {
+            ring.head = 0;
+            ring.size = 0;
+        }
+    }
+    s->metric = metric;
+    s->id = id;
+    if (metric == CoreBusy) s->key = QString::number(id);
+    else if (metric == PressureSome || metric == PressureFull) s->key = QString::fromLatin1(SnapshotFormat::pressureResourceName(id));
+    else s->key = name;
+    s->lastMs = timestampMs;
+    m_next = size_t(s - m_series.data()) + 1;
+    return s;
+}
+
+const MetricHistory::Series *MetricHistory::find(Metric metric, const QString &key) const
+{
+    for (const Series &s : m_series)
+        if (s.metric == metric && s.key == key) return &s;
+    return nullptr;
+}
+
+QStringList MetricHistory::keys(Metric metric) const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList list;
+    for (const Series &s : m_series)
+        if (s.metric == metric) list.append(s.key);
+    return list;
+}
+
+int MetricHistory::size(Metric metric, const QString &key, Resolution resolution) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Series *s = find(metric, key);
+    return s ? s->rings[resolution].size : 0;
+}
+
+int MetricHistory::range(Metric metric, const QString &key, Resolution resolution, qint64 fromMs, qint64 toMs,
+                         HistoryPoint *out, int maxPoints) const
+{
+    int written = 0;
+    forEach(metric, key, resolution, fromMs, toMs, [&](const HistoryPoint &p) {
+        if (written < maxPoints) out[written++] = p;
+    });
+    return written;
+}
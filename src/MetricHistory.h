@@ -0,0 +1,141 @@
+#ifndef METRICHISTORY_H
+#define METRICHISTORY_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <vector>
+
+struct SystemSnapshot;
+
+struct HistoryPoint {
+    qint64 timestampMs; // start of the bucket
+    double min;
+    double max;
+    double avg;
+};
+
+// Fixed-size history of the periodic metrics at several resolutions. Every
+// series is a ring of buckets per resolution, allocated when the series is
+// created, so memory use does not grow with uptime; once a ring is full the
+// oldest bucket is overwritten.
+//
+// Each sample is folded into the current bucket of every resolution, keeping
+// min, max and a running average, so a coarse bucket summarises all samples
+// that fell inside it. The newest bucket of each ring is the one still being
+// filled.
+//
+// The scalar metrics have one series, with an empty key. The others have one
+// per CPU, pressure resource, volume, block device or interface, named by
+// the key noted below, and created the first time it shows up. At most
+// kMaxSeries exist; past that, the series that has gone longest without a
+// sample is reset and reused.
+//
+// append() is called on the sampler thread; the queries may be called from
+// any thread.
+class MetricHistory
+{
+public:
+    enum Metric {
+        CpuPercent,
+        MemoryPercent,
+        MemoryUsed,
+        ProcessCount,
+        CoreBusy,          // CPU id: "0", "1", ...
+        PressureSome,      // "cpu", "memory" or "io"; the 10 s average
+        PressureFull,
+        VolumeUsedPercent, // mount point
+        DiskReadBytes,     // block device, per second
+        DiskWriteBytes,
+        DiskUtilization,
+        NetworkRxBytes,    // interface, per second
+        NetworkTxBytes,
+        MetricCount
+    };
+    enum Resolution { Seconds, Minutes, Hours, ResolutionCount };
+
+    // About 77 KB each.
+    static const int kMaxSeries = 256;
+
+    MetricHistory();
+
+    // Folds the metrics of the collectors that ran for s (its
+    // sampledMetrics) into the history. Values carried over from an earlier
+    // tick are not counted again. Does not allocate once every series in s
+    // exists.
+    void append(const SystemSnapshot &s);
+
+    static qint64 bucketMs(Resolution resolution);
+    // 10 minutes of seconds, 24 hours of minutes, 30 days of hours.
+    static int capacity(Resolution resolution);
+
+    // Keys of the series of metric, in the order they first appeared.
+    QStringList keys(Metric metric) const;
+
+    int size(Metric metric, const QString &key, Resolution resolution) const;
+
+    // Copies the buckets of metric's series key starting within
+    // [fromMs, toMs], oldest first, into out and returns how many were
+    // written (at most maxPoints).
+    int range(Metric metric, const QString &key, Resolution resolution, qint64 fromMs, qint64 toMs,
+              HistoryPoint *out, int maxPoints) const;
+
+    // Calls fn(const HistoryPoint &) for the same buckets as range() without
+    // copying them out. The history is locked for the duration, so fn should
+    // be short and must not call back into this object.
+    template <typename Fn>
+    void forEach(Metric metric, const QString &key, Resolution resolution, qint64 fromMs, qint64 toMs, Fn fn) const
+    {
+        QMutexLocker locker(&m_mutex);
+        const Series *series = find(metric, key);
+        if (!series) return;
+        const Ring &ring = series->rings[resolution];
+        const int cap = int(ring.timestamp.size());
+        for (int n = 0, slot = ring.oldest(); n < ring.size; ++n, slot = (slot + 1) % cap) {
+            const qint64 t = ring.timestamp[slot];
+            if (t < fromMs || t > toMs) continue;
+            fn(HistoryPoint{ t, ring.min[slot], ring.max[slot], ring.sum[slot] / ring.count[slot] });
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(MetricHistory)
+
+    // Column-wise storage of one resolution of one series.
+    struct Ring {
+        std::vector<qint64> timestamp;
+        std::vector<int> count;
+        std::vector<float> min;
+        std::vector<float> max;
+        std::vector<double> sum;
+        int head = 0; // slot of the bucket being filled
+        int size = 0;
+
+        int oldest() const { return (head - size + 1 + int(timestamp.size())) % int(timestamp.size()); }
+    };
+
+    struct Series {
+        Metric metric;
+        int id;      // CPU id or pressure resource; -1 when named by key alone
+        QString key;
+        qint64 lastMs;
+        Ring rings[ResolutionCount];
+    };
+
+    const Series *find(Metric metric, const QString &key) const;
+    // The series for (metric, id, name), created or recycled if it does not
+    // exist; null when every series already has a sample at timestampMs.
+    Series *series(Metric metric, int id, const QString &name, qint64 timestampMs);
+    void add(Metric metric, int id, const QString &name, qint64 timestampMs, double value);
+
+    mutable QMutex m_mutex;
+    // Reserved to kMaxSeries up front, so it never reallocates.
+    std::vector<Series> m_series;
+    // Index after the series appended last. append() visits the series in
+    // the same order every tick, so this is almost always the next one.
+    size_t m_next;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "MetricsExporter.h"
+#include "Logger.h"
+#include "OpenMetrics.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+const char kTextPlain[] = "text/plain; charset=utf-8";
+}
+
+MetricsExporter::MetricsExporter(SnapshotSource source, QObject *parent)
+    : QObject(parent), m_source(std::move(source)), m_server(nullptr), m_port(0)
+{
+    m_thread.setObjectName("MetricsExporter");
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool MetricsExporter::start(quint16 port, const QHostAddress &address)
+{
+    if (m_server) return true;
+    // Listen here so a bind error can be reported to the caller, then hand
+    // the server to the exporter thread; connections queue in the backlog
+    // until its event loop runs.
+    m_server = new QTcpServer;
+    if (!m_server->listen(address, port)) {
+        NEOFETCH_LOG(Logger::Warning, QString("Metrics exporter: cannot listen on %1:%2: %3")
+                     .arg(address.toString()).arg(port).arg(m_server->errorString()));
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+    m_port = m_server->serverPort();
+    m_server->moveToThread(&m_thread);
+    connect(m_server, &QTcpServer::newConnection, m_server, [this]() { acceptConnections(); });
+    connect(&m_thread, &QThread::finished, m_server, &QObject::deleteLater);
+    m_thread.start();
+    NEOFETCH_LOG(Logger::Info, QString("Metrics exporter: serving http://%1:%2/metrics").arg(address.toString()).arg(m_port));
+    return true;
+}
+
+void MetricsExporter::acceptConnections()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { handleRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        // Clients that never finish their request line are dropped.
+        QTimer::singleShot(kRequestTimeoutMs, socket, [socket]() { socket->abort(); });
+    }
+}
+
+void MetricsExporter::handleRequest(QTcpSocket *socket)
+{
+    // Only the request line matters: every response closes the connection,
+    // so headers and any body are never read.
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > kMaxRequestLine) socket->abort();
+        return;
+    }
+    char line[kMaxRequestLine];
+    const qint64 n = socket->readLine(line, sizeof(line));
+    disconnect(socket, &QTcpSocket::readyRead, nullptr, nullptr);
+    if (n <= 0) {
+        socket->abort();
+        return;
+    }
+
+    // "GET /metrics?x=y HTTP/1.1"
+    const bool head = std::strncmp(line, "HEAD ", 5) == 0;
+    const char *path = head ? line + 5 : std::strncmp(line, "GET ", 4) == 0 ? line + 4 : nullptr;
+    if (!path) {
+        respond(socket, 405, "Method Not Allowed", kTextPlain, "Only GET is supported.\n");
+        return;
+    }
+    const size_t pathLen = std::strcspn(path, " ?\r\n");
+    if (pathLen != 8 || std::strncmp(path, "/metrics", 8) != 0) {
+        respond(socket, 404, "Not Found", kTextPlain, "Metrics are at /metrics.\n");
+        return;
+    }
+
+    // Take the snapshot only for as long as rendering needs it, so the
+    // sampler's pool gets it back straight away.
+    {
+        const SystemSnapshotPtr snapshot = m_source();
+        if (!snapshot) {
+            respond(socket, 503, "Service Unavailable", kTextPlain, "No snapshot yet.\n");
+            return;
+        }
+        OpenMetrics::render(*snapshot, m_body);
+    }
+    respond(socket, 200, "OK", OpenMetrics::kContentType, m_body.constData(), m_body.size(), !head);
+}
+
+void MetricsExporter::respond(QTcpSocket *socket, int status, const char *reason, const char *contentType,
+                              const char *body, int size, bool sendBody)
+{
+    if (size < 0) size = int(std::strlen(body));
+    char header[256];
+    const int n = std::snprintf(header, sizeof(header),
+                                "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+                                status, reason, contentType, size);
+    socket->write(header, n);
+    if (sendBody && size > 0) socket->write(body, size);
+    socket->disconnectFromHost();
+}
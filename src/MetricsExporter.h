@@ -0,0 +1,59 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QThread>
+#include <functional>
+#include "SystemSnapshot.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+// A minimal HTTP/1.1 server that answers GET /metrics with the newest
+// snapshot in OpenMetrics format, for Prometheus to scrape.
+//
+// It runs on its own thread and only reads snapshots the sampler has
+// already published, so a slow or stuck client never delays sampling or the
+// GUI. The response body is rendered into one buffer that is reused for
+// every scrape. Each connection serves a single request and is closed.
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Returns the newest published snapshot; called on the exporter thread,
+    // so it must be thread-safe.
+    using SnapshotSource = std::function<SystemSnapshotPtr()>;
+
+    explicit MetricsExporter(SnapshotSource source, QObject *parent = nullptr);
+    ~MetricsExporter() override;
+
+    // Binds address:port (port 0 picks a free one) and starts serving.
+    // Defaults to loopback: the exporter has no authentication.
+    bool start(quint16 port, const QHostAddress &address = QHostAddress(QHostAddress::LocalHost));
+
+    // The bound port, or 0 when not serving.
+    quint16 port() const { return m_port; }
+
+private:
+    // Exporter thread only.
+    void acceptConnections();
+    void handleRequest(QTcpSocket *socket);
+    // size -1 means body is NUL-terminated. HEAD requests get the headers
+    // without the body.
+    void respond(QTcpSocket *socket, int status, const char *reason, const char *contentType,
+                 const char *body, int size = -1, bool sendBody = true);
+
+    static const int kMaxRequestLine = 4096;
+    static const int kRequestTimeoutMs = 5000;
+
+    SnapshotSource m_source;
+    QThread m_thread;
+    QTcpServer *m_server;
+    quint16 m_port;
+    QByteArray m_body;
+};
+
+#endif
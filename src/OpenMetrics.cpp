@@ -0,0 +1,271 @@
+#include "OpenMetrics.h"
+#include "SnapshotFormat.h"
+#include <cstdio>
+
+namespace OpenMetrics {
+
+const char kContentType[] = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+namespace {
+
+// Room for a machine with a few dozen CPUs and volumes; larger snapshots
+// grow the buffer once and keep it.
+const int kInitialCapacity = 16 * 1024;
+
+// Appends to a QByteArray without temporaries: numbers go through a stack
+// buffer and QString label values are encoded to UTF-8 by hand.
+class Writer
+{
+public:
+    explicit Writer(QByteArray &out) : m_out(out) {}
+
+    Writer &operator<<(const char *text)
+    {
+        m_out.append(text);
+        return *this;
+    }
+
+    Writer &integer(quint64 value)
+    {
+        char buf[24];
+        const int n = std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(value));
+        m_out.append(buf, n);
+        return *this;
+    }
+
+    Writer &number(double value)
+    {
+        char buf[32];
+        const int n = std::snprintf(buf, sizeof(buf), "%.6g", value);
+        m_out.append(buf, n);
+        return *this;
+    }
+
+    // Milliseconds as seconds with all three decimals. "%.6g" would print a
+    // Unix time as 1.7e+09, rounding it to the nearest 1000 s.
+    Writer &seconds(qint64 ms)
+    {
+        char buf[32];
+        const int n = std::snprintf(buf, sizeof(buf), "%lld.%03d", static_cast<long long>(ms / 1000), int(ms % 1000));
+        m_out.append(buf, n);
+        return *this;
+    }
+
+    // Label value with \\, " and newline escaped as OpenMetrics requires.
+    Writer &label(const QChar *p, int size)
+    {
+        for (int i = 0; i < size; ++i) {
+            uint c = p[i].unicode();
+            if (p[i].isHighSurrogate() && i + 1 < size && p[i + 1].isLowSurrogate()) {
+                c = QChar::surrogateToUcs4(p[i], p[i + 1]);
+                ++i;
+            }
+            if (c == '\\') m_out.append("\\\\", 2);
+            else if (c == '"') m_out.append("\\\"", 2);
+            else if (c == '\n') m_out.append("\\n", 2);
+            else appendUtf8(c);
+        }
+        return *this;
+    }
+    Writer &label(const QString &value) { return label(value.constData(), value.size()); }
+
+private:
+    void appendUtf8(uint c)
+    {
+        char buf[4];
+        int n;
+        if (c < 0x80) {
+            buf[0] = char(c);
+            n = 1;
+        } else if (c < 0x800) {
+            buf[0] = char(0xC0 | (c >> 6));
+            buf[1] = char(0x80 | (c & 0x3F));
+            n = 2;
+        } else if (c < 0x10000) {
+            buf[0] = char(0xE0 | (c >> 12));
+            buf[1] = char(0x80 | ((c >> 6) & 0x3F));
+            buf[2] = char(0x80 | (c & 0x3F));
+            n = 3;
+        } else {
+            buf[0] = char(0xF0 | (c >> 18));
+            buf[1] = char(0x80 | ((c >> 12) & 0x3F));
+            buf[2] = char(0x80 | ((c >> 6) & 0x3F));
+            buf[3] = char(0x80 | (c & 0x3F));
+            n = 4;
+        }
+        m_out.append(buf, n);
+    }
+
+    QByteArray &m_out;
+};
+
+// "# TYPE", "# UNIT" and "# HELP" lines of one metric family.
+void family(Writer &w, const char *name, const char *type, const char *unit, const char *help)
+{
+    w << "# TYPE " << name << " " << type << "\n";
+    if (unit) w << "# UNIT " << name << " " << unit << "\n";
+    w << "# HELP " << name << " " << help << "\n";
+}
+
+void renderCpu(Writer &w, const CpuTable &cpu, int cpuPercent)
+{
+    family(w, "neofetch_cpu_usage_ratio", "gauge", "ratio", "Share of the last interval all CPUs spent busy.");
+    w << "neofetch_cpu_usage_ratio ";
+    w.number(cpuPercent / 100.0) << "\n";
+
+    family(w, "neofetch_cpu_state_ratio", "gauge", "ratio", "Share of the last interval all CPUs spent in each state.");
+    for (int state = 0; state < CpuTable::StateCount; ++state) {
+        w << "neofetch_cpu_state_ratio{state=\"" << SnapshotFormat::cpuStateName(state) << "\"} ";
+        w.number(cpu.total[state] / 100.0) << "\n";
+    }
+
+    family(w, "neofetch_cpu_core_busy_ratio", "gauge", "ratio", "Share of the last interval each logical CPU spent busy.");
+    for (int i = 0; i < cpu.size(); ++i) {
+        w << "neofetch_cpu_core_busy_ratio{cpu=\"";
+        w.integer(quint64(cpu.cpuId[i])) << "\"} ";
+        w.number(cpu.busy(i) / 100.0) << "\n";
+    }
+}
+
+void renderVolumes(Writer &w, const VolumeTable &v)
+{
+    const struct {
+        const char *name;
+        const char *help;
+        const QVector<quint64> &column;
+    } columns[] = {
+        { "neofetch_filesystem_size_bytes", "Size of each mounted filesystem.", v.totalBytes },
+        { "neofetch_filesystem_free_bytes", "Free space on each mounted filesystem.", v.freeBytes },
+    };
+    for (const auto &c : columns) {
+        family(w, c.name, "gauge", "bytes", c.help);
+        for (int i = 0; i < v.size(); ++i) {
+            w << c.name << "{mountpoint=\"";
+            w.label(v.mountPoint[i]) << "\",fstype=\"";
+            w.label(v.fsType[i]) << "\"} ";
+            w.integer(c.column[i]) << "\n";
+        }
+    }
+}
+
+void renderNetwork(Writer &w, const NetworkTable &net)
+{
+    // Counter families are named without the _total suffix their samples
+    // carry; NetworkTable::Counter order.
+    static const struct {
+        const char *family;
+        const char *unit;
+        const char *help;
+    } counters[NetworkTable::CounterCount] = {
+        { "neofetch_network_receive_bytes", "bytes", "Bytes received on each interface." },
+        { "neofetch_network_transmit_bytes", "bytes", "Bytes sent on each interface." },
+        { "neofetch_network_receive_packets", nullptr, "Packets received on each interface." },
+        { "neofetch_network_transmit_packets", nullptr, "Packets sent on each interface." },
+        { "neofetch_network_receive_errors", nullptr, "Receive errors on each interface." },
+        { "neofetch_network_transmit_errors", nullptr, "Transmit errors on each interface." },
+        { "neofetch_network_receive_drops", nullptr, "Received packets dropped on each interface." },
+        { "neofetch_network_transmit_drops", nullptr, "Outgoing packets dropped on each interface." },
+    };
+    for (int c = 0; c < NetworkTable::CounterCount; ++c) {
+        family(w, counters[c].family, "counter", counters[c].unit, counters[c].help);
+        for (int i = 0; i < net.size(); ++i) {
+            w << counters[c].family << "_total{interface=\"";
+            w.label(net.name[i]) << "\"} ";
+            w.integer(net.total[c][i]) << "\n";
+        }
+    }
+
+    // Rates over the last interval, for dashboards without rate().
+    const struct {
+        const char *name;
+        const char *help;
+        NetworkTable::Counter counter;
+    } rates[] = {
+        { "neofetch_network_receive_bytes_per_second", "Receive rate over the last interval.", NetworkTable::RxBytes },
+        { "neofetch_network_transmit_bytes_per_second", "Transmit rate over the last interval.", NetworkTable::TxBytes },
+    };
+    for (const auto &r : rates) {
+        family(w, r.name, "gauge", nullptr, r.help);
+        for (int i = 0; i < net.size(); ++i) {
+            w << r.name << "{interface=\"";
+            w.label(net.name[i]) << "\"} ";
+            w.number(net.rate[r.counter][i]) << "\n";
+        }
+    }
+}
+
+void renderMemory(Writer &w, const MemoryBreakdown &m)
+{
+    family(w, "neofetch_memory_breakdown_bytes", "gauge", "bytes", "Physical memory and swap by kind, as the kernel accounts it.");
+    for (int f = 0; f < MemoryBreakdown::FieldCount; ++f) {
+        w << "neofetch_memory_breakdown_bytes{kind=\"" << SnapshotFormat::memoryFieldName(f) << "\"} ";
+        w.integer(m.bytes[f]) << "\n";
+    }
+}
+
+void renderPressure(Writer &w, const PressureStats &p)
+{
+    // Left out entirely where the kernel has no PSI, rather than reporting
+    // zero stall.
+    if (!p.available) return;
+    static const char *const windows[PressureStats::WindowCount] = { "10s", "60s", "300s" };
+    family(w, "neofetch_pressure_stalled_ratio", "gauge", "ratio",
+           "Share of time tasks stalled on each resource, averaged over a window (PSI).");
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        for (int kind = 0; kind < 2; ++kind) {
+            const float (&avg)[PressureStats::WindowCount] = kind ? p.full[r] : p.some[r];
+            for (int win = 0; win < PressureStats::WindowCount; ++win) {
+                w << "neofetch_pressure_stalled_ratio{resource=\"" << SnapshotFormat::pressureResourceName(r)
+                  << "\",kind=\"" << (kind ? "full" : "some") << "\",window=\"" << windows[win] << "\"} ";
+                w.number(avg[win] / 100.0) << "\n";
+            }
+        }
+    }
+}
+
+} // namespace
+
+void render(const SystemSnapshot &s, QByteArray &out)
+{
+    // resize(0) keeps a reserved buffer; reserve() only allocates the first
+    // time round.
+    if (out.capacity() < kInitialCapacity) out.reserve(kInitialCapacity);
+    out.resize(0);
+    Writer w(out);
+    const SystemInventory &inv = *s.inventory;
+
+    // Info families are named without the _info suffix their samples carry.
+    family(w, "neofetch", "info", nullptr, "Static facts about the host.");
+    w << "neofetch_info{os=\"";
+    w.label(inv.osInfo) << "\",kernel=\"";
+    w.label(inv.kernelInfo) << "\",cpu=\"";
+    w.label(inv.cpuInfo) << "\"} 1\n";
+
+    family(w, "neofetch_uptime_seconds", "gauge", "seconds", "Time since boot.");
+    w << "neofetch_uptime_seconds ";
+    w.integer(s.uptimeSeconds) << "\n";
+
+    renderCpu(w, s.cpu, s.cpuPercent);
+
+    family(w, "neofetch_memory_total_bytes", "gauge", "bytes", "Physical memory.");
+    w << "neofetch_memory_total_bytes ";
+    w.integer(s.memoryTotal) << "\n";
+    family(w, "neofetch_memory_used_bytes", "gauge", "bytes", "Physical memory in use.");
+    w << "neofetch_memory_used_bytes ";
+    w.integer(s.memoryUsed) << "\n";
+    renderMemory(w, s.memoryDetail);
+    renderPressure(w, s.pressure);
+
+    renderVolumes(w, s.volumes);
+    renderNetwork(w, s.network);
+
+    family(w, "neofetch_sample_duration_seconds", "gauge", "seconds", "Time the sampler spent producing this snapshot.");
+    w << "neofetch_sample_duration_seconds ";
+    w.number(s.sampleMicros / 1e6) << "\n";
+    family(w, "neofetch_snapshot_timestamp_seconds", "gauge", "seconds", "When this snapshot was taken, as a Unix time.");
+    w << "neofetch_snapshot_timestamp_seconds ";
+    w.seconds(s.timestampMs) << "\n";
+    w << "# EOF\n";
+}
+
+} // namespace OpenMetrics
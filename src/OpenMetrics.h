@@ -0,0 +1,32 @@
+#ifndef OPENMETRICS_H
+#define OPENMETRICS_H
+
+#include <QByteArray>
+#include "SystemSnapshot.h"
+
+// Renders a snapshot in the OpenMetrics text format (which Prometheus also
+// scrapes as its text exposition format):
+//
+//   neofetch_cpu_usage_ratio, neofetch_cpu_state_ratio{state},
+//   neofetch_cpu_core_busy_ratio{cpu}, neofetch_memory_{total,used}_bytes,
+//   neofetch_memory_breakdown_bytes{kind},
+//   neofetch_pressure_stalled_ratio{resource,kind,window} (Linux PSI only),
+//   neofetch_filesystem_{size,free}_bytes{mountpoint,fstype},
+//   neofetch_network_{receive,transmit}_{bytes,packets,errors,drops}_total
+//   and neofetch_network_{receive,transmit}_bytes_per_second{interface},
+//   neofetch_uptime_seconds,
+//   neofetch_info{os,kernel,cpu}, neofetch_sample_duration_seconds and
+//   neofetch_snapshot_timestamp_seconds, followed by "# EOF".
+//
+// render() overwrites out in place; once out has grown to the size of a
+// typical snapshot, rendering does not allocate.
+namespace OpenMetrics {
+
+// Content-Type for the HTTP response.
+extern const char kContentType[];
+
+void render(const SystemSnapshot &s, QByteArray &out);
+
+} // namespace OpenMetrics
+
+#endif
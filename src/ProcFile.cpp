@@ -0,0 +1,56 @@
+#include "ProcFile.h"
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+std::atomic<quint64> g_readCount{0};
+}
+
+ProcFile::~ProcFile()
+{
+    close();
+}
+
+bool ProcFile::open(const char *path)
+{
+    close();
+    m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) return false;
+    if (m_buffer.empty()) m_buffer.resize(4096);
+    return true;
+}
+
+void ProcFile::close()
+{
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_size = 0;
+}
+
+bool ProcFile::read()
+{
+    m_size = 0;
+    if (m_fd < 0) return false;
+
+    // seq_file-backed files (mountinfo, diskstats, net/dev, ...) hand back
+    // at most about a page per call, so a short read is not the end: keep
+    // reading at the advancing offset until pread() returns 0, doubling the
+    // buffer whenever it fills.
+    for (;;) {
+        if (m_size == m_buffer.size()) m_buffer.resize(m_buffer.size() * 2);
+        ssize_t n = ::pread(m_fd, m_buffer.data() + m_size, m_buffer.size() - m_size, off_t(m_size));
+        g_readCount.fetch_add(1, std::memory_order_relaxed);
+        if (n < 0) {
+            m_size = 0;
+            return false;
+        }
+        if (n == 0) return true;
+        m_size += size_t(n);
+    }
+}
+
+quint64 ProcFile::readCount()
+{
+    return g_readCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,119 @@
+#ifndef PROCFILE_H
+#define PROCFILE_H
+
+#include <QtGlobal>
+#include <vector>
+
+// A procfs/sysfs file that is opened once and re-read with pread() on every
+// tick. The read buffer only grows during warm-up, so steady-state reads
+// neither open files nor allocate.
+class ProcFile
+{
+public:
+    ProcFile() = default;
+    ~ProcFile();
+
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+    // For poll(); -1 when not open.
+    int fd() const { return m_fd; }
+
+    // Re-reads the file from offset 0. On failure the contents are empty.
+    bool read();
+
+    const char *begin() const { return m_buffer.data(); }
+    const char *end() const { return m_buffer.data() + m_size; }
+    size_t size() const { return m_size; }
+
+    // Number of pread() calls issued by all ProcFiles so far.
+    static quint64 readCount();
+
+private:
+    Q_DISABLE_COPY(ProcFile)
+
+    int m_fd = -1;
+    std::vector<char> m_buffer;
+    size_t m_size = 0;
+};
+
+// Allocation-free helpers for walking the text ProcFile hands back. Every
+// function takes a [p, end) range and returns the position just past what it
+// consumed.
+namespace ProcParse {
+
+inline const char *skipSpaces(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char *skipToken(const char *p, const char *end)
+{
+    p = skipSpaces(p, end);
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n') ++p;
+    return p;
+}
+
+inline const char *nextLine(const char *p, const char *end)
+{
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+inline const char *parseU64(const char *p, const char *end, quint64 &out)
+{
+    p = skipSpaces(p, end);
+    quint64 v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + quint64(*p - '0');
+        ++p;
+    }
+    out = v;
+    return p;
+}
+
+// Parses "123.45" into whole units and hundredths, as found in /proc/uptime.
+inline const char *parseFixed2(const char *p, const char *end, quint64 &whole, quint64 &hundredths)
+{
+    p = parseU64(p, end, whole);
+    hundredths = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        for (int i = 0; i < 2; ++i) {
+            hundredths *= 10;
+            if (p < end && *p >= '0' && *p <= '9') hundredths += quint64(*p++ - '0');
+        }
+        while (p < end && *p >= '0' && *p <= '9') ++p;
+    }
+    return p;
+}
+
+inline bool startsWith(const char *p, const char *end, const char *prefix)
+{
+    while (*prefix) {
+        if (p >= end || *p != *prefix) return false;
+        ++p;
+        ++prefix;
+    }
+    return true;
+}
+
+// Finds a "Key: value" line (as in /proc/meminfo) and parses its value.
+inline bool findKeyU64(const char *p, const char *end, const char *key, quint64 &out)
+{
+    for (; p < end; p = nextLine(p, end)) {
+        if (!startsWith(p, end, key)) continue;
+        const char *q = p;
+        while (*key) { ++q; ++key; }
+        if (q < end && *q == ':') {
+            parseU64(q + 1, end, out);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace ProcParse
+
+#endif
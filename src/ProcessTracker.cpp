@@ -0,0 +1,80 @@
+#include "ProcessTracker.h"
+#include <algorithm>
+
+void ProcessTracker::begin(qint64 nowNs)
+{
+    m_current.clear();
+    m_cursor = 0;
+    m_lastPid = -1;
+    m_ordered = true;
+    m_scanNs = nowNs;
+}
+
+ProcessTracker::Entry &ProcessTracker::add(qint64 pid, quint64 startTime)
+{
+    auto it = m_prev.begin() + m_cursor;
+    if (pid > m_lastPid) {
+        while (it != m_prev.end() && it->pid < pid) ++it;
+    } else {
+        m_ordered = false;
+        it = std::lower_bound(m_prev.begin(), m_prev.end(), pid, [](const Entry &e, qint64 p) { return e.pid < p; });
+    }
+    m_cursor = size_t(it - m_prev.begin());
+    m_lastPid = pid;
+
+    m_current.emplace_back();
+    Entry &e = m_current.back();
+    e.pid = pid;
+    e.startTime = startTime;
+    if (it != m_prev.end() && it->pid == pid && it->startTime == startTime) {
+        // Each previous entry is matched at most once, so its name can be
+        // taken rather than shared.
+        e.name.swap(it->name);
+        e.prevCpuTime = it->cpuTime;
+        e.rssBytes = it->rssBytes;
+        e.hasPrev = true;
+    }
+    return e;
+}
+
+void ProcessTracker::finish(double unitsPerSecond, int cpuCount, int limit, ProcessTable &table)
+{
+    if (!m_ordered)
+        std::sort(m_current.begin(), m_current.end(), [](const Entry &a, const Entry &b) { return a.pid < b.pid; });
+
+    // Only entries matched against a previous scan have a baseline.
+    const double seconds = (m_scanNs - m_prevScanNs) / 1e9;
+    const double scale = seconds > 0 && unitsPerSecond > 0 ? 100.0 / (unitsPerSecond * seconds * std::max(cpuCount, 1)) : 0.0;
+    m_order.clear();
+    for (size_t i = 0; i < m_current.size(); ++i) {
+        Entry &e = m_current[i];
+        e.cpuPercent = e.hasPrev && e.cpuTime >= e.prevCpuTime ? float((e.cpuTime - e.prevCpuTime) * scale) : 0.0f;
+        m_order.push_back(int(i));
+    }
+
+    // Only the top limit are put in order; the rest are merely partitioned
+    // behind them.
+    const int n = std::min(std::max(limit, 0), int(m_order.size()));
+    auto busier = [this](int a, int b) {
+        const Entry &x = m_current[size_t(a)];
+        const Entry &y = m_current[size_t(b)];
+        if (x.cpuPercent != y.cpuPercent) return x.cpuPercent > y.cpuPercent;
+        if (x.rssBytes != y.rssBytes) return x.rssBytes > y.rssBytes;
+        return x.pid < y.pid;
+    };
+    if (n > 0 && n < int(m_order.size())) std::nth_element(m_order.begin(), m_order.begin() + n, m_order.end(), busier);
+    std::sort(m_order.begin(), m_order.begin() + n, busier);
+
+    table.resize(n);
+    table.total = int(m_current.size());
+    for (int row = 0; row < n; ++row) {
+        const Entry &e = m_current[size_t(m_order[size_t(row)])];
+        table.pid[row] = e.pid;
+        table.name[row] = e.name;
+        table.cpuPercent[row] = e.cpuPercent;
+        table.rssBytes[row] = e.rssBytes;
+    }
+
+    m_prev.swap(m_current);
+    m_prevScanNs = m_scanNs;
+}
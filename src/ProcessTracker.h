@@ -0,0 +1,56 @@
+#ifndef PROCESSTRACKER_H
+#define PROCESSTRACKER_H
+
+#include <QString>
+#include <vector>
+#include "SystemSnapshot.h"
+
+// Turns repeated scans of the process list into per-process CPU shares and
+// keeps the busiest few in a ProcessTable.
+//
+// What is known about a process (its name, its last CPU time) carries over
+// from one scan to the next, so a backend only parses a name the first time
+// it sees a process. Processes reported in ascending pid order, as /proc
+// lists them, are matched against the previous scan with a forward merge;
+// any other order falls back to binary searches and one sort per scan. The
+// entry vectors are swapped rather than rebuilt and only the top few are
+// ever sorted, so a scan of tens of thousands of processes allocates
+// nothing but the names of new ones.
+class ProcessTracker
+{
+public:
+    struct Entry {
+        qint64 pid = 0;
+        quint64 startTime = 0;   // tells a reused pid from its previous owner
+        quint64 cpuTime = 0;     // cumulative user + system time, in backend units
+        quint64 rssBytes = 0;
+        QString name;            // empty for a process seen for the first time
+        quint64 prevCpuTime = 0;
+        bool hasPrev = false;    // prevCpuTime is from the previous scan
+        float cpuPercent = 0;
+    };
+
+    // Starts a scan taken at nowNs on a monotonic clock.
+    void begin(qint64 nowNs);
+    // The entry for pid in this scan, with the name and previous CPU time
+    // carried over if the same process was seen last scan. The caller sets
+    // cpuTime and rssBytes, and name when it is empty. The reference is
+    // valid until the next add().
+    Entry &add(qint64 pid, quint64 startTime);
+    // Ends the scan. CPU shares are relative to all cpuCount CPUs, with
+    // cpuTime counting unitsPerSecond per second; the limit busiest
+    // processes go to table, busiest first.
+    void finish(double unitsPerSecond, int cpuCount, int limit, ProcessTable &table);
+
+private:
+    std::vector<Entry> m_prev;     // last scan, sorted by pid
+    std::vector<Entry> m_current;
+    std::vector<int> m_order;      // indices into m_current for the selection
+    size_t m_cursor = 0;           // merge position in m_prev
+    qint64 m_lastPid = -1;
+    bool m_ordered = true;         // pids of this scan came in ascending order
+    qint64 m_scanNs = 0;
+    qint64 m_prevScanNs = 0;
+};
+
+#endif
@@ -0,0 +1,405 @@
+#include "SnapshotFormat.h"
+#include "Instrumentation.h"
+#include <QDateTime>
+#include <QStringList>
+#include <QVariantMap>
+
+namespace SnapshotFormat {
+
+QString gib(quint64 bytes)
+{
+    return QString::number(bytes / (1024.0 * 1024.0 * 1024.0), 'f', 1);
+}
+
+QString bytes(double bytes)
+{
+    static const char *const units[] = { "KiB", "MiB", "GiB", "TiB" };
+    if (bytes < 1024) return QString("%1 B").arg(bytes, 0, 'f', 0);
+    int unit = 0;
+    double value = bytes / 1024;
+    while (value >= 1024 && unit < 3) {
+        value /= 1024;
+        ++unit;
+    }
+    return QString("%1 %2").arg(value, 0, 'f', 1).arg(units[unit]);
+}
+
+QString uptime(const SystemSnapshot &s)
+{
+    if (s.timestampMs == 0) return "Loading...";
+    quint64 days = (s.uptimeSeconds / 60) / 1440;
+    quint64 mins = (s.uptimeSeconds / 60) % 1440;
+    return QString("Clock %1 days, %2 mins").arg(days).arg(mins);
+}
+
+QString memoryInfo(const SystemSnapshot &s)
+{
+    if (s.timestampMs == 0) return "Loading...";
+    if (s.memoryTotal == 0) return "Unknown";
+    return QString("%1 GiB RAM").arg(s.memoryTotal / (1024ull * 1024 * 1024));
+}
+
+QString memoryModule(const MemoryModule &m)
+{
+    QString info = QString("%1 - %2 GB%3")
+        .arg(m.manufacturer.isEmpty() ? "Unknown" : m.manufacturer)
+        .arg(gib(m.capacityBytes))
+        .arg(m.partNumber.isEmpty() ? "" : (", " + m.partNumber));
+    if (m.speedMHz) info += QString(", %1 MHz").arg(m.speedMHz);
+    return info;
+}
+
+QString memoryModules(const SystemInventory &inv)
+{
+    if (inv.memoryModules.isEmpty()) return inv.memoryModulesNote;
+    QStringList lines;
+    for (const MemoryModule &m : inv.memoryModules) lines.append(memoryModule(m));
+    return lines.join("\n");
+}
+
+const char *memoryFieldName(int field)
+{
+    static const char *const names[MemoryBreakdown::FieldCount] = {
+        "available", "cached", "buffers", "shmem", "slab", "swap_total", "swap_used", "dirty", "writeback",
+        "hugepages_total", "hugepages_free"
+    };
+    return field >= 0 && field < MemoryBreakdown::FieldCount ? names[field] : "";
+}
+
+QString memoryDetail(const MemoryBreakdown &m)
+{
+    static const struct {
+        MemoryBreakdown::Field field;
+        const char *label;
+    } plain[] = {
+        { MemoryBreakdown::Available, "Available" }, { MemoryBreakdown::Cached, "Cached" },
+        { MemoryBreakdown::Buffers, "Buffers" }, { MemoryBreakdown::Shmem, "Shmem" },
+        { MemoryBreakdown::Slab, "Slab" }, { MemoryBreakdown::Dirty, "Dirty" },
+        { MemoryBreakdown::Writeback, "Writeback" },
+    };
+    QStringList parts;
+    for (const auto &f : plain)
+        if (m.bytes[f.field]) parts.append(QString("%1 %2").arg(f.label, bytes(m.bytes[f.field])));
+    if (m.bytes[MemoryBreakdown::SwapTotal])
+        parts.append(QString("Swap %1 / %2").arg(bytes(m.bytes[MemoryBreakdown::SwapUsed]), bytes(m.bytes[MemoryBreakdown::SwapTotal])));
+    if (m.bytes[MemoryBreakdown::HugePagesTotal])
+        parts.append(QString("Huge pages %1 free of %2").arg(bytes(m.bytes[MemoryBreakdown::HugePagesFree]), bytes(m.bytes[MemoryBreakdown::HugePagesTotal])));
+    return parts.join(", ");
+}
+
+QVariantMap memoryDetailToVariantMap(const MemoryBreakdown &m)
+{
+    QVariantMap map;
+    for (int f = 0; f < MemoryBreakdown::FieldCount; ++f) map[memoryFieldName(f)] = m.bytes[f];
+    return map;
+}
+
+const char *pressureResourceName(int resource)
+{
+    static const char *const names[PressureStats::ResourceCount] = { "cpu", "memory", "io" };
+    return resource >= 0 && resource < PressureStats::ResourceCount ? names[resource] : "";
+}
+
+QString pressure(const PressureStats &p)
+{
+    if (!p.available) return "Pressure: not reported";
+    QStringList parts;
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        QString part = QString("%1 %2%").arg(pressureResourceName(r)).arg(p.some[r][PressureStats::Avg10], 0, 'f', 1);
+        // Full CPU pressure is only defined for cgroups; system-wide it is 0.
+        if (r != PressureStats::Cpu) part += QString(" (full %1%)").arg(p.full[r][PressureStats::Avg10], 0, 'f', 1);
+        parts.append(part);
+    }
+    return QString("Pressure (10 s): %1").arg(parts.join(", "));
+}
+
+QVariantMap pressureToVariantMap(const PressureStats &p)
+{
+    QVariantMap map;
+    map["available"] = p.available;
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        QVariantList some, full;
+        for (int w = 0; w < PressureStats::WindowCount; ++w) {
+            some.append(p.some[r][w]);
+            full.append(p.full[r][w]);
+        }
+        QVariantMap resource;
+        resource["some"] = some;
+        resource["full"] = full;
+        map[pressureResourceName(r)] = resource;
+    }
+    return map;
+}
+
+QString diskDevice(const DiskDevice &d)
+{
+    QString size = d.sizeBytes ? gib(d.sizeBytes) + " GB" : QString("Unknown");
+    return QString("%1 - %2, %3, S/N: %4")
+        .arg(d.model.isEmpty() ? "Unknown" : d.model)
+        .arg(size)
+        .arg(d.interfaceType.isEmpty() ? "Unknown" : d.interfaceType)
+        .arg(d.serial.isEmpty() ? QString("Unknown") : d.serial.left(20));
+}
+
+QString diskDevices(const SystemInventory &inv)
+{
+    if (inv.diskDevices.isEmpty()) return inv.diskDevicesNote;
+    QStringList lines;
+    for (const DiskDevice &d : inv.diskDevices) lines.append(diskDevice(d));
+    return lines.join("\n");
+}
+
+QString volume(const VolumeTable &v, int i)
+{
+    return QString("%1 %2 %3 GiB / %4 GiB (%5%)")
+        .arg(v.mountPoint[i]).arg(v.fsType[i])
+        .arg(gib(v.usedBytes(i))).arg(gib(v.totalBytes[i]))
+        .arg(v.percentUsed(i));
+}
+
+QString process(const ProcessTable &p, int i)
+{
+    return QString("%1  %2 %3%  %4 MiB")
+        .arg(p.pid[i], 7).arg(p.name[i].left(20), -20)
+        .arg(p.cpuPercent[i], 5, 'f', 1).arg(p.rssBytes[i] / (1024.0 * 1024.0), 9, 'f', 1);
+}
+
+QString processHeader()
+{
+    return QString("%1  %2 %3  %4").arg("PID", 7).arg("Name", -20).arg("CPU", 6).arg("Memory", 13);
+}
+
+QVariantList processesToVariantList(const ProcessTable &p)
+{
+    QVariantList list;
+    list.reserve(p.size());
+    for (int i = 0; i < p.size(); ++i) {
+        QVariantMap d;
+        d["pid"] = p.pid[i];
+        d["name"] = p.name[i];
+        d["cpu"] = p.cpuPercent[i];
+        d["rssBytes"] = p.rssBytes[i];
+        list.append(d);
+    }
+    return list;
+}
+
+QString diskIo(const DiskIoTable &io, int i)
+{
+    return QString("r %1  w %2  %3 IOPS  %4 ms  %5% busy")
+        .arg(byteRate(io.rate[DiskIoTable::ReadBytes][i]), byteRate(io.rate[DiskIoTable::WriteBytes][i]))
+        .arg(io.iops(i), 0, 'f', 0).arg(io.latencyMs[i], 0, 'f', 1).arg(io.utilization[i], 0, 'f', 0);
+}
+
+QVariantList volumesToVariantList(const VolumeTable &v, const DiskIoTable &io)
+{
+    QVariantList list;
+    list.reserve(v.size());
+    for (int i = 0; i < v.size(); ++i) {
+        QVariantMap d;
+        d["drive"] = v.mountPoint[i];
+        d["fstype"] = v.fsType[i];
+        d["total"] = gib(v.totalBytes[i]);
+        d["used"] = gib(v.usedBytes(i));
+        d["percent"] = v.percentUsed(i);
+        d["totalBytes"] = v.totalBytes[i];
+        d["freeBytes"] = v.freeBytes[i];
+        const int row = io.indexOf(v.device[i]);
+        if (row >= 0) {
+            d["device"] = v.device[i];
+            d["readBytesPerSecond"] = io.rate[DiskIoTable::ReadBytes][row];
+            d["writeBytesPerSecond"] = io.rate[DiskIoTable::WriteBytes][row];
+            d["iops"] = io.iops(row);
+            d["latencyMs"] = io.latencyMs[row];
+            d["utilization"] = io.utilization[row];
+        }
+        list.append(d);
+    }
+    return list;
+}
+
+QString byteRate(double bytesPerSecond)
+{
+    return bytes(bytesPerSecond) + "/s";
+}
+
+QString networkInterface(const NetworkTable &n, int i)
+{
+    QString text = QString("%1  rx %2  tx %3  %4/%5 pkt/s").arg(n.name[i])
+        .arg(byteRate(n.rate[NetworkTable::RxBytes][i]), byteRate(n.rate[NetworkTable::TxBytes][i]))
+        .arg(n.rate[NetworkTable::RxPackets][i], 0, 'f', 0).arg(n.rate[NetworkTable::TxPackets][i], 0, 'f', 0);
+    const float errors = n.rate[NetworkTable::RxErrors][i] + n.rate[NetworkTable::TxErrors][i];
+    const float drops = n.rate[NetworkTable::RxDrops][i] + n.rate[NetworkTable::TxDrops][i];
+    if (errors > 0) text += QString("  %1 err/s").arg(errors, 0, 'f', 1);
+    if (drops > 0) text += QString("  %1 drop/s").arg(drops, 0, 'f', 1);
+    return text;
+}
+
+const char *networkCounterName(int counter)
+{
+    static const char *const names[NetworkTable::CounterCount] = {
+        "rxBytes", "txBytes", "rxPackets", "txPackets", "rxErrors", "txErrors", "rxDrops", "txDrops"
+    };
+    return counter >= 0 && counter < NetworkTable::CounterCount ? names[counter] : "";
+}
+
+QVariantList networkToVariantList(const NetworkTable &n)
+{
+    QVariantList list;
+    list.reserve(n.size());
+    for (int i = 0; i < n.size(); ++i) {
+        QVariantMap d;
+        d["name"] = n.name[i];
+        d["ifIndex"] = n.ifIndex[i];
+        for (int c = 0; c < NetworkTable::CounterCount; ++c) {
+            d[networkCounterName(c)] = n.total[c][i];
+            d[QString(networkCounterName(c)) + "PerSecond"] = n.rate[c][i];
+        }
+        list.append(d);
+    }
+    return list;
+}
+
+const char *cpuStateName(int state)
+{
+    static const char *const names[CpuTable::StateCount] = {
+        "user", "nice", "system", "idle", "iowait", "irq", "softirq", "steal"
+    };
+    return state >= 0 && state < CpuTable::StateCount ? names[state] : "";
+}
+
+QString cpuTimes(const CpuTable &cpu)
+{
+    QString text;
+    for (int i = 0; i < CpuTable::StateCount; ++i) {
+        if (i) text += ", ";
+        text += QString("%1 %2%").arg(cpuStateName(i)).arg(cpu.total[i], 0, 'f', 1);
+    }
+    return text;
+}
+
+QString cpuCores(const CpuTable &cpu)
+{
+    QStringList cores;
+    cores.reserve(cpu.size());
+    for (int i = 0; i < cpu.size(); ++i)
+        cores.append(QString("cpu%1 %2%").arg(cpu.cpuId[i]).arg(cpu.busy(i), 0, 'f', 0));
+    return cores.join("  ");
+}
+
+QVariantMap cpuTimesToVariantMap(const CpuTable &cpu)
+{
+    QVariantMap m;
+    for (int i = 0; i < CpuTable::StateCount; ++i) m[cpuStateName(i)] = cpu.total[i];
+    m["busy"] = cpu.totalBusy();
+    return m;
+}
+
+QVariantList cpuCoresToVariantList(const CpuTable &cpu)
+{
+    QVariantList list;
+    list.reserve(cpu.size());
+    for (int i = 0; i < cpu.size(); ++i) {
+        QVariantMap m;
+        m["id"] = cpu.cpuId[i];
+        for (int s = 0; s < CpuTable::StateCount; ++s) m[cpuStateName(s)] = cpu.share[s][i];
+        m["busy"] = cpu.busy(i);
+        list.append(m);
+    }
+    return list;
+}
+
+QString collector(const CollectorStat &c)
+{
+    QString text = QString("%1: ").arg(c.name);
+    text += c.lastMicros < 0 ? QString("not finished yet") : QString("%1 ms").arg(c.lastMicros / 1000.0, 0, 'f', 1);
+    if (c.timeouts) text += QString(", %1 timeout(s)").arg(c.timeouts);
+    if (c.stale) text += ", stale";
+    return text;
+}
+
+QString schedule(const SystemSnapshot &s)
+{
+    return QString("intervals x%1, %2").arg(s.intervalStretch)
+        .arg(s.wakeupsPerSecond > 0 ? QString("%1 wakeups/s").arg(s.wakeupsPerSecond, 0, 'f', 2) : QString("measuring wakeups"));
+}
+
+namespace {
+
+QString alertName(const AlertEvent &e)
+{
+    return e.subject.isEmpty() ? e.rule : QString("%1 (%2)").arg(e.rule, e.subject);
+}
+
+} // namespace
+
+QString alertEvent(const AlertEvent &e)
+{
+    return QString("%1 %2: %3 = %4").arg(QDateTime::fromMSecsSinceEpoch(e.timestampMs).toString("HH:mm:ss"))
+        .arg(e.firing ? "firing" : "cleared").arg(alertName(e)).arg(e.value, 0, 'f', 1);
+}
+
+QString firingAlerts(const AlertTable &alerts)
+{
+    if (alerts.firing.isEmpty()) return QString();
+    QStringList names;
+    for (const AlertEvent &e : alerts.firing) names.append(alertName(e));
+    return QString("Alert: %1").arg(names.join("; "));
+}
+
+QVariantList alertsToVariantList(const AlertTable &alerts)
+{
+    QVariantList list;
+    for (const AlertEvent &e : alerts.firing) {
+        QVariantMap map;
+        map["rule"] = e.rule;
+        map["subject"] = e.subject;
+        map["value"] = e.value;
+        map["since"] = e.timestampMs;
+        list.append(map);
+    }
+    return list;
+}
+
+QString duration(double ns)
+{
+    if (ns < 1000) return QString("%1 ns").arg(ns, 0, 'f', 0);
+    if (ns < 1000 * 1000) return QString("%1 us").arg(ns / 1000, 0, 'f', 1);
+    return QString("%1 ms").arg(ns / (1000 * 1000), 0, 'f', 1);
+}
+
+QString latency(const char *name, const LatencyHistogram::Summary &s)
+{
+    return QString("%1: p50 %2, p99 %3, max %4, n=%5").arg(name)
+        .arg(duration(s.p50Ns), duration(s.p99Ns), duration(s.maxNs)).arg(s.count);
+}
+
+QString instrumentation(const Instrumentation &instr)
+{
+    QString text;
+    double tickMeanNs = 0;
+    for (int p = 0; p < Instrumentation::ProbeCount; ++p) {
+        const Instrumentation::Probe probe = Instrumentation::Probe(p);
+        const LatencyHistogram::Summary s = instr.histogram(probe).summary();
+        if (!s.count) continue;
+        text += latency(Instrumentation::probeName(probe), s) + '\n';
+        // Without a sampler (the CLI) a tick is just the metric collectors.
+        if (probe == Instrumentation::SamplerTick) tickMeanNs = s.meanNs;
+        else if (p < Instrumentation::SamplerTick && !instr.histogram(Instrumentation::SamplerTick).count()) tickMeanNs += s.meanNs;
+    }
+
+    QStringList counters;
+    for (int c = 0; c < Instrumentation::CounterCount; ++c) {
+        const Instrumentation::Counter counter = Instrumentation::Counter(c);
+        if (instr.counter(counter)) counters << QString("%1 %2").arg(instr.counter(counter)).arg(Instrumentation::counterName(counter));
+    }
+    if (!counters.isEmpty()) text += QString("Counters: %1\n").arg(counters.join(", "));
+
+    const double overhead = instr.overheadPerTickNs();
+    text += QString("Instrumentation: %1 per tick").arg(duration(overhead));
+    if (tickMeanNs > 0) text += QString(" (%1% of a tick)").arg(100 * overhead / tickMeanNs, 0, 'f', 2);
+    text += QString(", %1 per probe\n").arg(duration(instr.probeCostNs()));
+    return text;
+}
+
+} // namespace SnapshotFormat
@@ -0,0 +1,104 @@
+#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+#include "SystemSnapshot.h"
+#include "LatencyHistogram.h"
+
+class Instrumentation;
+
+// Turns the raw values in a snapshot into display text. Collectors never
+// format; the UI, the provider's string properties and exports call these.
+namespace SnapshotFormat {
+
+// Bytes as GiB with one decimal, e.g. "931.5".
+QString gib(quint64 bytes);
+// "512 B", "34.0 KiB", "1.2 MiB", "3.1 GiB"
+QString bytes(double bytes);
+
+QString uptime(const SystemSnapshot &s);
+QString memoryInfo(const SystemSnapshot &s);
+QString memoryModule(const MemoryModule &m);
+QString memoryModules(const SystemInventory &inv);
+// "available", "cached", ..., "swap_total", ... for MemoryBreakdown::Field.
+const char *memoryFieldName(int field);
+// "Cached 10.7 GiB, Buffers 500.3 MiB, ..., Swap 0 B / 8.0 GiB"; fields
+// the platform does not report are left out.
+QString memoryDetail(const MemoryBreakdown &m);
+// One entry per MemoryBreakdown field, keyed by memoryFieldName().
+QVariantMap memoryDetailToVariantMap(const MemoryBreakdown &m);
+// "cpu", "memory", "io" for PressureStats::Resource.
+const char *pressureResourceName(int resource);
+// "Pressure (10 s): cpu 4.2%, memory 0.4% (full 0.1%), io 1.9% (full 1.0%)"
+QString pressure(const PressureStats &p);
+// {available, cpu: {some: [avg10, avg60, avg300], full: [...]}, memory, io}
+QVariantMap pressureToVariantMap(const PressureStats &p);
+QString diskDevice(const DiskDevice &d);
+QString diskDevices(const SystemInventory &inv);
+// "C: NTFS 120.4 GiB / 476.3 GiB (25%)"
+QString volume(const VolumeTable &v, int i);
+
+// "r 1.2 MiB/s  w 34.0 KiB/s  115 IOPS  4.0 ms  12% busy"
+QString diskIo(const DiskIoTable &io, int i);
+
+// The legacy getDiskInfo() shape: one QVariantMap per volume, plus the I/O
+// rates of its device when it has a row in io.
+QVariantList volumesToVariantList(const VolumeTable &v, const DiskIoTable &io);
+
+// "  4242  firefox              12.3%    512.0 MiB", fixed-width columns.
+QString process(const ProcessTable &p, int i);
+// "PID  Name  CPU  Memory" header matching process().
+QString processHeader();
+// {pid, name, cpu, rssBytes} per row, busiest first.
+QVariantList processesToVariantList(const ProcessTable &p);
+
+// "512 B/s", "34.0 KiB/s", "1.2 MiB/s"
+QString byteRate(double bytesPerSecond);
+// "eth0  rx 1.2 MiB/s  tx 34.0 KiB/s  812/640 pkt/s", with errors and drops
+// per second appended only when there are any.
+QString networkInterface(const NetworkTable &n, int i);
+// "rxBytes", "txBytes", ... for NetworkTable::Counter.
+const char *networkCounterName(int counter);
+// {name, ifIndex, rxBytes, txBytes, ..., rxBytesPerSecond, ...} per
+// interface, in NetworkTable::Counter order.
+QVariantList networkToVariantList(const NetworkTable &n);
+
+// "user", "nice", ... for CpuTable::State.
+const char *cpuStateName(int state);
+// "user 3.1%, nice 0.0%, system 1.2%, ..." for the whole machine.
+QString cpuTimes(const CpuTable &cpu);
+// "cpu0 12%  cpu1 3%  ..." busy share per logical CPU.
+QString cpuCores(const CpuTable &cpu);
+// {user, nice, ..., steal, busy} for the whole machine.
+QVariantMap cpuTimesToVariantMap(const CpuTable &cpu);
+// One such map per logical CPU, plus its "id".
+QVariantList cpuCoresToVariantList(const CpuTable &cpu);
+
+// "Disk hardware: 153.2 ms" or "Disk hardware: 153.2 ms, 2 timeout(s), stale"
+QString collector(const CollectorStat &c);
+// "intervals x5, 0.21 wakeups/s"; the rate reads "measuring wakeups" during
+// the first minute.
+QString schedule(const SystemSnapshot &s);
+
+// "12:03:10 firing: cpuPercent > 90 for 30s = 97.0" or
+// "12:04:02 cleared: Disk full (/home) = 93.1"
+QString alertEvent(const AlertEvent &e);
+// "Alert: cpuPercent > 90 for 30s; Disk full (/home)", empty when nothing
+// is firing.
+QString firingAlerts(const AlertTable &alerts);
+// One {rule, subject, value, since} map per firing alert.
+QVariantList alertsToVariantList(const AlertTable &alerts);
+
+// "850 ns", "12.3 us", "4.1 ms"
+QString duration(double ns);
+// "fetchCpuUsage: p50 12.3 us, p99 40.1 us, max 55.0 us, n=120"
+QString latency(const char *name, const LatencyHistogram::Summary &s);
+// One latency line per probe that has recorded anything, the counters, and
+// the instrumentation's own overhead; lines end in '\n'.
+QString instrumentation(const Instrumentation &instr);
+
+} // namespace SnapshotFormat
+
+#endif
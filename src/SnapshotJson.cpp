@@ -0,0 +1,409 @@
+#include "SnapshotJson.h"
+#include "SnapshotFormat.h"
+#include "SystemBackend.h"
+#include <QStringList>
+#include <QSysInfo>
+#include <cmath>
+#include <cstdio>
+
+namespace SnapshotJson {
+
+namespace {
+
+// Room for a machine with a few dozen CPUs, volumes and interfaces; larger
+// snapshots grow the buffer once and keep it.
+const int kInitialCapacity = 8 * 1024;
+
+// Appends JSON to a QByteArray without temporaries, putting the commas
+// between members and elements itself: numbers go through a stack buffer
+// and strings are escaped and encoded to UTF-8 by hand.
+class Writer
+{
+public:
+    explicit Writer(QByteArray &out) : m_out(out), m_first(true) {}
+
+    Writer &beginObject() { return open('{'); }
+    Writer &endObject() { return close('}'); }
+    Writer &beginArray() { return open('['); }
+    Writer &endArray() { return close(']'); }
+
+    // "name": ; the value written next belongs to it.
+    Writer &key(const char *name)
+    {
+        separate();
+        m_out.append('"');
+        m_out.append(name);
+        m_out.append("\":", 2);
+        m_first = true;
+        return *this;
+    }
+
+    Writer &integer(qint64 value)
+    {
+        separate();
+        char buf[24];
+        const int n = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+        m_out.append(buf, n);
+        return *this;
+    }
+
+    Writer &unsignedInteger(quint64 value)
+    {
+        separate();
+        char buf[24];
+        const int n = std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(value));
+        m_out.append(buf, n);
+        return *this;
+    }
+
+    // Whole numbers in full, others to six significant digits; JSON has no
+    // NaN or infinity, so those are null.
+    Writer &number(double value)
+    {
+        separate();
+        if (!std::isfinite(value)) {
+            m_out.append("null", 4);
+            return *this;
+        }
+        char buf[32];
+        const bool whole = value == std::trunc(value) && std::fabs(value) < 1e15;
+        const int n = std::snprintf(buf, sizeof(buf), whole ? "%.0f" : "%.6g", value);
+        m_out.append(buf, n);
+        return *this;
+    }
+
+    Writer &boolean(bool value)
+    {
+        separate();
+        if (value) m_out.append("true", 4);
+        else m_out.append("false", 5);
+        return *this;
+    }
+
+    // Quotes, backslashes and control characters escaped; lone surrogates,
+    // which UTF-8 cannot carry, become U+FFFD.
+    Writer &string(const QString &value)
+    {
+        separate();
+        m_out.append('"');
+        const QChar *p = value.constData();
+        const int size = value.size();
+        for (int i = 0; i < size; ++i) {
+            uint c = p[i].unicode();
+            if (p[i].isHighSurrogate() && i + 1 < size && p[i + 1].isLowSurrogate()) {
+                c = QChar::surrogateToUcs4(p[i], p[i + 1]);
+                ++i;
+            } else if (p[i].isSurrogate()) {
+                c = 0xFFFD;
+            }
+            if (c == '"') m_out.append("\\\"", 2);
+            else if (c == '\\') m_out.append("\\\\", 2);
+            else if (c == '\n') m_out.append("\\n", 2);
+            else if (c == '\r') m_out.append("\\r", 2);
+            else if (c == '\t') m_out.append("\\t", 2);
+            else if (c < 0x20) {
+                char buf[8];
+                const int n = std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                m_out.append(buf, n);
+            } else {
+                appendUtf8(c);
+            }
+        }
+        m_out.append('"');
+        return *this;
+    }
+
+private:
+    Writer &open(char bracket)
+    {
+        separate();
+        m_out.append(bracket);
+        m_first = true;
+        return *this;
+    }
+
+    Writer &close(char bracket)
+    {
+        m_out.append(bracket);
+        m_first = false;
+        return *this;
+    }
+
+    void separate()
+    {
+        if (!m_first) m_out.append(',');
+        m_first = false;
+    }
+
+    void appendUtf8(uint c)
+    {
+        char buf[4];
+        int n;
+        if (c < 0x80) {
+            buf[0] = char(c);
+            n = 1;
+        } else if (c < 0x800) {
+            buf[0] = char(0xC0 | (c >> 6));
+            buf[1] = char(0x80 | (c & 0x3F));
+            n = 2;
+        } else if (c < 0x10000) {
+            buf[0] = char(0xE0 | (c >> 12));
+            buf[1] = char(0x80 | ((c >> 6) & 0x3F));
+            buf[2] = char(0x80 | (c & 0x3F));
+            n = 3;
+        } else {
+            buf[0] = char(0xF0 | (c >> 18));
+            buf[1] = char(0x80 | ((c >> 12) & 0x3F));
+            buf[2] = char(0x80 | ((c >> 6) & 0x3F));
+            buf[3] = char(0x80 | (c & 0x3F));
+            n = 4;
+        }
+        m_out.append(buf, n);
+    }
+
+    QByteArray &m_out;
+    bool m_first; // nothing written yet in the current object or array
+};
+
+void renderSystem(Writer &w, const SystemInventory &inv)
+{
+    // Asked once: every other field comes from the inventory.
+    static const QString host = QSysInfo::machineHostName();
+    w.key("system").beginObject();
+    w.key("host").string(host);
+    w.key("user").string(inv.username);
+    w.key("os").string(inv.osInfo);
+    w.key("kernel").string(inv.kernelInfo);
+    w.key("cpu").string(inv.cpuInfo);
+    w.key("gpu").string(inv.gpuInfo);
+    w.key("display").string(inv.displayInfo);
+    w.key("shell").string(inv.shellInfo);
+    if (!inv.diskDevices.isEmpty()) {
+        w.key("diskDevices").beginArray();
+        for (const DiskDevice &d : inv.diskDevices) {
+            w.beginObject();
+            w.key("model").string(d.model);
+            w.key("sizeBytes").unsignedInteger(d.sizeBytes);
+            w.key("interface").string(d.interfaceType);
+            w.key("serial").string(d.serial);
+            w.endObject();
+        }
+        w.endArray();
+    }
+    if (!inv.memoryModules.isEmpty()) {
+        w.key("memoryModules").beginArray();
+        for (const MemoryModule &m : inv.memoryModules) {
+            w.beginObject();
+            w.key("manufacturer").string(m.manufacturer);
+            w.key("capacityBytes").unsignedInteger(m.capacityBytes);
+            w.key("speedMHz").unsignedInteger(m.speedMHz);
+            w.key("partNumber").string(m.partNumber);
+            w.endObject();
+        }
+        w.endArray();
+    }
+    w.endObject();
+}
+
+void renderCpu(Writer &w, const CpuTable &cpu, int cpuPercent)
+{
+    w.key("cpu").beginObject();
+    w.key("percent").integer(cpuPercent);
+    for (int state = 0; state < CpuTable::StateCount; ++state) w.key(SnapshotFormat::cpuStateName(state)).number(cpu.total[state]);
+    w.key("busy").number(cpu.totalBusy());
+    w.key("cores").beginArray();
+    for (int i = 0; i < cpu.size(); ++i) {
+        w.beginObject();
+        w.key("id").integer(cpu.cpuId[i]);
+        for (int state = 0; state < CpuTable::StateCount; ++state) w.key(SnapshotFormat::cpuStateName(state)).number(cpu.share[state][i]);
+        w.key("busy").number(cpu.busy(i));
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+}
+
+void renderMemory(Writer &w, const SystemSnapshot &s)
+{
+    w.key("memory").beginObject();
+    w.key("total").unsignedInteger(s.memoryTotal);
+    w.key("used").unsignedInteger(s.memoryUsed);
+    w.key("percent").integer(s.memoryPercent);
+    for (int f = 0; f < MemoryBreakdown::FieldCount; ++f)
+        w.key(SnapshotFormat::memoryFieldName(f)).unsignedInteger(s.memoryDetail.bytes[f]);
+    w.endObject();
+}
+
+void renderPressure(Writer &w, const PressureStats &p)
+{
+    w.key("pressure").beginObject();
+    w.key("available").boolean(p.available);
+    if (p.available) {
+        for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+            w.key(SnapshotFormat::pressureResourceName(r)).beginObject();
+            for (int kind = 0; kind < 2; ++kind) {
+                const float (&avg)[PressureStats::WindowCount] = kind ? p.full[r] : p.some[r];
+                w.key(kind ? "full" : "some").beginArray();
+                for (float value : avg) w.number(value);
+                w.endArray();
+            }
+            w.endObject();
+        }
+    }
+    w.endObject();
+}
+
+void renderVolumes(Writer &w, const VolumeTable &v)
+{
+    w.key("volumes").beginArray();
+    for (int i = 0; i < v.size(); ++i) {
+        w.beginObject();
+        w.key("mountPoint").string(v.mountPoint[i]);
+        w.key("fstype").string(v.fsType[i]);
+        w.key("device").string(v.device[i]);
+        w.key("totalBytes").unsignedInteger(v.totalBytes[i]);
+        w.key("freeBytes").unsignedInteger(v.freeBytes[i]);
+        w.key("percent").integer(v.percentUsed(i));
+        w.endObject();
+    }
+    w.endArray();
+}
+
+void renderDiskIo(Writer &w, const DiskIoTable &io)
+{
+    static const char *const rates[DiskIoTable::RateCount] = {
+        "readBytesPerSecond", "writeBytesPerSecond", "readsPerSecond", "writesPerSecond"
+    };
+    w.key("diskIo").beginArray();
+    for (int i = 0; i < io.size(); ++i) {
+        w.beginObject();
+        w.key("name").string(io.name[i]);
+        for (int r = 0; r < DiskIoTable::RateCount; ++r) w.key(rates[r]).number(io.rate[r][i]);
+        w.key("latencyMs").number(io.latencyMs[i]);
+        w.key("utilization").number(io.utilization[i]);
+        w.endObject();
+    }
+    w.endArray();
+}
+
+void renderNetwork(Writer &w, const NetworkTable &net)
+{
+    // "rxBytesPerSecond" and so on, built once.
+    static const struct RateKeys {
+        QByteArray keys[NetworkTable::CounterCount];
+        RateKeys()
+        {
+            for (int c = 0; c < NetworkTable::CounterCount; ++c)
+                keys[c] = QByteArray(SnapshotFormat::networkCounterName(c)) + "PerSecond";
+        }
+    } rateKeys;
+
+    w.key("network").beginArray();
+    for (int i = 0; i < net.size(); ++i) {
+        w.beginObject();
+        w.key("name").string(net.name[i]);
+        w.key("ifIndex").integer(net.ifIndex[i]);
+        for (int c = 0; c < NetworkTable::CounterCount; ++c) w.key(SnapshotFormat::networkCounterName(c)).unsignedInteger(net.total[c][i]);
+        for (int c = 0; c < NetworkTable::CounterCount; ++c) w.key(rateKeys.keys[c].constData()).number(net.rate[c][i]);
+        w.endObject();
+    }
+    w.endArray();
+}
+
+void renderProcesses(Writer &w, const ProcessTable &p)
+{
+    w.key("processes").beginObject();
+    w.key("total").integer(p.total);
+    w.key("top").beginArray();
+    for (int i = 0; i < p.size(); ++i) {
+        w.beginObject();
+        w.key("pid").integer(p.pid[i]);
+        w.key("name").string(p.name[i]);
+        w.key("cpu").number(p.cpuPercent[i]);
+        w.key("rssBytes").unsignedInteger(p.rssBytes[i]);
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+}
+
+} // namespace
+
+const char *fieldName(quint32 field)
+{
+    switch (field) {
+    case System: return "system";
+    case Uptime: return "uptime";
+    case Cpu: return "cpu";
+    case Memory: return "memory";
+    case Pressure: return "pressure";
+    case Volumes: return "volumes";
+    case DiskIo: return "diskIo";
+    case Network: return "network";
+    case Processes: return "processes";
+    default: return "";
+    }
+}
+
+bool parseFields(const QString &list, quint32 *fields, QString *error)
+{
+    quint32 parsed = 0;
+    for (const QString &part : list.split(',')) {
+        const QString name = part.trimmed();
+        if (name.isEmpty()) continue;
+        quint32 field = 1;
+        while ((field & AllFields) && name.compare(QLatin1String(fieldName(field)), Qt::CaseInsensitive) != 0) field <<= 1;
+        if (!(field & AllFields)) {
+            if (error) *error = QString("unknown field '%1'").arg(name);
+            return false;
+        }
+        parsed |= field;
+    }
+    *fields = parsed;
+    return true;
+}
+
+quint32 metricsFor(quint32 fields)
+{
+    static const struct {
+        Field field;
+        SystemBackend::Metric metric;
+    } collectors[] = {
+        { Uptime, SystemBackend::UptimeMetric },
+        { Cpu, SystemBackend::CpuMetric },
+        { Memory, SystemBackend::MemoryMetric },
+        { Pressure, SystemBackend::PressureMetric },
+        { Volumes, SystemBackend::DiskMetric },
+        { DiskIo, SystemBackend::DiskIoMetric },
+        { Network, SystemBackend::NetworkMetric },
+        { Processes, SystemBackend::ProcessMetric },
+    };
+    quint32 metrics = 0;
+    for (const auto &c : collectors)
+        if (fields & c.field) metrics |= 1u << c.metric;
+    return metrics;
+}
+
+void render(const SystemSnapshot &s, quint32 fields, QByteArray &out)
+{
+    // resize(0) keeps a reserved buffer; reserve() only allocates the first
+    // time round.
+    if (out.capacity() < kInitialCapacity) out.reserve(kInitialCapacity);
+    out.resize(0);
+    Writer w(out);
+    w.beginObject();
+    w.key("timestamp").integer(s.timestampMs);
+    if (fields & System) renderSystem(w, *s.inventory);
+    if (fields & Uptime) w.key("uptime").unsignedInteger(s.uptimeSeconds);
+    if (fields & Cpu) renderCpu(w, s.cpu, s.cpuPercent);
+    if (fields & Memory) renderMemory(w, s);
+    if (fields & Pressure) renderPressure(w, s.pressure);
+    if (fields & Volumes) renderVolumes(w, s.volumes);
+    if (fields & DiskIo) renderDiskIo(w, s.diskIo);
+    if (fields & Network) renderNetwork(w, s.network);
+    if (fields & Processes) renderProcesses(w, s.processes);
+    w.endObject();
+    out.append('\n');
+}
+
+} // namespace SnapshotJson
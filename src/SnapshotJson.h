@@ -0,0 +1,63 @@
+#ifndef SNAPSHOTJSON_H
+#define SNAPSHOTJSON_H
+
+#include <QByteArray>
+#include <QString>
+#include "SystemSnapshot.h"
+
+// Renders a snapshot as one line of JSON, for neofetch-cli --json and
+// --watch (newline-delimited JSON, one line per sample):
+//
+//   {"timestamp": ms since the epoch,
+//    "system": {host, user, os, kernel, cpu, gpu, display, shell, and
+//               diskDevices / memoryModules when they were collected},
+//    "uptime": seconds,
+//    "cpu": {percent, user, ..., steal, busy, cores: [{id, user, ..., busy}]},
+//    "memory": {total, used, percent, available, cached, ..., hugepages_free},
+//    "pressure": {available, cpu: {some: [avg10, avg60, avg300], full: [...]}, memory, io},
+//    "volumes": [{mountPoint, fstype, device, totalBytes, freeBytes, percent}],
+//    "diskIo": [{name, readBytesPerSecond, writeBytesPerSecond, readsPerSecond,
+//                writesPerSecond, latencyMs, utilization}],
+//    "network": [{name, ifIndex, rxBytes, ..., rxBytesPerSecond, ...}],
+//    "processes": {total, top: [{pid, name, cpu, rssBytes}]}}
+//
+// Keys follow the provider's QVariant properties where they overlap. Only
+// the requested fields are written; sizes are in bytes, shares in percent,
+// rates per second.
+//
+// The text is written straight from the snapshot into out, without a
+// QJsonDocument in between; render() overwrites out in place, so once out
+// has grown to the size of a typical line, rendering does not allocate.
+namespace SnapshotJson {
+
+// Top-level keys, in the order they are written.
+enum Field : quint32 {
+    System    = 1u << 0,
+    Uptime    = 1u << 1,
+    Cpu       = 1u << 2,
+    Memory    = 1u << 3,
+    Pressure  = 1u << 4,
+    Volumes   = 1u << 5,
+    DiskIo    = 1u << 6,
+    Network   = 1u << 7,
+    Processes = 1u << 8,
+    AllFields = (1u << 9) - 1
+};
+
+// The JSON key of a single Field bit.
+const char *fieldName(quint32 field);
+
+// Parses a comma-separated list of keys, e.g. "cpu,memory,network", into
+// fields. On an unknown key returns false with the reason in error.
+bool parseFields(const QString &list, quint32 *fields, QString *error = nullptr);
+
+// The SystemBackend::Metric collectors (as bits) that fill fields; the
+// others need not run.
+quint32 metricsFor(quint32 fields);
+
+// One JSON object followed by '\n'; "timestamp" is always included.
+void render(const SystemSnapshot &s, quint32 fields, QByteArray &out);
+
+} // namespace SnapshotJson
+
+#endif
@@ -0,0 +1,543 @@
+#include "SnapshotTrace.h"
+#include "InventoryCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char kMagic[8] = { 'N', 'F', 'T', 'R', 'A', 'C', 'E', 0 };
+// Bump whenever the record layout in transferMetrics() or
+// transferInventory() changes.
+const quint32 kVersion = 2;
+const char kBlockMagic[4] = { 'N', 'F', 'B', 'K' };
+const char kIndexMagic[4] = { 'N', 'F', 'I', 'X' };
+
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 reserved;
+};
+
+struct BlockHeader {
+    char magic[4];
+    quint32 records;
+    quint32 size;     // of the compressed payload that follows
+    quint32 reserved;
+    qint64 firstMs;
+    qint64 lastMs;
+    quint64 checksum; // of the compressed payload
+};
+
+struct IndexEntry {
+    qint64 firstMs;
+    qint64 lastMs;
+    quint64 offset;
+    quint32 records;
+    quint32 reserved;
+};
+
+// Last bytes of a closed trace, after the index entries.
+struct IndexTrailer {
+    quint64 offset; // of the first index entry
+    quint32 count;
+    char magic[4];
+};
+
+// Fractional values are stored as integers in hundredths.
+const double kFixedScale = 100.0;
+
+// Writes one record as varint deltas against state.
+class Encoder
+{
+public:
+    Encoder(QByteArray &out, TraceDeltaState &state) : m_out(out), m_state(state), m_number(0), m_string(0) {}
+
+    template <typename T>
+    void integer(const T &value) { put(quint64(value)); }
+    template <typename T>
+    void fixed(const T &value) { put(quint64(qint64(std::llround(double(value) * kFixedScale)))); }
+
+    void text(const QString &value)
+    {
+        if (m_string == m_state.strings.size()) m_state.strings.append(QString());
+        QString &prev = m_state.strings[m_string++];
+        // The same string as last record costs one byte; a keyframe starts
+        // from null strings, so even empty ones are written there.
+        if (!prev.isNull() && prev == value) {
+            varint(0);
+            return;
+        }
+        prev = value.isNull() ? QString("") : value;
+        const QByteArray utf8 = value.toUtf8();
+        varint(quint64(utf8.size()) + 1);
+        m_out.append(utf8);
+    }
+
+    // Writes the row count of a table and returns it.
+    template <typename Table>
+    int rows(const Table &table)
+    {
+        put(quint64(table.size()));
+        return table.size();
+    }
+
+private:
+    void varint(quint64 v)
+    {
+        while (v >= 0x80) {
+            m_out.append(char(v | 0x80));
+            v >>= 7;
+        }
+        m_out.append(char(v));
+    }
+
+    void put(quint64 value)
+    {
+        if (m_number == m_state.numbers.size()) m_state.numbers.push_back(0);
+        quint64 &prev = m_state.numbers[m_number++];
+        const qint64 delta = qint64(value - prev);
+        prev = value;
+        varint((quint64(delta) << 1) ^ quint64(delta >> 63));
+    }
+
+    QByteArray &m_out;
+    TraceDeltaState &m_state;
+    size_t m_number;
+    int m_string;
+};
+
+// Reads one record written by Encoder. Running past the payload, or a count
+// larger than the payload could hold, marks the record as failed.
+class Decoder
+{
+public:
+    Decoder(const QByteArray &in, int &cursor, TraceDeltaState &state)
+        : m_in(in), m_cursor(cursor), m_state(state), m_number(0), m_string(0), m_failed(false) {}
+
+    bool failed() const { return m_failed; }
+
+    template <typename T>
+    void integer(T &value) { value = T(get()); }
+    template <typename T>
+    void fixed(T &value) { value = T(qint64(get()) / kFixedScale); }
+
+    void text(QString &value)
+    {
+        if (m_string == m_state.strings.size()) m_state.strings.append(QString());
+        QString &prev = m_state.strings[m_string++];
+        const quint64 size = varint();
+        if (size > 0) {
+            if (size - 1 > quint64(m_in.size() - m_cursor)) {
+                m_failed = true;
+                return;
+            }
+            prev = QString::fromUtf8(m_in.constData() + m_cursor, int(size - 1));
+            m_cursor += int(size - 1);
+        }
+        value = prev;
+    }
+
+    template <typename Table>
+    int rows(Table &table)
+    {
+        quint64 n = get();
+        if (n > quint64(m_in.size() - m_cursor)) {
+            m_failed = true;
+            n = 0;
+        }
+        table.resize(int(n));
+        return int(n);
+    }
+
+private:
+    quint64 varint()
+    {
+        quint64 v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_cursor >= m_in.size()) break;
+            const uchar byte = uchar(m_in[m_cursor++]);
+            v |= quint64(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    quint64 get()
+    {
+        if (m_number == m_state.numbers.size()) m_state.numbers.push_back(0);
+        quint64 &prev = m_state.numbers[m_number++];
+        const quint64 zigzag = varint();
+        prev += quint64(qint64(zigzag >> 1) ^ -qint64(zigzag & 1));
+        return prev;
+    }
+
+    const QByteArray &m_in;
+    int &m_cursor;
+    TraceDeltaState &m_state;
+    size_t m_number;
+    int m_string;
+    bool m_failed;
+};
+
+// The record layout, shared by both directions: Snapshot is const when
+// encoding. Stable fields come first so that a table changing size shifts
+// as few delta positions as possible.
+template <typename Codec, typename Snapshot>
+void transferMetrics(Codec &c, Snapshot &s)
+{
+    c.integer(s.timestampMs);
+    c.integer(s.uptimeSeconds);
+    c.integer(s.cpuPercent);
+    c.integer(s.memoryPercent);
+    c.integer(s.memoryTotal);
+    c.integer(s.memoryUsed);
+    for (auto &bytes : s.memoryDetail.bytes) c.integer(bytes);
+    c.integer(s.pressure.available);
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        for (int w = 0; w < PressureStats::WindowCount; ++w) {
+            c.fixed(s.pressure.some[r][w]);
+            c.fixed(s.pressure.full[r][w]);
+        }
+    }
+    c.integer(s.sampleMicros);
+    c.integer(s.inventoryMicros);
+    c.integer(s.intervalStretch);
+    c.fixed(s.wakeupsPerSecond);
+    c.integer(s.sampledMetrics);
+
+    auto &cpu = s.cpu;
+    for (auto &total : cpu.total) c.fixed(total);
+    for (int i = 0, n = c.rows(cpu); i < n; ++i) {
+        c.integer(cpu.cpuId[i]);
+        for (auto &column : cpu.share) c.fixed(column[i]);
+    }
+
+    auto &volumes = s.volumes;
+    for (int i = 0, n = c.rows(volumes); i < n; ++i) {
+        c.text(volumes.mountPoint[i]);
+        c.text(volumes.fsType[i]);
+        c.text(volumes.device[i]);
+        c.integer(volumes.totalBytes[i]);
+        c.integer(volumes.freeBytes[i]);
+    }
+
+    auto &io = s.diskIo;
+    for (int i = 0, n = c.rows(io); i < n; ++i) {
+        c.text(io.name[i]);
+        for (auto &column : io.rate) c.fixed(column[i]);
+        c.fixed(io.latencyMs[i]);
+        c.fixed(io.utilization[i]);
+    }
+
+    auto &net = s.network;
+    for (int i = 0, n = c.rows(net); i < n; ++i) {
+        c.integer(net.ifIndex[i]);
+        c.text(net.name[i]);
+        for (auto &column : net.total) c.integer(column[i]);
+        for (auto &column : net.rate) c.fixed(column[i]);
+    }
+
+    auto &processes = s.processes;
+    c.integer(processes.total);
+    for (int i = 0, n = c.rows(processes); i < n; ++i) {
+        c.integer(processes.pid[i]);
+        c.text(processes.name[i]);
+        c.fixed(processes.cpuPercent[i]);
+        c.integer(processes.rssBytes[i]);
+    }
+
+    for (auto *events : { &s.alerts.firing, &s.alerts.recent }) {
+        for (int i = 0, n = c.rows(*events); i < n; ++i) {
+            auto &e = (*events)[i];
+            c.text(e.rule);
+            c.text(e.subject);
+            c.fixed(e.value);
+            c.integer(e.timestampMs);
+            c.integer(e.firing);
+        }
+    }
+}
+
+template <typename Codec, typename Inventory>
+void transferInventory(Codec &c, Inventory &inv)
+{
+    for (auto *text : { &inv.cpuInfo, &inv.gpuInfo, &inv.displayInfo, &inv.osInfo, &inv.kernelInfo, &inv.shellInfo,
+                        &inv.username, &inv.currentDir, &inv.networkInfo, &inv.diskDevicesNote, &inv.memoryModulesNote })
+        c.text(*text);
+    for (int i = 0, n = c.rows(inv.diskDevices); i < n; ++i) {
+        auto &d = inv.diskDevices[i];
+        c.text(d.model);
+        c.integer(d.sizeBytes);
+        c.text(d.interfaceType);
+        c.text(d.serial);
+    }
+    for (int i = 0, n = c.rows(inv.memoryModules); i < n; ++i) {
+        auto &m = inv.memoryModules[i];
+        c.text(m.manufacturer);
+        c.integer(m.capacityBytes);
+        c.integer(m.speedMHz);
+        c.text(m.partNumber);
+    }
+    c.integer(inv.complete);
+    c.integer(inv.cached);
+}
+
+void encode(QByteArray &out, TraceDeltaState &state, const SystemSnapshot &s)
+{
+    Encoder e(out, state);
+    transferMetrics(e, s);
+    // Keyframes start without an inventory, so they always carry one.
+    const bool inventory = s.inventory != state.inventory;
+    e.integer(inventory);
+    if (inventory) {
+        transferInventory(e, *s.inventory);
+        state.inventory = s.inventory;
+    }
+}
+
+SystemSnapshotPtr decode(const QByteArray &in, int &cursor, TraceDeltaState &state)
+{
+    Decoder d(in, cursor, state);
+    auto s = std::make_shared<SystemSnapshot>();
+    transferMetrics(d, *s);
+    bool inventory = false;
+    d.integer(inventory);
+    if (inventory) {
+        auto inv = std::make_shared<SystemInventory>();
+        transferInventory(d, *inv);
+        state.inventory = inv;
+    }
+    if (d.failed() || !state.inventory) return nullptr;
+    s->inventory = state.inventory;
+    return s;
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(qint64 minIntervalMs, qint64 flushIntervalMs)
+    : m_minIntervalMs(minIntervalMs), m_flushIntervalMs(flushIntervalMs), m_blockRecords(0), m_blockFirstMs(0),
+      m_lastMs(0), m_records(0), m_bytesWritten(0)
+{
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+bool TraceWriter::open(const QString &path, QString *error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+    m_block.resize(0);
+    m_blockRecords = 0;
+    m_records = 0;
+    m_bytesWritten = 0;
+    m_index.clear();
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    if (!write(reinterpret_cast<const char *>(&header), sizeof(header))) {
+        if (error) *error = QString("cannot write %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+bool TraceWriter::append(const SystemSnapshot &s)
+{
+    if (!m_file.isOpen()) return false;
+    // Nothing sampled yet, or too soon after the last record. Ticks run a
+    // little early or late, so an eighth of the interval is let through; a
+    // clock that stepped backwards is recorded rather than throttled.
+    if (s.timestampMs == 0) return true;
+    if (m_records && s.timestampMs >= m_lastMs && s.timestampMs - m_lastMs < m_minIntervalMs - m_minIntervalMs / 8)
+        return true;
+
+    if (m_blockRecords == 0) {
+        m_state.reset();
+        m_block.resize(0);
+        m_blockFirstMs = s.timestampMs;
+    }
+    encode(m_block, m_state, s);
+    ++m_blockRecords;
+    ++m_records;
+    m_lastMs = s.timestampMs;
+    if (m_blockRecords >= kBlockRecords || s.timestampMs - m_blockFirstMs >= m_flushIntervalMs) return writeBlock();
+    return true;
+}
+
+bool TraceWriter::writeBlock()
+{
+    if (m_blockRecords == 0) return true;
+    const QByteArray payload = qCompress(m_block);
+    BlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kBlockMagic, sizeof(kBlockMagic));
+    header.records = quint32(m_blockRecords);
+    header.size = quint32(payload.size());
+    header.firstMs = m_blockFirstMs;
+    header.lastMs = m_lastMs;
+    header.checksum = InventoryCache::hash(payload.constData(), size_t(payload.size()));
+    const quint64 offset = quint64(m_file.pos());
+    m_blockRecords = 0;
+
+    if (!write(reinterpret_cast<const char *>(&header), sizeof(header)) || !write(payload.constData(), payload.size()))
+        return false;
+    // Hand the block to the OS now, so it survives the process.
+    m_file.flush();
+    m_index.push_back({ header.firstMs, header.lastMs, offset, header.records });
+    return true;
+}
+
+bool TraceWriter::write(const char *data, qint64 size)
+{
+    if (m_file.write(data, size) != size) {
+        m_file.close();
+        return false;
+    }
+    m_bytesWritten += quint64(size);
+    return true;
+}
+
+void TraceWriter::close()
+{
+    if (!m_file.isOpen()) return;
+    if (writeBlock()) {
+        IndexTrailer trailer;
+        trailer.offset = quint64(m_file.pos());
+        trailer.count = quint32(m_index.size());
+        std::memcpy(trailer.magic, kIndexMagic, sizeof(kIndexMagic));
+        for (const TraceBlock &b : m_index) {
+            const IndexEntry entry = { b.firstMs, b.lastMs, b.offset, b.records, 0 };
+            if (!write(reinterpret_cast<const char *>(&entry), sizeof(entry))) return;
+        }
+        if (!write(reinterpret_cast<const char *>(&trailer), sizeof(trailer))) return;
+    }
+    m_file.close();
+}
+
+TraceReader::TraceReader()
+    : m_block(-1), m_cursor(0), m_remaining(0)
+{
+}
+
+bool TraceReader::open(const QString &path, QString *error)
+{
+    m_file.close();
+    m_blocks.clear();
+    m_block = -1;
+    m_remaining = 0;
+    m_pending.reset();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+    FileHeader header;
+    if (m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))
+        || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        if (error) *error = QString("%1 is not a trace this version can read").arg(path);
+        m_file.close();
+        return false;
+    }
+
+    // A closed trace ends in an index; one cut short does not, and its
+    // blocks are found by walking their headers.
+    const qint64 size = m_file.size();
+    IndexTrailer trailer;
+    if (size >= qint64(sizeof(FileHeader) + sizeof(trailer)) && m_file.seek(size - qint64(sizeof(trailer)))
+        && m_file.read(reinterpret_cast<char *>(&trailer), sizeof(trailer)) == qint64(sizeof(trailer))
+        && std::memcmp(trailer.magic, kIndexMagic, sizeof(kIndexMagic)) == 0
+        && trailer.offset >= sizeof(FileHeader)
+        && trailer.offset + quint64(trailer.count) * sizeof(IndexEntry) + sizeof(trailer) == quint64(size)
+        && m_file.seek(qint64(trailer.offset))) {
+        m_blocks.reserve(trailer.count);
+        for (quint32 i = 0; i < trailer.count; ++i) {
+            IndexEntry entry;
+            if (m_file.read(reinterpret_cast<char *>(&entry), sizeof(entry)) != qint64(sizeof(entry))) break;
+            m_blocks.push_back({ entry.firstMs, entry.lastMs, entry.offset, entry.records });
+        }
+        return true;
+    }
+
+    qint64 offset = sizeof(FileHeader);
+    BlockHeader block;
+    while (m_file.seek(offset) && m_file.read(reinterpret_cast<char *>(&block), sizeof(block)) == qint64(sizeof(block))
+           && std::memcmp(block.magic, kBlockMagic, sizeof(kBlockMagic)) == 0
+           && offset + qint64(sizeof(block)) + qint64(block.size) <= size) {
+        m_blocks.push_back({ block.firstMs, block.lastMs, quint64(offset), block.records });
+        offset += qint64(sizeof(block)) + qint64(block.size);
+    }
+    return true;
+}
+
+quint64 TraceReader::records() const
+{
+    quint64 n = 0;
+    for (const TraceBlock &b : m_blocks) n += b.records;
+    return n;
+}
+
+bool TraceReader::loadBlock(int index)
+{
+    m_block = index;
+    m_remaining = 0;
+    const TraceBlock &b = m_blocks[size_t(index)];
+    BlockHeader header;
+    if (!m_file.seek(qint64(b.offset))
+        || m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))
+        || std::memcmp(header.magic, kBlockMagic, sizeof(kBlockMagic)) != 0)
+        return false;
+    const QByteArray payload = m_file.read(qint64(header.size));
+    if (payload.size() != int(header.size) || InventoryCache::hash(payload.constData(), size_t(payload.size())) != header.checksum)
+        return false;
+    m_payload = qUncompress(payload);
+    if (m_payload.isEmpty()) return false;
+    m_cursor = 0;
+    m_remaining = header.records;
+    m_state.reset();
+    return true;
+}
+
+void TraceReader::seek(qint64 timestampMs)
+{
+    m_pending.reset();
+    const auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [timestampMs](const TraceBlock &b) { return b.lastMs >= timestampMs; });
+    m_block = int(it - m_blocks.begin()) - 1;
+    m_remaining = 0;
+    while (SystemSnapshotPtr s = next()) {
+        if (s->timestampMs >= timestampMs) {
+            m_pending = s;
+            return;
+        }
+    }
+}
+
+SystemSnapshotPtr TraceReader::next()
+{
+    if (m_pending) return std::move(m_pending);
+    while (m_remaining == 0) {
+        if (m_block + 1 >= int(m_blocks.size())) return nullptr;
+        if (!loadBlock(m_block + 1)) {
+            m_block = int(m_blocks.size());
+            return nullptr;
+        }
+    }
+    --m_remaining;
+    SystemSnapshotPtr s = decode(m_payload, m_cursor, m_state);
+    if (!s) {
+        m_block = int(m_blocks.size());
+        m_remaining = 0;
+    }
+    return s;
+}
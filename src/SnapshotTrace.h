@@ -0,0 +1,135 @@
+#ifndef SNAPSHOTTRACE_H
+#define SNAPSHOTTRACE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <vector>
+#include "SystemSnapshot.h"
+
+// A recording of published snapshots, for looking at what happened while
+// nobody was watching.
+//
+// The file is a fixed header followed by blocks and, once the recording is
+// closed, an index of the blocks. Each block holds a run of records and
+// starts with a keyframe; every later record stores each number as the
+// zigzag varint of its difference from the same field of the record before,
+// and each string as a single byte when it has not changed, so a steady
+// system costs a few bytes per field. Fractional values are kept to two
+// decimals. The inventory is only written when it changes. Blocks are
+// zlib-compressed and checksummed. A recording cut short by a crash loses
+// at most its last, unwritten block: without an index the reader finds the
+// blocks by scanning their headers.
+//
+// Records are the numbers and strings the views show: the metric tables,
+// alerts and inventory. Collector health is not recorded.
+
+// Shared delta state of a block being written or read: the previous value
+// of every numeric and string field, by position in the record.
+struct TraceDeltaState
+{
+    std::vector<quint64> numbers;
+    QVector<QString> strings;
+    SystemInventoryPtr inventory;
+
+    void reset()
+    {
+        numbers.clear();
+        strings.clear();
+        inventory.reset();
+    }
+};
+
+// Where a block of records sits in the file and what it covers.
+struct TraceBlock
+{
+    qint64 firstMs;
+    qint64 lastMs;
+    quint64 offset;
+    quint32 records;
+};
+
+// Appends snapshots to a trace file. Writing is bounded: a snapshot that
+// comes less than minIntervalMs after the last recorded one is skipped, and
+// the file is only written once per block, when it holds kBlockRecords
+// records or spans flushIntervalMs.
+class TraceWriter
+{
+public:
+    static const int kBlockRecords = 600;
+
+    explicit TraceWriter(qint64 minIntervalMs = 1000, qint64 flushIntervalMs = 60000);
+    ~TraceWriter();
+
+    // Creates or truncates the file at path.
+    bool open(const QString &path, QString *error = nullptr);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Records s, unless throttled. Returns false, and closes the file, if
+    // it cannot be written.
+    bool append(const SystemSnapshot &s);
+
+    // Writes the pending block and the index.
+    void close();
+
+    quint64 records() const { return m_records; }
+    quint64 bytesWritten() const { return m_bytesWritten; }
+
+private:
+    Q_DISABLE_COPY(TraceWriter)
+
+    bool writeBlock();
+    bool write(const char *data, qint64 size);
+
+    qint64 m_minIntervalMs;
+    qint64 m_flushIntervalMs;
+    QFile m_file;
+    QByteArray m_block;       // records of the block being filled, uncompressed
+    TraceDeltaState m_state;
+    int m_blockRecords;
+    qint64 m_blockFirstMs;
+    qint64 m_lastMs;          // timestamp of the last recorded snapshot
+    quint64 m_records;
+    quint64 m_bytesWritten;
+    std::vector<TraceBlock> m_index;
+};
+
+// Reads a trace back in order, one snapshot per record.
+class TraceReader
+{
+public:
+    TraceReader();
+
+    bool open(const QString &path, QString *error = nullptr);
+
+    // Range and size of the recording, from the block index.
+    qint64 startMs() const { return m_blocks.empty() ? 0 : m_blocks.front().firstMs; }
+    qint64 endMs() const { return m_blocks.empty() ? 0 : m_blocks.back().lastMs; }
+    quint64 records() const;
+    int blockCount() const { return int(m_blocks.size()); }
+
+    // Moves to the first record at or after timestampMs, reading only the
+    // block that holds it.
+    void seek(qint64 timestampMs);
+
+    // The next record, or nullptr at the end. A damaged block ends the
+    // recording there.
+    SystemSnapshotPtr next();
+
+private:
+    Q_DISABLE_COPY(TraceReader)
+
+    bool loadBlock(int block);
+
+    QFile m_file;
+    std::vector<TraceBlock> m_blocks;
+    int m_block;           // index of the loaded block, or -1
+    QByteArray m_payload;  // its records, uncompressed
+    int m_cursor;          // read position in m_payload
+    quint32 m_remaining;   // records left in it
+    TraceDeltaState m_state;
+    SystemSnapshotPtr m_pending; // decoded by seek(), returned by the next next()
+};
+
+#endif
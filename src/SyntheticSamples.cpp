@@ -0,0 +1,153 @@
+#include "SyntheticSamples.h"
+#include "AlertEngine.h"
+#include "SystemBackend.h"
+#include <algorithm>
+#include <cmath>
+
+SyntheticSamples::SyntheticSamples()
+    : m_seed(12345), m_tick(0)
+{
+    auto inv = std::make_shared<SystemInventory>();
+    inv->cpuInfo = "Synthetic CPU @ 3.00GHz (8 cores)";
+    inv->gpuInfo = "Synthetic GPU";
+    inv->displayInfo = "2560x1440 @ 144Hz";
+    inv->osInfo = "Synthetic OS 1.0";
+    inv->kernelInfo = "6.1.0";
+    inv->shellInfo = "bash 5.2";
+    inv->username = "bench";
+    inv->currentDir = "/home/bench";
+    inv->networkInfo = "eth0: 192.168.1.10";
+    inv->diskDevices.append({ "Synthetic NVMe", 1000204886016ULL, "NVMe", "SN0001" });
+    inv->memoryModules.append({ "Synthetic", 17179869184ULL, 3200, "PN-16G" });
+    inv->complete = true;
+    m_s.inventory = inv;
+
+    m_s.cpu.resize(8);
+    for (int i = 0; i < m_s.cpu.size(); ++i) m_s.cpu.cpuId[i] = i;
+    m_s.memoryTotal = 17179869184ULL;
+    m_s.memoryUsed = m_s.memoryTotal / 2;
+    m_s.pressure.available = true;
+    const char *mounts[] = { "/", "/home", "/boot" };
+    m_s.volumes.resize(3);
+    for (int i = 0; i < 3; ++i) {
+        m_s.volumes.mountPoint[i] = mounts[i];
+        m_s.volumes.fsType[i] = "ext4";
+        m_s.volumes.device[i] = QString("nvme0n1p%1").arg(i + 1);
+        m_s.volumes.totalBytes[i] = 500000000000ULL >> i;
+        m_s.volumes.freeBytes[i] = m_s.volumes.totalBytes[i] / 3;
+    }
+    m_s.diskIo.resize(2);
+    m_s.diskIo.name[0] = "nvme0n1";
+    m_s.diskIo.name[1] = "sda";
+    const char *interfaces[] = { "lo", "eth0", "wlan0" };
+    m_s.network.resize(3);
+    for (int i = 0; i < 3; ++i) {
+        m_s.network.ifIndex[i] = i + 1;
+        m_s.network.name[i] = interfaces[i];
+    }
+    for (int i = 0; i < kProcesses; ++i) m_processCpu[i] = 0;
+}
+
+SystemSnapshotPtr SyntheticSamples::next()
+{
+    SystemSnapshot &s = m_s;
+    s.timestampMs = 1700000000000LL + qint64(m_tick) * 1000 + random(20);
+    s.uptimeSeconds = 86400 + quint64(m_tick);
+    s.sampledMetrics = SystemBackend::AllMetrics;
+    if (m_tick && m_tick % 3600 == 0) {
+        auto inv = std::make_shared<SystemInventory>(*s.inventory);
+        inv->networkInfo = QString("eth0: 192.168.1.%1").arg(10 + m_tick / 3600);
+        s.inventory = inv;
+    }
+
+    for (float &total : s.cpu.total) total = 0;
+    for (int i = 0; i < s.cpu.size(); ++i) {
+        float &user = s.cpu.share[CpuTable::User][i];
+        float &system = s.cpu.share[CpuTable::System][i];
+        float &iowait = s.cpu.share[CpuTable::IoWait][i];
+        user = float(walk(user, 5, 0, 70));
+        system = float(walk(system, 2, 0, 20));
+        iowait = float(walk(iowait, 1, 0, 5));
+        s.cpu.share[CpuTable::Idle][i] = float(hundredths(100 - double(user) - system - iowait));
+        for (int state = 0; state < CpuTable::StateCount; ++state) s.cpu.total[state] += s.cpu.share[state][i];
+    }
+    for (float &total : s.cpu.total) total = float(hundredths(total / s.cpu.size()));
+    s.cpuPercent = int(s.cpu.totalBusy());
+
+    s.memoryUsed = qBound(s.memoryTotal / 4, s.memoryUsed + random(8 << 20) - (4 << 20), s.memoryTotal) & ~quint64(4095);
+    s.memoryPercent = int(s.memoryUsed * 100 / s.memoryTotal);
+    s.memoryDetail.bytes[MemoryBreakdown::Available] = s.memoryTotal - s.memoryUsed;
+    s.memoryDetail.bytes[MemoryBreakdown::Cached] = (s.memoryTotal - s.memoryUsed) / 2;
+    s.memoryDetail.bytes[MemoryBreakdown::SwapTotal] = 4294967296ULL;
+    s.memoryDetail.bytes[MemoryBreakdown::Dirty] = random(64) << 12;
+    for (int r = 0; r < PressureStats::ResourceCount; ++r) {
+        for (int w = 0; w < PressureStats::WindowCount; ++w) {
+            s.pressure.some[r][w] = float(walk(s.pressure.some[r][w], 0.5, 0, 30));
+            s.pressure.full[r][w] = float(hundredths(s.pressure.some[r][w] / 2));
+        }
+    }
+
+    for (int i = 0; i < s.volumes.size(); ++i)
+        if (random(10) == 0) s.volumes.freeBytes[i] -= random(1 << 20);
+    for (int i = 0; i < s.diskIo.size(); ++i) {
+        for (QVector<float> &column : s.diskIo.rate) column[i] = float(walk(column[i], 100, 0, 5000));
+        s.diskIo.latencyMs[i] = float(walk(s.diskIo.latencyMs[i], 0.2, 0, 20));
+        s.diskIo.utilization[i] = float(walk(s.diskIo.utilization[i], 2, 0, 100));
+    }
+    for (int i = 0; i < s.network.size(); ++i) {
+        for (int c = 0; c < NetworkTable::CounterCount; ++c) {
+            const bool error = c >= NetworkTable::RxErrors;
+            float &rate = s.network.rate[c][i];
+            rate = error ? float(random(50) == 0) : float(walk(rate, 20000, 0, 1000000));
+            s.network.total[c][i] += quint64(rate);
+        }
+    }
+
+    // The ten busiest of forty processes.
+    for (double &cpu : m_processCpu) cpu = walk(cpu, 3, 0, 100);
+    int order[kProcesses];
+    for (int i = 0; i < kProcesses; ++i) order[i] = i;
+    std::stable_sort(order, order + kProcesses, [this](int a, int b) { return m_processCpu[a] > m_processCpu[b]; });
+    s.processes.total = 300 + int(random(20));
+    s.processes.resize(10);
+    for (int i = 0; i < s.processes.size(); ++i) {
+        const int p = order[i];
+        s.processes.pid[i] = 1000 + p;
+        s.processes.name[i] = QString("process-%1").arg(p);
+        s.processes.cpuPercent[i] = float(m_processCpu[p]);
+        s.processes.rssBytes[i] = quint64(p + 1) << 22;
+    }
+
+    if (m_tick % 600 == 300 || m_tick % 600 == 420) {
+        AlertEvent e;
+        e.rule = "cpuPercent > 60 for 30s";
+        e.value = hundredths(60 + random(4000) / 100.0);
+        e.timestampMs = s.timestampMs;
+        e.firing = m_tick % 600 == 300;
+        s.alerts.firing.clear();
+        if (e.firing) s.alerts.firing.append(e);
+        if (s.alerts.recent.size() == AlertEngine::kRecentEvents) s.alerts.recent.removeFirst();
+        s.alerts.recent.append(e);
+    }
+
+    s.sampleMicros = 150 + qint64(random(100));
+    s.wakeupsPerSecond = hundredths(1 + random(100) / 100.0);
+    ++m_tick;
+    return std::make_shared<SystemSnapshot>(s);
+}
+
+double SyntheticSamples::hundredths(double value)
+{
+    return std::llround(value * 100) / 100.0;
+}
+
+quint64 SyntheticSamples::random(quint64 n)
+{
+    m_seed = m_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (m_seed >> 33) % n;
+}
+
+double SyntheticSamples::walk(double value, double step, double lo, double hi)
+{
+    return hundredths(qBound(lo, value + (random(2001) / 1000.0 - 1) * step, hi));
+}
@@ -0,0 +1,35 @@
+#ifndef SYNTHETICSAMPLES_H
+#define SYNTHETICSAMPLES_H
+
+#include "SystemSnapshot.h"
+
+// A busy machine sampled once a second, the same every run: values wander,
+// the top processes reshuffle, an alert fires and clears every ten minutes
+// and the inventory changes every hour. Fractional values are whole
+// hundredths, the precision a trace keeps. Shared by the benchmarks and the
+// trace tests.
+class SyntheticSamples
+{
+public:
+    SyntheticSamples();
+
+    // Three hours of them.
+    static const int kSamples = 3 * 3600;
+
+    SystemSnapshotPtr next();
+
+private:
+    static const int kProcesses = 40;
+
+    static double hundredths(double value);
+    quint64 random(quint64 n);
+    // value moved by up to step either way, kept within [lo, hi].
+    double walk(double value, double step, double lo, double hi);
+
+    SystemSnapshot m_s;
+    double m_processCpu[kProcesses];
+    quint64 m_seed;
+    int m_tick;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "SystemBackend.h"
+#include "Instrumentation.h"
+
+#ifdef Q_OS_WIN
+#include "WindowsBackend.h"
+#else
+#include "LinuxBackend.h"
+#endif
+
+std::unique_ptr<SystemBackend> SystemBackend::create()
+{
+#ifdef Q_OS_WIN
+    return std::unique_ptr<SystemBackend>(new WindowsBackend);
+#else
+    return std::unique_ptr<SystemBackend>(new LinuxBackend);
+#endif
+}
+
+std::unique_ptr<SystemBackend> SystemBackend::create(const QByteArray &fixtureRoot)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(fixtureRoot);
+    return nullptr;
+#else
+    return std::unique_ptr<SystemBackend>(new LinuxBackend(fixtureRoot));
+#endif
+}
+
+void SystemBackend::collectInventory(SystemInventory &s, InventoryScope scope, Instrumentation *instrumentation)
+{
+    {
+        ProbeTimer probe(instrumentation, Instrumentation::QuickInventory);
+        collectQuickInventory(s);
+    }
+    for (int step = 0; step < SlowInventoryStepCount; ++step) {
+        if (scope == QuickInventory && (step == DiskHardwareStep || step == MemoryHardwareStep)) continue;
+        ProbeTimer probe(instrumentation, Instrumentation::Probe(Instrumentation::GpuInventory + step));
+        collectSlowInventory(s, SlowInventoryStep(step));
+    }
+    s.complete = scope == FullInventory;
+}
+
+void SystemBackend::collectQuickInventory(SystemInventory &s)
+{
+    fetchCpuInfo(s);
+    fetchOsInfo(s);
+    fetchKernelInfo(s);
+    fetchShellInfo(s);
+    fetchUserInfo(s);
+}
+
+void SystemBackend::collectSlowInventory(SystemInventory &s, SlowInventoryStep step)
+{
+    switch (step) {
+    case GpuStep: fetchGpuInfo(s); break;
+    case DisplayStep: fetchDisplayInfo(s); break;
+    case NetworkStep: fetchNetworkInfo(s); break;
+    case DiskHardwareStep: fetchDiskHardwareInfo(s); break;
+    case MemoryHardwareStep: fetchMemoryHardwareInfo(s); break;
+    default: break;
+    }
+}
+
+void SystemBackend::copySlowInventory(SlowInventoryStep step, const SystemInventory &from, SystemInventory &to)
+{
+    switch (step) {
+    case GpuStep: to.gpuInfo = from.gpuInfo; break;
+    case DisplayStep: to.displayInfo = from.displayInfo; break;
+    case NetworkStep: to.networkInfo = from.networkInfo; break;
+    case DiskHardwareStep:
+        to.diskDevices = from.diskDevices;
+        to.diskDevicesNote = from.diskDevicesNote;
+        break;
+    case MemoryHardwareStep:
+        to.memoryModules = from.memoryModules;
+        to.memoryModulesNote = from.memoryModulesNote;
+        break;
+    default: break;
+    }
+}
+
+const char *SystemBackend::slowInventoryStepName(SlowInventoryStep step)
+{
+    switch (step) {
+    case GpuStep: return "GPU";
+    case DisplayStep: return "Display";
+    case NetworkStep: return "Network";
+    case DiskHardwareStep: return "Disk hardware";
+    case MemoryHardwareStep: return "Memory hardware";
+    default: return "";
+    }
+}
+
+void SystemBackend::collectMetrics(SystemSnapshot &s, Instrumentation *instrumentation, quint32 metrics)
+{
+    static void (SystemBackend::*const collectors[MetricCount])(SystemSnapshot &) = {
+        &SystemBackend::fetchUptime,
+        &SystemBackend::fetchDiskInfo,
+        &SystemBackend::fetchCpuUsage,
+        &SystemBackend::fetchMemoryUsage,
+        &SystemBackend::fetchProcesses,
+        &SystemBackend::fetchNetworkUsage,
+        &SystemBackend::fetchDiskIo,
+        &SystemBackend::fetchPressure,
+    };
+    if (!instrumentation) {
+        for (int m = 0; m < MetricCount; ++m)
+            if (metrics & (1u << m)) (this->*collectors[m])(s);
+        return;
+    }
+    // Back-to-back probes share their clock reads.
+    qint64 start = Instrumentation::now();
+    for (int m = 0; m < MetricCount; ++m) {
+        if (!(metrics & (1u << m))) continue;
+        (this->*collectors[m])(s);
+        const qint64 end = Instrumentation::now();
+        instrumentation->record(Instrumentation::Probe(Instrumentation::Uptime + m), end - start);
+        start = end;
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef SYSTEMBACKEND_H
+#define SYSTEMBACKEND_H
+
+#include <QByteArray>
+#include <memory>
+#include "SystemSnapshot.h"
+
+class Instrumentation;
+
+// Platform-specific collectors. SystemSampler calls these on its worker
+// thread; inventory collectors run once per inventory pass, metric
+// collectors run every tick and should only read counters. The slow
+// inventory collectors run concurrently on pool threads, so they must not
+// touch state shared with each other or with the metric collectors.
+class SystemBackend
+{
+public:
+    virtual ~SystemBackend() = default;
+
+    // Returns the backend for the platform we were built for.
+    static std::unique_ptr<SystemBackend> create();
+    // Same, but reading a captured /proc and /sys tree below fixtureRoot
+    // instead of the live system. Returns nullptr where the platform
+    // backend cannot do that (Windows).
+    static std::unique_ptr<SystemBackend> create(const QByteArray &fixtureRoot);
+
+    enum InventoryScope {
+        QuickInventory, // skips disk and memory module details (WMI / SMBIOS)
+        FullInventory
+    };
+
+    // Inventory collectors that may take tens to hundreds of milliseconds,
+    // in the order their results are worth showing.
+    enum SlowInventoryStep {
+        GpuStep,
+        DisplayStep,
+        NetworkStep,
+        DiskHardwareStep,
+        MemoryHardwareStep,
+        SlowInventoryStepCount
+    };
+
+    // Runs the inventory collectors in scope, timing the quick part and each
+    // slow step into instrumentation if one is given.
+    void collectInventory(SystemInventory &s, InventoryScope scope = FullInventory, Instrumentation *instrumentation = nullptr);
+    // The cheap part of the inventory: CPU model, OS, kernel, shell, user.
+    void collectQuickInventory(SystemInventory &s);
+    void collectSlowInventory(SystemInventory &s, SlowInventoryStep step);
+    // Copies the fields filled by step from one inventory to another.
+    static void copySlowInventory(SlowInventoryStep step, const SystemInventory &from, SystemInventory &to);
+    static const char *slowInventoryStepName(SlowInventoryStep step);
+
+    // Metric collectors, in the order collectMetrics() runs them (the same
+    // as the matching Instrumentation probes).
+    enum Metric {
+        UptimeMetric,
+        DiskMetric,
+        CpuMetric,
+        MemoryMetric,
+        ProcessMetric,
+        NetworkMetric,
+        DiskIoMetric,
+        PressureMetric,
+        MetricCount
+    };
+    static const quint32 AllMetrics = (1u << MetricCount) - 1;
+
+    // Runs the metric collectors whose bit is set in metrics once, timing
+    // each into instrumentation if one is given. Fields of the others are
+    // left alone.
+    void collectMetrics(SystemSnapshot &s, Instrumentation *instrumentation = nullptr, quint32 metrics = AllMetrics);
+
+    virtual void fetchCpuInfo(SystemInventory &s) = 0;
+    virtual void fetchGpuInfo(SystemInventory &s) = 0;
+    virtual void fetchDisplayInfo(SystemInventory &s) = 0;
+    virtual void fetchOsInfo(SystemInventory &s) = 0;
+    virtual void fetchKernelInfo(SystemInventory &s) = 0;
+    virtual void fetchShellInfo(SystemInventory &s) = 0;
+    virtual void fetchUserInfo(SystemInventory &s) = 0;
+    virtual void fetchDiskHardwareInfo(SystemInventory &s) = 0;
+    virtual void fetchMemoryHardwareInfo(SystemInventory &s) = 0;
+    virtual void fetchNetworkInfo(SystemInventory &s) = 0;
+
+    // Changes on every boot; keys the on-disk inventory cache.
+    virtual QByteArray bootId() = 0;
+    // Cheap hash of what hotplug changes (disks, memory size, CPUs,
+    // displays), computed without the slow probes it stands in for.
+    virtual quint64 hardwareFingerprint() = 0;
+
+    virtual void fetchUptime(SystemSnapshot &s) = 0;
+    virtual void fetchDiskInfo(SystemSnapshot &s) = 0;
+    virtual void fetchCpuUsage(SystemSnapshot &s) = 0;
+    virtual void fetchMemoryUsage(SystemSnapshot &s) = 0;
+    // Fills s.processes with the processLimit() busiest processes.
+    virtual void fetchProcesses(SystemSnapshot &s) = 0;
+    // Fills s.network with every interface but loopback.
+    virtual void fetchNetworkUsage(SystemSnapshot &s) = 0;
+    // Fills s.diskIo with every disk the OS keeps I/O counters for: on Linux
+    // each block device that has done any I/O, whole disks and dm devices
+    // included; on Windows each fixed drive. Volumes find theirs by name.
+    virtual void fetchDiskIo(SystemSnapshot &s) = 0;
+    // Fills s.pressure; leaves it unavailable where the OS has no such thing.
+    virtual void fetchPressure(SystemSnapshot &s) = 0;
+
+    // Descriptors that signal POLLPRI when the kernel sees tasks stalling
+    // on memory or I/O, so the sampler can collect memory and pressure at
+    // once instead of at the next interval. Empty where unsupported.
+    virtual QVector<int> pressureTriggers() { return QVector<int>(); }
+
+    // Rows kept in SystemSnapshot::processes.
+    int processLimit() const { return m_processLimit; }
+    void setProcessLimit(int limit) { m_processLimit = limit; }
+
+private:
+    int m_processLimit = 10;
+};
+
+#endif
@@ -1,567 +1,227 @@
 #include "SystemDataProvider.h"
-#include <Windows.h>
-#include <shlobj.h>
-#include <iphlpapi.h>
-#include <comdef.h>
-#include <Wbemidl.h>
-#include <QTimer>
-#include <QTime>
-#include <QSettings>
-#include <QStandardPaths>
-#include <QFile>
-#include <QTextStream>
+#include "SystemSampler.h"
+#include "HardwareWatcher.h"
+#include "SystemBackend.h"
+#include "InventoryCache.h"
+#include "SnapshotTrace.h"
 #include <QDateTime>
-#pragma comment(lib, "iphlpapi.lib")
-#pragma comment(lib, "wbemuuid.lib")
-#pragma comment(lib, "ole32.lib")
-#pragma comment(lib, "oleaut32.lib")
+#include <QTime>
+#include <QtAlgorithms>
 
 SystemDataProvider::SystemDataProvider(QObject *parent)
-    : QObject(parent), m_cpuPercent(0), m_memoryPercent(0), m_memoryTotal(0), m_memoryUsed(0)
+    : SystemDataProvider(Live, parent)
 {
-    m_cpuInfo = "Loading...";
-    m_gpuInfo = "Loading...";
-    m_displayInfo = "Loading...";
-    m_osInfo = "Loading...";
-    m_kernelInfo = "Loading...";
-    m_shellInfo = "Loading...";
-    m_uptime = "Loading...";
-    m_username = "user";
-    m_currentDir = "~";
-    m_time = "00:00";
-    m_memoryInfo = "Loading...";
-    m_diskHardwareInfo = "Loading...";
-    m_networkInfo = "Loading...";
-
-    QTimer::singleShot(500, this, &SystemDataProvider::fetchAllData);
 }
 
-void SystemDataProvider::fetchAllData()
-{
-    fetchCpuInfo();
-    fetchGpuInfo();
-    fetchDisplayInfo();
-    fetchOsInfo();
-    fetchShellInfo();
-    fetchUptime();
-    fetchUserInfo();
-    fetchDiskInfo();
-    fetchMemoryUsage();
-    fetchMemoryInfo();
-    fetchDiskHardwareInfo();
-    fetchMemoryHardwareInfo();
-    fetchNetworkInfo();
-    updateTime();
-
-    emit dataChanged();
-
-    m_updateTimer = new QTimer(this);
-    connect(m_updateTimer, &QTimer::timeout, this, &SystemDataProvider::updateSystemData);
-    m_updateTimer->start(5000);
-
-    m_timeTimer = new QTimer(this);
-    connect(m_timeTimer, &QTimer::timeout, this, &SystemDataProvider::updateTime);
-    m_timeTimer->start(1000);
-}
-
-void SystemDataProvider::updateSystemData()
-{
-    fetchDiskInfo();
-    fetchCpuUsage();
-    fetchMemoryUsage();
-    fetchMemoryInfo();
-    fetchDiskHardwareInfo();
-    fetchMemoryHardwareInfo();
-    fetchNetworkInfo();
-    emit dataChanged();
-}
-
-void SystemDataProvider::updateTime()
+SystemDataProvider::SystemDataProvider(Mode mode, QObject *parent)
+    : QObject(parent), m_snapshot(std::make_shared<SystemSnapshot>()), m_timeMinute(-1), m_sampler(nullptr), m_hardwareWatcher(nullptr),
+      m_viewVisible(true), m_externalConsumer(false), m_replaySpeed(1.0)
 {
+    m_time = "00:00";
+    m_replayTimer.setSingleShot(true);
+    connect(&m_replayTimer, &QTimer::timeout, this, &SystemDataProvider::replayStep);
+    if (mode == Manual) return;
     m_time = QTime::currentTime().toString("HH:mm");
-    emit timeChanged();
-}
+    m_sampler = new SystemSampler(SystemBackend::create(), &m_history);
 
-void SystemDataProvider::fetchCpuInfo()
-{
-    HKEY hKey;
-    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
-        wchar_t cpuName[256];
-        DWORD size = sizeof(cpuName);
-        DWORD type;
-        if (RegQueryValueExW(hKey, L"ProcessorNameString", nullptr, &type, (LPBYTE)cpuName, &size) == ERROR_SUCCESS) {
-            m_cpuInfo = QString::fromUtf16((const ushort*)cpuName);
-        }
-        RegCloseKey(hKey);
-    } else {
-        m_cpuInfo = "Unknown CPU";
-    }
-    emit dataChanged();
-}
+    // The sampler lives on its own thread so WMI round-trips and other slow
+    // collectors never stall the event loop; we only ever read what it has
+    // already published.
+    m_sampler->setInventoryCachePath(InventoryCache::defaultPath());
+    m_sampler->setInstrumentation(&m_instrumentation);
+    m_samplerThread.setObjectName("SystemSampler");
+    m_sampler->moveToThread(&m_samplerThread);
+    connect(&m_samplerThread, &QThread::started, m_sampler, &SystemSampler::start);
+    connect(&m_samplerThread, &QThread::finished, m_sampler, &QObject::deleteLater);
+    connect(m_sampler, &SystemSampler::snapshotPublished, this, &SystemDataProvider::onSnapshotPublished, Qt::QueuedConnection);
+    m_samplerThread.start();
 
-void SystemDataProvider::fetchGpuInfo()
-{
-    m_gpuInfo = "Generic GPU";
-    emit dataChanged();
+    m_hardwareWatcher = new HardwareWatcher(this);
+    connect(m_hardwareWatcher, &HardwareWatcher::hardwareChanged, m_sampler, &SystemSampler::invalidateInventory);
 }
 
-void SystemDataProvider::fetchDisplayInfo()
+SystemDataProvider::~SystemDataProvider()
 {
-    // Use EnumDisplayMonitors + GetMonitorInfo to reliably get monitor device name,
-    // then query EnumDisplayDevices and EnumDisplaySettings for brand/string and resolution.
-    QStringList displays;
-
-    struct Ctx { QStringList* out; } ctx{ &displays };
-
-    auto enumProc = [](HMONITOR hMon, HDC, LPRECT, LPARAM lParam) -> BOOL {
-        QStringList* out = reinterpret_cast<Ctx*>(lParam)->out;
-        MONITORINFOEXW mi;
-        ZeroMemory(&mi, sizeof(mi));
-        mi.cbSize = sizeof(mi);
-        if (!GetMonitorInfoW(hMon, &mi)) return TRUE;
-
-        // Try to get a friendly name via EnumDisplayDevices
-        DISPLAY_DEVICEW dev;
-        ZeroMemory(&dev, sizeof(dev));
-        dev.cb = sizeof(dev);
-        QString friendly;
-        if (EnumDisplayDevicesW(mi.szDevice, 0, &dev, 0)) {
-            friendly = QString::fromWCharArray(dev.DeviceString).trimmed();
-        }
-
-        DEVMODEW dm;
-        ZeroMemory(&dm, sizeof(dm));
-        dm.dmSize = sizeof(dm);
-        if (EnumDisplaySettingsW(mi.szDevice, ENUM_CURRENT_SETTINGS, &dm)) {
-            QString name = friendly.isEmpty() ? QString::fromWCharArray(mi.szDevice) : friendly;
-            QString res = QString("%1x%2").arg(dm.dmPelsWidth).arg(dm.dmPelsHeight);
-            out->append(QString("%1 - %2").arg(name).arg(res));
-        }
-        return TRUE;
-    };
-
-    EnumDisplayMonitors(nullptr, nullptr, (MONITORENUMPROC)enumProc, (LPARAM)&ctx);
-
-    if (displays.isEmpty()) m_displayInfo = "Unknown";
-    else m_displayInfo = displays.join('\n');
-    emit dataChanged();
+    if (!m_sampler) return;
+    QMetaObject::invokeMethod(m_sampler, "stop", Qt::BlockingQueuedConnection);
+    m_samplerThread.quit();
+    m_samplerThread.wait();
 }
 
-void SystemDataProvider::fetchOsInfo()
+SystemSnapshotPtr SystemDataProvider::latestPublished() const
 {
-    QSettings reg("HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion", QSettings::NativeFormat);
-    m_osInfo = reg.value("ProductName", "Windows").toString();
-    emit dataChanged();
+    return m_sampler ? m_sampler->latest() : nullptr;
 }
 
-void SystemDataProvider::fetchKernelInfo()
+void SystemDataProvider::setViewVisible(bool visible)
 {
-    m_kernelInfo = "NT 10.0";
-    emit dataChanged();
+    if (visible == m_viewVisible) return;
+    m_viewVisible = visible;
+    updateDemand();
 }
 
-void SystemDataProvider::fetchShellInfo()
+void SystemDataProvider::setExternalConsumer(bool active)
 {
-    m_shellInfo = "PowerShell";
-    emit dataChanged();
+    if (active == m_externalConsumer) return;
+    m_externalConsumer = active;
+    updateDemand();
 }
 
-void SystemDataProvider::fetchUptime()
+bool SystemDataProvider::setAlertRules(const QString &text, QString *error)
 {
-    ULONGLONG ticks = GetTickCount64();
-    qint64 days = (ticks / 60000) / 1440;
-    qint64 mins = (ticks / 60000) % 1440;
-    m_uptime = QString("Clock %1 days, %2 mins").arg(days).arg(mins);
-    emit dataChanged();
+    AlertEngine rules;
+    if (!rules.setRules(text, error)) return false;
+    if (!m_sampler) return true;
+    SystemSampler *sampler = m_sampler;
+    QMetaObject::invokeMethod(sampler, [sampler, rules]() { sampler->setAlertRules(rules); }, Qt::QueuedConnection);
+    return true;
 }
 
-void SystemDataProvider::fetchUserInfo()
+bool SystemDataProvider::startRecording(const QString &path, QString *error)
 {
-    wchar_t name[256];
-    DWORD size = sizeof(name);
-    if (GetUserNameW(name, &size)) {
-        m_username = QString::fromUtf16((const ushort*)name);
-    }
-    
-    wchar_t path[MAX_PATH];
-    if (SHGetFolderPathW(NULL, CSIDL_PROFILE, NULL, 0, path) == S_OK) {
-        m_currentDir = QString::fromUtf16((const ushort*)path);
-    } else {
-        m_currentDir = "";
+    if (!m_sampler) {
+        if (error) *error = "nothing to record without a sampler";
+        return false;
     }
-    emit dataChanged();
+    auto trace = std::make_shared<TraceWriter>();
+    if (!trace->open(path, error)) return false;
+    SystemSampler *sampler = m_sampler;
+    QMetaObject::invokeMethod(sampler, [sampler, trace]() { sampler->setTraceWriter(trace); }, Qt::QueuedConnection);
+    return true;
 }
 
-void SystemDataProvider::fetchDiskInfo()
+bool SystemDataProvider::startReplay(const QString &path, double speed, qint64 fromMs, QString *error)
 {
-    m_diskInfo.clear();
-    DWORD drives = GetLogicalDrives();
-    
-    for (int i = 0; i < 26; i++) {
-        if (drives & (1 << i)) {
-            QString drive = QString("%1:").arg(QChar('A' + i));
-            wchar_t path[4];
-            path[0] = L'A' + i;
-            path[1] = L':';
-            path[2] = L'\\';
-            path[3] = L'\0';
-            
-            DWORD sectorsPerCluster, bytesPerSector, freeClusters, totalClusters;
-            if (GetDiskFreeSpaceW(path, &sectorsPerCluster, &bytesPerSector, &freeClusters, &totalClusters)) {
-                ULONGLONG totalBytes = (ULONGLONG)totalClusters * sectorsPerCluster * bytesPerSector;
-                ULONGLONG freeBytes = (ULONGLONG)freeClusters * sectorsPerCluster * bytesPerSector;
-                
-                double totalGB = totalBytes / (1024.0 * 1024.0 * 1024.0);
-                double freeGB = freeBytes / (1024.0 * 1024.0 * 1024.0);
-                int percent = totalGB > 0 ? (int)((totalGB - freeGB) / totalGB * 100) : 0;
-                
-                QString fsType = "NTFS";
-                wchar_t fsName[256];
-                if (GetVolumeInformationW(path, nullptr, 0, nullptr, nullptr, nullptr, fsName, 256)) {
-                    fsType = QString::fromUtf16((const ushort*)fsName);
-                }
-                
-                QVariantMap d;
-                d["drive"] = drive;
-                d["total"] = QString::number(totalGB, 'f', 1);
-                d["used"] = QString::number(totalGB - freeGB, 'f', 1);
-                d["percent"] = percent;
-                d["fstype"] = fsType;
-                m_diskInfo.append(d);
-            }
-        }
+    if (m_sampler) {
+        if (error) *error = "cannot replay into a live provider";
+        return false;
     }
-    emit dataChanged();
-}
-
-void SystemDataProvider::fetchCpuUsage()
-{
-    static FILETIME idleTime, kernelTime, userTime;
-    static bool first = true;
-    FILETIME idle, kernel, user;
-    
-    if (GetSystemTimes(&idle, &kernel, &user)) {
-        if (!first) {
-            ULONGLONG idle1 = ((ULONGLONG)idleTime.dwHighDateTime << 32) | idleTime.dwLowDateTime;
-            ULONGLONG idle2 = ((ULONGLONG)idle.dwHighDateTime << 32) | idle.dwLowDateTime;
-            ULONGLONG kernel1 = ((ULONGLONG)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
-            ULONGLONG kernel2 = ((ULONGLONG)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
-            ULONGLONG user1 = ((ULONGLONG)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
-            ULONGLONG user2 = ((ULONGLONG)user.dwHighDateTime << 32) | user.dwLowDateTime;
-            
-            ULONGLONG idleDiff = idle2 - idle1;
-            ULONGLONG kernelDiff = kernel2 - kernel1;
-            ULONGLONG userDiff = user2 - user1;
-            ULONGLONG total = kernelDiff + userDiff;
-            
-            if (total > 0) {
-                m_cpuPercent = (int)(100 - (idleDiff * 100 / total));
-            }
-        }
-        first = false;
-        idleTime = idle;
-        kernelTime = kernel;
-        userTime = user;
+    auto reader = std::make_unique<TraceReader>();
+    if (!reader->open(path, error)) return false;
+    if (fromMs > 0) reader->seek(reader->startMs() + fromMs);
+    SystemSnapshotPtr first = reader->next();
+    if (!first) {
+        if (error) *error = QString("%1 holds no snapshots").arg(path);
+        return false;
     }
+    m_replayTimer.stop();
+    m_replay = std::move(reader);
+    m_replayNext = std::move(first);
+    m_replaySpeed = speed > 0 ? speed : 1.0;
+    m_replayTimer.start(0);
+    return true;
 }
 
-void SystemDataProvider::fetchMemoryUsage()
+void SystemDataProvider::replayStep()
 {
-    MEMORYSTATUSEX memInfo;
-    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    if (GlobalMemoryStatusEx(&memInfo)) {
-        m_memoryTotal = memInfo.ullTotalPhys;
-        ULONGLONG availMem = memInfo.ullAvailPhys;
-        m_memoryUsed = m_memoryTotal - availMem;
-        m_memoryPercent = (int)((m_memoryUsed * 100) / m_memoryTotal);
+    const SystemSnapshotPtr s = std::move(m_replayNext);
+    if (!s) return;
+    m_history.append(*s);
+    applySnapshot(s);
+
+    m_replayNext = m_replay->next();
+    if (!m_replayNext) {
+        m_replay.reset();
+        emit replayFinished();
+        return;
     }
+    const double gapMs = (m_replayNext->timestampMs - s->timestampMs) / m_replaySpeed;
+    m_replayTimer.start(int(qBound(0.0, gapMs, double(kMaxReplayGapMs))));
 }
 
-void SystemDataProvider::fetchMemoryInfo()
+void SystemDataProvider::updateDemand()
 {
-    if (m_memoryTotal > 0) {
-        qulonglong totalGB = m_memoryTotal / (1024 * 1024 * 1024);
-        qulonglong usedGB = m_memoryUsed / (1024 * 1024 * 1024);
-        m_memoryInfo = QString("%1 GiB RAM").arg(totalGB);
-    } else {
-        m_memoryInfo = "Unknown";
-    }
-    emit dataChanged();
+    if (!m_sampler) return;
+    const SystemSampler::Demand demand = m_viewVisible ? SystemSampler::Interactive
+        : m_externalConsumer ? SystemSampler::Background : SystemSampler::Unobserved;
+    SystemSampler *sampler = m_sampler;
+    QMetaObject::invokeMethod(sampler, [sampler, demand]() { sampler->setDemand(demand); }, Qt::QueuedConnection);
 }
 
-void SystemDataProvider::fetchDiskHardwareInfo()
+void SystemDataProvider::onSnapshotPublished()
 {
-    m_diskHardwareInfo = "";
-    
-    // 初始化 COM
-    HRESULT hres = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    if (FAILED(hres) && hres != RPC_E_CHANGED_MODE) {
-        m_diskHardwareInfo = "WMI init failed";
-        emit dataChanged();
-        return;
-    }
-    
-    // 设置安全级别
-    hres = CoInitializeSecurity(
-        nullptr, -1, nullptr, nullptr,
-        RPC_C_AUTHN_LEVEL_DEFAULT,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        nullptr, EOAC_NONE, nullptr
-    );
-    
-    IWbemLocator* pLoc = nullptr;
-    hres = CoCreateInstance(CLSID_WbemLocator, nullptr, CLSCTX_INPROC_SERVER,
-                            IID_IWbemLocator, (LPVOID*)&pLoc);
-    
-    if (SUCCEEDED(hres)) {
-        IWbemServices* pSvc = nullptr;
-        BSTR wmiNamespace = SysAllocString(L"ROOT\\CIMV2");
-        hres = pLoc->ConnectServer(
-            wmiNamespace,
-            nullptr, nullptr, nullptr, 0, nullptr, nullptr, &pSvc
-        );
-        SysFreeString(wmiNamespace);
-        
-        if (SUCCEEDED(hres)) {
-            // 设置安全
-            hres = CoSetProxyBlanket(
-                pSvc,
-                RPC_C_AUTHN_WINNT,
-                RPC_C_AUTHZ_NONE,
-                nullptr,
-                RPC_C_AUTHN_LEVEL_CALL,
-                RPC_C_IMP_LEVEL_IMPERSONATE,
-                nullptr,
-                EOAC_NONE
-            );
-            
-            if (SUCCEEDED(hres)) {
-                IEnumWbemClassObject* pEnumerator = nullptr;
-                BSTR query = SysAllocString(L"SELECT * FROM Win32_DiskDrive");
-                BSTR wql = SysAllocString(L"WQL");
-                hres = pSvc->ExecQuery(
-                    wql,
-                    query,
-                    WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-                    nullptr,
-                    &pEnumerator
-                );
-                SysFreeString(query);
-                SysFreeString(wql);
-                
-                if (SUCCEEDED(hres)) {
-                    IWbemClassObject* pclsObj = nullptr;
-                    ULONG uReturn = 0;
-                    QStringList disks;
-                    
-                    while (pEnumerator) {
-                        HRESULT hr = pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn);
-                        if (uReturn == 0) break;
-                        
-                        VARIANT vtProp;
-                        
-                        // 获取型号
-                        hr = pclsObj->Get(L"Model", 0, &vtProp, nullptr, nullptr);
-                        QString model = (vtProp.vt == VT_BSTR) ? QString::fromWCharArray(vtProp.bstrVal) : "Unknown";
-                        VariantClear(&vtProp);
-                        
-                        // 获取大小
-                        hr = pclsObj->Get(L"Size", 0, &vtProp, nullptr, nullptr);
-                        QString size = "Unknown";
-                        if (vtProp.vt == VT_BSTR) {
-                            bool ok;
-                            qint64 bytes = QString::fromWCharArray(vtProp.bstrVal).toLongLong(&ok);
-                            if (ok && bytes > 0) {
-                                double gb = bytes / (1024.0 * 1024.0 * 1024.0);
-                                size = QString("%1 GB").arg(gb, 0, 'f', 1);
-                            }
-                        }
-                        VariantClear(&vtProp);
-                        
-                        // 获取接口类型
-                        hr = pclsObj->Get(L"InterfaceType", 0, &vtProp, nullptr, nullptr);
-                        QString interfaceType = (vtProp.vt == VT_BSTR) ? QString::fromWCharArray(vtProp.bstrVal) : "Unknown";
-                        VariantClear(&vtProp);
-                        
-                        // 获取序列号
-                        hr = pclsObj->Get(L"SerialNumber", 0, &vtProp, nullptr, nullptr);
-                        QString serial = (vtProp.vt == VT_BSTR) ? QString::fromWCharArray(vtProp.bstrVal) : "Unknown";
-                        VariantClear(&vtProp);
-                        
-                        // 格式化输出
-                        QString diskInfo = QString("%1 - %2, %3, S/N: %4")
-                            .arg(model).arg(size).arg(interfaceType).arg(serial.left(20));
-                        disks.append(diskInfo);
-                        
-                        pclsObj->Release();
-                    }
-                    
-                    if (disks.isEmpty()) {
-                        m_diskHardwareInfo = "No disks found";
-                    } else {
-                        m_diskHardwareInfo = disks.join("\n");
-                    }
-                    
-                    pEnumerator->Release();
-                }
-                pSvc->Release();
-            }
-        }
-        pLoc->Release();
-    }
-    
-    CoUninitialize();
-    emit dataChanged();
+    // Several publications may have queued up while the GUI was busy; only
+    // the newest one matters.
+    applySnapshot(m_sampler->latest());
 }
 
-void SystemDataProvider::fetchMemoryHardwareInfo()
+void SystemDataProvider::applySnapshot(SystemSnapshotPtr latest)
 {
-    m_memoryHardwareInfo.clear();
+    if (latest == m_snapshot) return;
+    const SnapshotFields changed = SystemSnapshot::changedFields(*m_snapshot, *latest);
+    m_snapshot = latest;
 
-    HRESULT hres = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    if (FAILED(hres) && hres != RPC_E_CHANGED_MODE) {
-        m_memoryHardwareInfo = "WMI init failed";
-        emit dataChanged();
-        return;
+    // The clock runs off sample timestamps instead of a timer of its own;
+    // the CPU interval keeps it within a second while a window is visible.
+    if (latest->timestampMs && latest->timestampMs / 60000 != m_timeMinute) {
+        m_timeMinute = latest->timestampMs / 60000;
+        m_time = QDateTime::fromMSecsSinceEpoch(latest->timestampMs).toString("HH:mm");
+        emit timeChanged();
+        m_instrumentation.count(Instrumentation::PropertySignals);
     }
-
-    hres = CoInitializeSecurity(
-        nullptr, -1, nullptr, nullptr,
-        RPC_C_AUTHN_LEVEL_DEFAULT,
-        RPC_C_IMP_LEVEL_IMPERSONATE,
-        nullptr, EOAC_NONE, nullptr
-    );
-
-    IWbemLocator* pLoc = nullptr;
-    hres = CoCreateInstance(CLSID_WbemLocator, nullptr, CLSCTX_INPROC_SERVER,
-                            IID_IWbemLocator, (LPVOID*)&pLoc);
-
-    if (SUCCEEDED(hres)) {
-        IWbemServices* pSvc = nullptr;
-        BSTR wmiNamespace = SysAllocString(L"ROOT\\CIMV2");
-        hres = pLoc->ConnectServer(
-            wmiNamespace,
-            nullptr, nullptr, nullptr, 0, nullptr, nullptr, &pSvc
-        );
-        SysFreeString(wmiNamespace);
-
-        if (SUCCEEDED(hres)) {
-            hres = CoSetProxyBlanket(
-                pSvc,
-                RPC_C_AUTHN_WINNT,
-                RPC_C_AUTHZ_NONE,
-                nullptr,
-                RPC_C_AUTHN_LEVEL_CALL,
-                RPC_C_IMP_LEVEL_IMPERSONATE,
-                nullptr,
-                EOAC_NONE
-            );
-
-            if (SUCCEEDED(hres)) {
-                IEnumWbemClassObject* pEnumerator = nullptr;
-                BSTR query = SysAllocString(L"SELECT Manufacturer, Capacity, Speed, PartNumber FROM Win32_PhysicalMemory");
-                BSTR wql = SysAllocString(L"WQL");
-                hres = pSvc->ExecQuery(
-                    wql,
-                    query,
-                    WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
-                    nullptr,
-                    &pEnumerator
-                );
-                SysFreeString(query);
-                SysFreeString(wql);
-
-                if (SUCCEEDED(hres)) {
-                    IWbemClassObject* pclsObj = nullptr;
-                    ULONG uReturn = 0;
-                    QStringList modules;
-
-                    while (pEnumerator) {
-                        HRESULT hr = pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn);
-                        if (uReturn == 0) break;
-
-                        VARIANT vtProp;
-
-                        // Manufacturer
-                        hr = pclsObj->Get(L"Manufacturer", 0, &vtProp, nullptr, nullptr);
-                        QString manuf = (vtProp.vt == VT_BSTR) ? QString::fromWCharArray(vtProp.bstrVal) : "Unknown";
-                        VariantClear(&vtProp);
-
-                        // Capacity
-                        hr = pclsObj->Get(L"Capacity", 0, &vtProp, nullptr, nullptr);
-                        QString cap = "Unknown";
-                        if (vtProp.vt == VT_BSTR) {
-                            bool ok;
-                            quint64 bytes = QString::fromWCharArray(vtProp.bstrVal).toULongLong(&ok);
-                            if (ok) {
-                                double gb = bytes / (1024.0 * 1024.0 * 1024.0);
-                                cap = QString::number(gb, 'f', 1) + " GB";
-                            }
-                        } else if (vtProp.vt == VT_UI8) {
-                            quint64 bytes = vtProp.ullVal;
-                            double gb = bytes / (1024.0 * 1024.0 * 1024.0);
-                            cap = QString::number(gb, 'f', 1) + " GB";
-                        }
-                        VariantClear(&vtProp);
-
-                        // Speed
-                        hr = pclsObj->Get(L"Speed", 0, &vtProp, nullptr, nullptr);
-                        QString speed = (vtProp.vt == VT_BSTR) ? QString::fromWCharArray(vtProp.bstrVal) : QString::number(vtProp.uintVal);
-                        VariantClear(&vtProp);
-
-                        // PartNumber
-                        hr = pclsObj->Get(L"PartNumber", 0, &vtProp, nullptr, nullptr);
-                        QString part = (vtProp.vt == VT_BSTR) ? QString::fromWCharArray(vtProp.bstrVal) : "";
-                        VariantClear(&vtProp);
-
-                        QString info = QString("%1 - %2%3").arg(manuf).arg(cap).arg(part.isEmpty() ? "" : (", " + part));
-                        if (!speed.isEmpty()) info += QString(", %1 MHz").arg(speed);
-                        modules.append(info);
-
-                        pclsObj->Release();
-                    }
-
-                    if (modules.isEmpty()) m_memoryHardwareInfo = "No memory modules found";
-                    else m_memoryHardwareInfo = modules.join("\n");
-
-                    pEnumerator->Release();
-                }
-                pSvc->Release();
-            }
-        }
-        pLoc->Release();
+    if (!changed) return;
+
+    using namespace SnapshotField;
+    m_instrumentation.count(Instrumentation::SnapshotsApplied);
+    // The change signal behind each field; SampleStats has none, and the
+    // disk list and its I/O rates share one.
+    static const struct {
+        SnapshotFields fields;
+        void (SystemDataProvider::*signal)();
+    } kSignals[] = {
+        { CpuInfo, &SystemDataProvider::cpuInfoChanged },
+        { GpuInfo, &SystemDataProvider::gpuInfoChanged },
+        { DisplayInfo, &SystemDataProvider::displayInfoChanged },
+        { MemoryInfo, &SystemDataProvider::memoryInfoChanged },
+        { NetworkInfo, &SystemDataProvider::networkInfoChanged },
+        { DiskHardwareInfo, &SystemDataProvider::diskHardwareInfoChanged },
+        { MemoryHardwareInfo, &SystemDataProvider::memoryHardwareInfoChanged },
+        { OsInfo, &SystemDataProvider::osInfoChanged },
+        { KernelInfo, &SystemDataProvider::kernelInfoChanged },
+        { ShellInfo, &SystemDataProvider::shellInfoChanged },
+        { Uptime, &SystemDataProvider::uptimeChanged },
+        { Username, &SystemDataProvider::usernameChanged },
+        { CurrentDir, &SystemDataProvider::currentDirChanged },
+        { CpuPercent, &SystemDataProvider::cpuPercentChanged },
+        { CpuCores, &SystemDataProvider::cpuCoresChanged },
+        { MemoryPercent, &SystemDataProvider::memoryPercentChanged },
+        { MemoryTotal, &SystemDataProvider::memoryTotalChanged },
+        { MemoryUsed, &SystemDataProvider::memoryUsedChanged },
+        { MemoryDetail, &SystemDataProvider::memoryDetailChanged },
+        { Pressure, &SystemDataProvider::pressureChanged },
+        { DiskInfo | DiskIo, &SystemDataProvider::diskInfoChanged },
+        { Processes, &SystemDataProvider::processesChanged },
+        { NetworkTraffic, &SystemDataProvider::networkTrafficChanged },
+        { Alerts, &SystemDataProvider::alertsChanged },
+    };
+    quint64 emitted = 0;
+    for (const auto &entry : kSignals) {
+        if (!(changed & entry.fields)) continue;
+        emit (this->*entry.signal)();
+        ++emitted;
     }
+    m_instrumentation.count(Instrumentation::PropertySignals, emitted);
+    emit dataChanged(changed);
+}
 
-    CoUninitialize();
-    emit dataChanged();
+QVariantList SystemDataProvider::getHistory(int metric, int resolution, qint64 fromMs, qint64 toMs, const QString &key) const
+{
+    QVariantList points;
+    if (metric < 0 || metric >= MetricHistory::MetricCount || resolution < 0 || resolution >= MetricHistory::ResolutionCount)
+        return points;
+    m_history.forEach(MetricHistory::Metric(metric), key, MetricHistory::Resolution(resolution), fromMs, toMs, [&](const HistoryPoint &p) {
+        QVariantMap point;
+        point["time"] = p.timestampMs;
+        point["min"] = p.min;
+        point["max"] = p.max;
+        point["avg"] = p.avg;
+        points.append(point);
+    });
+    return points;
 }
 
-void SystemDataProvider::fetchNetworkInfo()
+QStringList SystemDataProvider::historyKeys(int metric) const
 {
-    // 获取网络适配器信息
-    ULONG bufferSize = 0;
-    GetAdaptersInfo(nullptr, &bufferSize);
-    if (bufferSize == 0) {
-        m_networkInfo = "No adapters";
-        return;
-    }
-    
-    IP_ADAPTER_INFO* adapterInfo = (IP_ADAPTER_INFO*)malloc(bufferSize);
-    if (adapterInfo && GetAdaptersInfo(adapterInfo, &bufferSize) == ERROR_SUCCESS) {
-        QStringList adapters;
-        for (IP_ADAPTER_INFO* adapter = adapterInfo; adapter; adapter = adapter->Next) {
-            if (adapter->Type == MIB_IF_TYPE_ETHERNET || adapter->Type == IF_TYPE_IEEE80211) {
-                QString name = QString::fromLocal8Bit(adapter->Description);
-                if (!name.isEmpty()) {
-                    adapters.append(name);
-                }
-            }
-        }
-        m_networkInfo = adapters.isEmpty() ? "No adapters" : adapters.join(", ");
-    } else {
-        m_networkInfo = "Unknown";
-    }
-    
-    if (adapterInfo) free(adapterInfo);
-    emit dataChanged();
+    if (metric < 0 || metric >= MetricHistory::MetricCount) return QStringList();
+    return m_history.keys(MetricHistory::Metric(metric));
 }
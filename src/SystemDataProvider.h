@@ -4,102 +4,193 @@
 #include <QObject>
 #include <QString>
 #include <QVariantMap>
+#include <QThread>
 #include <QTimer>
+#include <memory>
+#include "SystemSnapshot.h"
+#include "SnapshotFormat.h"
+#include "MetricHistory.h"
+#include "Instrumentation.h"
+
+class SystemSampler;
+class HardwareWatcher;
+class TraceReader;
 
 class SystemDataProvider : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(QString cpuInfo READ cpuInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString gpuInfo READ gpuInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString displayInfo READ displayInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString memoryInfo READ memoryInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString networkInfo READ networkInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString diskHardwareInfo READ diskHardwareInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString memoryHardwareInfo READ memoryHardwareInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString osInfo READ osInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString kernelInfo READ kernelInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString shellInfo READ shellInfo NOTIFY dataChanged)
-    Q_PROPERTY(QString uptime READ uptime NOTIFY dataChanged)
-    Q_PROPERTY(QString username READ username NOTIFY dataChanged)
-    Q_PROPERTY(QString currentDir READ currentDir NOTIFY dataChanged)
-    Q_PROPERTY(int cpuPercent READ cpuPercent NOTIFY dataChanged)
-    Q_PROPERTY(int memoryPercent READ memoryPercent NOTIFY dataChanged)
-    Q_PROPERTY(qulonglong memoryTotal READ memoryTotal NOTIFY dataChanged)
-    Q_PROPERTY(qulonglong memoryUsed READ memoryUsed NOTIFY dataChanged)
+    Q_PROPERTY(QString cpuInfo READ cpuInfo NOTIFY cpuInfoChanged)
+    Q_PROPERTY(QString gpuInfo READ gpuInfo NOTIFY gpuInfoChanged)
+    Q_PROPERTY(QString displayInfo READ displayInfo NOTIFY displayInfoChanged)
+    Q_PROPERTY(QString memoryInfo READ memoryInfo NOTIFY memoryInfoChanged)
+    Q_PROPERTY(QString networkInfo READ networkInfo NOTIFY networkInfoChanged)
+    Q_PROPERTY(QString diskHardwareInfo READ diskHardwareInfo NOTIFY diskHardwareInfoChanged)
+    Q_PROPERTY(QString memoryHardwareInfo READ memoryHardwareInfo NOTIFY memoryHardwareInfoChanged)
+    Q_PROPERTY(QString osInfo READ osInfo NOTIFY osInfoChanged)
+    Q_PROPERTY(QString kernelInfo READ kernelInfo NOTIFY kernelInfoChanged)
+    Q_PROPERTY(QString shellInfo READ shellInfo NOTIFY shellInfoChanged)
+    Q_PROPERTY(QString uptime READ uptime NOTIFY uptimeChanged)
+    Q_PROPERTY(QString username READ username NOTIFY usernameChanged)
+    Q_PROPERTY(QString currentDir READ currentDir NOTIFY currentDirChanged)
+    Q_PROPERTY(int cpuPercent READ cpuPercent NOTIFY cpuPercentChanged)
+    Q_PROPERTY(QVariantMap cpuTimes READ cpuTimes NOTIFY cpuCoresChanged)
+    Q_PROPERTY(QVariantList cpuCores READ cpuCores NOTIFY cpuCoresChanged)
+    Q_PROPERTY(int memoryPercent READ memoryPercent NOTIFY memoryPercentChanged)
+    Q_PROPERTY(qulonglong memoryTotal READ memoryTotal NOTIFY memoryTotalChanged)
+    Q_PROPERTY(qulonglong memoryUsed READ memoryUsed NOTIFY memoryUsedChanged)
+    Q_PROPERTY(QVariantMap memoryDetail READ memoryDetail NOTIFY memoryDetailChanged)
+    Q_PROPERTY(QVariantMap pressure READ pressure NOTIFY pressureChanged)
+    Q_PROPERTY(QVariantList diskInfo READ getDiskInfo NOTIFY diskInfoChanged)
+    Q_PROPERTY(QVariantList processes READ processes NOTIFY processesChanged)
+    Q_PROPERTY(QVariantList network READ network NOTIFY networkTrafficChanged)
+    Q_PROPERTY(QVariantList alerts READ alerts NOTIFY alertsChanged)
     Q_PROPERTY(QString time READ time NOTIFY timeChanged)
 
 public:
+    enum Mode {
+        Live,   // samples the system on a worker thread
+        Manual  // no sampler; snapshots are fed in with applySnapshot() or startReplay()
+    };
+
     explicit SystemDataProvider(QObject *parent = nullptr);
+    explicit SystemDataProvider(Mode mode, QObject *parent = nullptr);
+    ~SystemDataProvider() override;
+
+    // Makes snapshot current and emits the signals for what changed. Live
+    // providers call this for every publication they pick up; the UI
+    // benchmark calls it directly.
+    void applySnapshot(SystemSnapshotPtr snapshot);
+
+    // Latest snapshot picked up on the GUI thread; never null.
+    SystemSnapshotPtr snapshot() const { return m_snapshot; }
+    // Thread-safe: the newest snapshot the sampler has published, which may
+    // be ahead of snapshot(). Null in Manual mode.
+    SystemSnapshotPtr latestPublished() const;
 
-    QString cpuInfo() const { return m_cpuInfo; }
-    QString gpuInfo() const { return m_gpuInfo; }
-    QString displayInfo() const { return m_displayInfo; }
-    QString osInfo() const { return m_osInfo; }
-    QString kernelInfo() const { return m_kernelInfo; }
-    QString shellInfo() const { return m_shellInfo; }
-    QString uptime() const { return m_uptime; }
-    QString username() const { return m_username; }
-    QString currentDir() const { return m_currentDir; }
-    int cpuPercent() const { return m_cpuPercent; }
-    int memoryPercent() const { return m_memoryPercent; }
+    QString cpuInfo() const { return m_snapshot->inventory->cpuInfo; }
+    QString gpuInfo() const { return m_snapshot->inventory->gpuInfo; }
+    QString displayInfo() const { return m_snapshot->inventory->displayInfo; }
+    QString osInfo() const { return m_snapshot->inventory->osInfo; }
+    QString kernelInfo() const { return m_snapshot->inventory->kernelInfo; }
+    QString shellInfo() const { return m_snapshot->inventory->shellInfo; }
+    QString uptime() const { return SnapshotFormat::uptime(*m_snapshot); }
+    QString username() const { return m_snapshot->inventory->username; }
+    QString currentDir() const { return m_snapshot->inventory->currentDir; }
+    int cpuPercent() const { return m_snapshot->cpuPercent; }
+    QVariantMap cpuTimes() const { return SnapshotFormat::cpuTimesToVariantMap(m_snapshot->cpu); }
+    QVariantList cpuCores() const { return SnapshotFormat::cpuCoresToVariantList(m_snapshot->cpu); }
+    int memoryPercent() const { return m_snapshot->memoryPercent; }
     QString time() const { return m_time; }
-    qulonglong memoryTotal() const { return m_memoryTotal; }
-    qulonglong memoryUsed() const { return m_memoryUsed; }
-    QString memoryInfo() const { return m_memoryInfo; }
-    QString diskHardwareInfo() const { return m_diskHardwareInfo; }
-    QString memoryHardwareInfo() const { return m_memoryHardwareInfo; }
-    QString networkInfo() const { return m_networkInfo; }
+    qulonglong memoryTotal() const { return m_snapshot->memoryTotal; }
+    qulonglong memoryUsed() const { return m_snapshot->memoryUsed; }
+    QString memoryInfo() const { return SnapshotFormat::memoryInfo(*m_snapshot); }
+    QString diskHardwareInfo() const { return SnapshotFormat::diskDevices(*m_snapshot->inventory); }
+    QString memoryHardwareInfo() const { return SnapshotFormat::memoryModules(*m_snapshot->inventory); }
+    QString networkInfo() const { return m_snapshot->inventory->networkInfo; }
+    QVariantList processes() const { return SnapshotFormat::processesToVariantList(m_snapshot->processes); }
+    QVariantList network() const { return SnapshotFormat::networkToVariantList(m_snapshot->network); }
+    QVariantMap memoryDetail() const { return SnapshotFormat::memoryDetailToVariantMap(m_snapshot->memoryDetail); }
+    QVariantMap pressure() const { return SnapshotFormat::pressureToVariantMap(m_snapshot->pressure); }
+    QVariantList alerts() const { return SnapshotFormat::alertsToVariantList(m_snapshot->alerts); }
+
+    Q_INVOKABLE QVariantList getDiskInfo() const { return SnapshotFormat::volumesToVariantList(m_snapshot->volumes, m_snapshot->diskIo); }
+
+    // History of every periodic metric; see MetricHistory::Metric. C++
+    // callers should use MetricHistory::range() or forEach() directly, which
+    // touch only the requested buckets; getHistory() wraps the same query as
+    // a list of {time, min, max, avg} maps, and historyKeys() lists the
+    // series of a per-core, per-volume, per-device or per-interface metric.
+    const MetricHistory &history() const { return m_history; }
+    Q_INVOKABLE QVariantList getHistory(int metric, int resolution, qint64 fromMs, qint64 toMs, const QString &key = QString()) const;
+    Q_INVOKABLE QStringList historyKeys(int metric) const;
+
+    // Sampling slows down while no view shows the data and nothing else
+    // reads it, so views and exporters report themselves here. A view
+    // counts as visible until it says otherwise.
+    void setViewVisible(bool visible);
+    void setExternalConsumer(bool active);
+
+    // Compiles alert rules (see AlertEngine) and hands them to the sampler.
+    // On a syntax error returns false with the reason in error and keeps
+    // the current rules.
+    bool setAlertRules(const QString &text, QString *error = nullptr);
 
-    Q_INVOKABLE QVariantList getDiskInfo() const { return m_diskInfo; }
+    // Appends every snapshot the sampler publishes to a trace file at path
+    // (see SnapshotTrace.h), replacing any earlier recording. Live mode
+    // only.
+    bool startRecording(const QString &path, QString *error = nullptr);
+
+    // Plays the trace at path back through applySnapshot(), starting at
+    // fromMs into the recording, with the recorded gaps between snapshots
+    // divided by speed; gaps where recording paused are cut short. The
+    // history fills as it plays. Manual mode only; emits replayFinished()
+    // after the last snapshot.
+    bool startReplay(const QString &path, double speed = 1.0, qint64 fromMs = 0, QString *error = nullptr);
+
+    // Collector latencies and refresh counters, shared with the sampler;
+    // views record their own refresh cost into it.
+    Instrumentation &instrumentation() { return m_instrumentation; }
+    const Instrumentation &instrumentation() const { return m_instrumentation; }
 
 signals:
-    void dataChanged();
+    // Emitted once per picked-up snapshot, after the per-property signals,
+    // with the set of fields that actually changed.
+    void dataChanged(SnapshotFields changed);
+
+    void cpuInfoChanged();
+    void gpuInfoChanged();
+    void displayInfoChanged();
+    void memoryInfoChanged();
+    void networkInfoChanged();
+    void diskHardwareInfoChanged();
+    void memoryHardwareInfoChanged();
+    void osInfoChanged();
+    void kernelInfoChanged();
+    void shellInfoChanged();
+    void uptimeChanged();
+    void usernameChanged();
+    void currentDirChanged();
+    void cpuPercentChanged();
+    void cpuCoresChanged();
+    void memoryPercentChanged();
+    void memoryTotalChanged();
+    void memoryUsedChanged();
+    void memoryDetailChanged();
+    void pressureChanged();
+    void diskInfoChanged();
+    void processesChanged();
+    void networkTrafficChanged();
+    void alertsChanged();
     void timeChanged();
 
+    void replayFinished();
+
 private slots:
-    void fetchAllData();
-    void updateSystemData();
-    void updateTime();
+    void onSnapshotPublished();
+    void replayStep();
 
 private:
-    void fetchCpuInfo();
-    void fetchGpuInfo();
-    void fetchDisplayInfo();
-    void fetchOsInfo();
-    void fetchKernelInfo();
-    void fetchShellInfo();
-    void fetchUptime();
-    void fetchUserInfo();
-    void fetchDiskInfo();
-    void fetchMemoryInfo();
-    void fetchDiskHardwareInfo();
-    void fetchMemoryHardwareInfo();
-    void fetchNetworkInfo();
-    void fetchCpuUsage();
-    void fetchMemoryUsage();
-
-    QString m_cpuInfo;
-    QString m_gpuInfo;
-    QString m_displayInfo;
-    QString m_osInfo;
-    QString m_kernelInfo;
-    QString m_shellInfo;
-    QString m_uptime;
-    QString m_username;
-    QString m_currentDir;
-    int m_cpuPercent;
-    int m_memoryPercent;
+    void updateDemand();
+
+    // Longest wait between two replayed snapshots, in wall time.
+    static const int kMaxReplayGapMs = 2000;
+
+    SystemSnapshotPtr m_snapshot;
     QString m_time;
-    QVariantList m_diskInfo;
-    qulonglong m_memoryTotal;
-    qulonglong m_memoryUsed;
-    QString m_memoryInfo;
-    QString m_diskHardwareInfo;
-    QString m_memoryHardwareInfo;
-    QString m_networkInfo;
-
-    QTimer *m_updateTimer;
-    QTimer *m_timeTimer;
+    qint64 m_timeMinute; // minute of m_time since the epoch, -1 before the first snapshot
+    MetricHistory m_history;
+    Instrumentation m_instrumentation;
+
+    QThread m_samplerThread;
+    SystemSampler *m_sampler;
+    HardwareWatcher *m_hardwareWatcher;
+    bool m_viewVisible;
+    bool m_externalConsumer;
+
+    std::unique_ptr<TraceReader> m_replay;
+    SystemSnapshotPtr m_replayNext;
+    double m_replaySpeed;
+    QTimer m_replayTimer;
 };
 
 #endif
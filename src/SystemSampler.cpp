@@ -0,0 +1,421 @@
+#include "SystemSampler.h"
+#include "MetricHistory.h"
+#include "InventoryCache.h"
+#include "Instrumentation.h"
+#include "SnapshotTrace.h"
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QRunnable>
+#include <QSocketNotifier>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include "Logger.h"
+
+namespace {
+
+// Per slow step, in SystemBackend::SlowInventoryStep order. WMI queries get
+// longer than the sysfs/Win32 ones.
+const int kCollectorDeadlineMs[SystemBackend::SlowInventoryStepCount] = { 2000, 2000, 2000, 5000, 5000 };
+
+// Per metric collector, in SystemBackend::Metric order. Uptime is shown in
+// minutes and disk usage moves slowly (disk I/O does not); the CPU interval also paces the
+// clock, which the GUI derives from snapshot timestamps. The process scan
+// is the most expensive collector on a busy host. Pressure is a kernel
+// average already; its triggers cover sudden stalls.
+const int kMetricIntervalMs[SystemBackend::MetricCount] = { 30000, 30000, 1000, 2000, 2000, 2000, 2000, 5000 };
+// A collector due within this fraction of its interval runs on the current
+// tick instead of waking the thread again shortly after. Also absorbs coarse
+// timers firing a little early.
+const int kCoalesceDivisor = 8;
+// Interval stretch per SystemSampler::Demand.
+const int kDemandStretch[] = { 1, 5, 30 };
+// After this many CPU samples below kIdleCpuPercent the host counts as idle
+// and intervals stretch by kIdleStretch more, until the next busy sample.
+const int kIdleSamples = 10;
+const int kIdleCpuPercent = 5;
+const int kIdleStretch = 3;
+const int kMaxStretch = 60;
+const int kWakeupWindowMs = 60000;
+// m_sampledMs of a collector that has not run yet.
+const qint64 kNeverMs = std::numeric_limits<qint64>::min();
+
+class CollectorTask : public QRunnable
+{
+public:
+    explicit CollectorTask(std::function<void()> fn) : m_fn(std::move(fn)) {}
+    void run() override { m_fn(); }
+
+private:
+    std::function<void()> m_fn;
+};
+
+} // namespace
+
+SystemSampler::SystemSampler(std::unique_ptr<SystemBackend> backend, MetricHistory *history, QObject *parent)
+    : QObject(parent), m_backend(std::move(backend)), m_history(history), m_instrumentation(nullptr), m_inventoryCacheTried(false), m_latest(std::make_shared<SystemSnapshot>()), m_updateTimer(nullptr), m_inventoryDirty(true),
+      m_demand(Interactive), m_quietSamples(0), m_wakeupWindowStartMs(0), m_wakeupsInWindow(0), m_wakeupsPerSecond(0),
+      m_collectorPool(new QThreadPool), m_inbox(std::make_shared<CollectorInbox>()), m_inventoryPass(0), m_pendingSteps(0), m_runningSteps(0)
+{
+    m_inbox->sampler = this;
+    m_collectorPool->setMaxThreadCount(SystemBackend::SlowInventoryStepCount);
+    m_collectorStats.resize(SystemBackend::SlowInventoryStepCount);
+    for (int step = 0; step < SystemBackend::SlowInventoryStepCount; ++step)
+        m_collectorStats[step].name = SystemBackend::slowInventoryStepName(SystemBackend::SlowInventoryStep(step));
+    std::fill(std::begin(m_sampledMs), std::end(m_sampledMs), kNeverMs);
+    m_clock.start();
+}
+
+SystemSampler::~SystemSampler()
+{
+    {
+        QMutexLocker locker(&m_inbox->mutex);
+        m_inbox->sampler = nullptr;
+    }
+    // Deleting the pool waits for its tasks. A hung collector would block
+    // shutdown, so in that case the pool is left to the process exit.
+    if (m_collectorPool->activeThreadCount() == 0) delete m_collectorPool;
+}
+
+void SystemSampler::setInventoryCachePath(const QString &path)
+{
+    m_inventoryCache.reset(path.isEmpty() ? nullptr : new InventoryCache(path));
+}
+
+void SystemSampler::start()
+{
+    // No start-up delay: the first pass publishes the cheap fields straight
+    // away and streams the slow inventory in afterwards.
+    QTimer::singleShot(0, this, &SystemSampler::fetchAllData);
+}
+
+void SystemSampler::stop()
+{
+    if (m_updateTimer) m_updateTimer->stop();
+    setTraceWriter(nullptr);
+}
+
+SystemSnapshotPtr SystemSampler::latest() const
+{
+    return std::atomic_load(&m_latest);
+}
+
+std::shared_ptr<SystemSnapshot> SystemSampler::acquireSnapshot(quint32 metrics)
+{
+    // Reuse a pooled snapshot that nobody else references any more: its
+    // columns still have their capacity, so collectors can overwrite them
+    // without allocating. Only the previous values need carrying over, for
+    // collectors that skip a field when a read fails, plus the columns of
+    // collectors that do not run this tick.
+    const SystemSnapshotPtr prev = latest();
+    for (const std::shared_ptr<SystemSnapshot> &candidate : m_pool) {
+        if (candidate.use_count() != 1 || candidate == prev) continue;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        SystemSnapshot &s = *candidate;
+        s.inventory = prev->inventory;
+        s.uptimeSeconds = prev->uptimeSeconds;
+        s.cpuPercent = prev->cpuPercent;
+        s.memoryPercent = prev->memoryPercent;
+        s.memoryTotal = prev->memoryTotal;
+        s.memoryUsed = prev->memoryUsed;
+        s.memoryDetail = prev->memoryDetail;
+        s.pressure = prev->pressure;
+        s.inventoryMicros = prev->inventoryMicros;
+        s.collectors = prev->collectors;
+        if (!(metrics & (1u << SystemBackend::DiskMetric))) s.volumes = prev->volumes;
+        if (!(metrics & (1u << SystemBackend::CpuMetric))) s.cpu = prev->cpu;
+        if (!(metrics & (1u << SystemBackend::ProcessMetric))) s.processes = prev->processes;
+        if (!(metrics & (1u << SystemBackend::NetworkMetric))) s.network = prev->network;
+        if (!(metrics & (1u << SystemBackend::DiskIoMetric))) s.diskIo = prev->diskIo;
+        return candidate;
+    }
+
+    auto fresh = std::make_shared<SystemSnapshot>(*prev);
+    if (m_pool.size() < kPoolSize) m_pool.append(fresh);
+    return fresh;
+}
+
+void SystemSampler::publish(std::shared_ptr<SystemSnapshot> snapshot)
+{
+    // Encoded while the snapshot is still ours alone; the writer throttles
+    // and batches, so most calls only append to a buffer.
+    if (m_trace && !m_trace->append(*snapshot)) {
+        NEOFETCH_LOG(Logger::Warning, "Recording stopped: cannot write the trace file");
+        m_trace.reset();
+    }
+    std::atomic_store(&m_latest, SystemSnapshotPtr(std::move(snapshot)));
+    if (m_instrumentation) m_instrumentation->count(Instrumentation::SnapshotsPublished);
+    emit snapshotPublished();
+}
+
+void SystemSampler::sampleOnce()
+{
+    const bool dirty = m_inventoryDirty;
+    m_inventoryDirty = false;
+    std::fill(std::begin(m_sampledMs), std::end(m_sampledMs), kNeverMs);
+    updateSystemData();
+    m_inventoryDirty = dirty;
+}
+
+void SystemSampler::invalidateInventory()
+{
+    // Hotplug events tend to arrive in bursts; the next tick will pick the
+    // flag up, so a burst costs one inventory pass rather than one per event.
+    m_inventoryDirty = true;
+    if (m_updateTimer) QTimer::singleShot(0, this, &SystemSampler::updateSystemData);
+}
+
+void SystemSampler::setDemand(Demand demand)
+{
+    m_demand = demand;
+    scheduleNext();
+}
+
+void SystemSampler::setAlertRules(const AlertEngine &rules)
+{
+    m_alerts = rules;
+}
+
+void SystemSampler::setTraceWriter(std::shared_ptr<TraceWriter> trace)
+{
+    if (m_trace) m_trace->close();
+    m_trace = std::move(trace);
+}
+
+int SystemSampler::intervalStretch() const
+{
+    int stretch = kDemandStretch[m_demand];
+    if (m_quietSamples >= kIdleSamples) stretch *= kIdleStretch;
+    return qMin(stretch, kMaxStretch);
+}
+
+qint64 SystemSampler::intervalMs(int metric) const
+{
+    return qint64(kMetricIntervalMs[metric]) * intervalStretch();
+}
+
+void SystemSampler::scheduleNext()
+{
+    if (!m_updateTimer) return;
+    // Due times follow from the last run and the current interval, so a
+    // change of stretch applies to the pending wait too.
+    qint64 next = std::numeric_limits<qint64>::max();
+    for (int m = 0; m < SystemBackend::MetricCount; ++m)
+        next = qMin(next, m_sampledMs[m] == kNeverMs ? 0 : m_sampledMs[m] + intervalMs(m));
+    m_updateTimer->start(int(qMax<qint64>(0, next - m_clock.elapsed())));
+}
+
+void SystemSampler::countWakeup(qint64 nowMs)
+{
+    if (m_instrumentation) m_instrumentation->count(Instrumentation::SamplerWakeups);
+    ++m_wakeupsInWindow;
+    const qint64 elapsed = nowMs - m_wakeupWindowStartMs;
+    if (elapsed >= kWakeupWindowMs) {
+        m_wakeupsPerSecond = m_wakeupsInWindow * 1000.0 / elapsed;
+        m_wakeupWindowStartMs = nowMs;
+        m_wakeupsInWindow = 0;
+    }
+}
+
+void SystemSampler::fetchAllData()
+{
+    m_updateTimer = new QTimer(this);
+    m_updateTimer->setSingleShot(true);
+    connect(m_updateTimer, &QTimer::timeout, this, &SystemSampler::updateSystemData);
+    m_wakeupWindowStartMs = m_clock.elapsed();
+    for (int fd : m_backend->pressureTriggers()) {
+        QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+        connect(notifier, &QSocketNotifier::activated, this, &SystemSampler::onPressureTrigger);
+    }
+    updateSystemData();
+
+    // CPU usage is a difference of two readings; take the second one soon
+    // instead of leaving it at 0% for a whole interval.
+    m_sampledMs[SystemBackend::CpuMetric] = m_clock.elapsed() + kFirstCpuSampleMs - intervalMs(SystemBackend::CpuMetric);
+    scheduleNext();
+}
+
+void SystemSampler::onPressureTrigger()
+{
+    // Nobody would see the stall; the regular interval will record it.
+    if (m_demand == Unobserved) return;
+    if (m_instrumentation) m_instrumentation->count(Instrumentation::PressureWakeups);
+    m_sampledMs[SystemBackend::MemoryMetric] = kNeverMs;
+    m_sampledMs[SystemBackend::PressureMetric] = kNeverMs;
+    updateSystemData();
+}
+
+void SystemSampler::updateSystemData()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 nowMs = m_clock.elapsed();
+    quint32 due = 0;
+    for (int m = 0; m < SystemBackend::MetricCount; ++m) {
+        const qint64 interval = intervalMs(m);
+        if (m_sampledMs[m] != kNeverMs && m_sampledMs[m] + interval - nowMs > interval / kCoalesceDivisor) continue;
+        due |= 1u << m;
+        m_sampledMs[m] = nowMs;
+    }
+    const bool inventoryPass = m_inventoryDirty;
+    if (!due && !inventoryPass) {
+        scheduleNext();
+        return;
+    }
+    countWakeup(nowMs);
+
+    std::shared_ptr<SystemSnapshot> s = acquireSnapshot(due);
+    s->timestampMs = QDateTime::currentMSecsSinceEpoch();
+    if (inventoryPass) {
+        m_inventoryDirty = false;
+        m_passTimer.start();
+        ProbeTimer probe(m_instrumentation, Instrumentation::QuickInventory);
+        s->inventory = collectQuickInventory(*s->inventory);
+    }
+
+    // Only counters below this point: everything static lives in the
+    // inventory shared with the previous snapshot.
+    m_backend->collectMetrics(*s, m_instrumentation, due);
+    s->sampledMetrics = due;
+    if (due & (1u << SystemBackend::CpuMetric))
+        m_quietSamples = s->cpuPercent < kIdleCpuPercent ? m_quietSamples + 1 : 0;
+    s->intervalStretch = intervalStretch();
+    s->wakeupsPerSecond = m_wakeupsPerSecond;
+    {
+        ProbeTimer probe(m_instrumentation, Instrumentation::AlertRules);
+        m_alerts.evaluate(*s);
+        s->alerts = m_alerts.table();
+    }
+    s->sampleMicros = timer.nsecsElapsed() / 1000;
+
+    // Record before publishing so a consumer reacting to the new snapshot
+    // already finds it in the history.
+    if (m_history) m_history->append(*s);
+    publish(std::move(s));
+    if (m_instrumentation && !inventoryPass) m_instrumentation->record(Instrumentation::SamplerTick, timer.nsecsElapsed());
+
+    if (inventoryPass) startSlowInventory();
+    scheduleNext();
+}
+
+SystemInventoryPtr SystemSampler::collectQuickInventory(const SystemInventory &previous)
+{
+    // On the first pass a cache written earlier in this boot stands in for
+    // the slow collectors until they have re-run. Otherwise start from the
+    // previous inventory, so a re-collection after a hotplug event keeps
+    // showing the old values until the new ones are in.
+    std::shared_ptr<SystemInventory> inv;
+    if (m_inventoryCache && !m_inventoryCacheTried) {
+        m_inventoryCacheTried = true;
+        inv = m_inventoryCache->load(m_backend->bootId(), m_backend->hardwareFingerprint());
+    }
+    if (!inv) inv = std::make_shared<SystemInventory>(previous);
+    inv->complete = false;
+    m_backend->collectQuickInventory(*inv);
+    return inv;
+}
+
+void SystemSampler::startSlowInventory()
+{
+    ++m_inventoryPass;
+    m_pendingSteps = 0;
+    const quint64 pass = m_inventoryPass;
+    const std::shared_ptr<SystemBackend> backend = m_backend;
+    const std::shared_ptr<CollectorInbox> inbox = m_inbox;
+
+    for (int step = 0; step < SystemBackend::SlowInventoryStepCount; ++step) {
+        const quint32 bit = 1u << step;
+        // Still stuck from an earlier pass: keep its old value rather than
+        // tying up another thread.
+        if (m_runningSteps & bit) {
+            m_collectorStats[step].stale = true;
+            continue;
+        }
+        m_pendingSteps |= bit;
+        m_runningSteps |= bit;
+
+        m_collectorPool->start(new CollectorTask([backend, inbox, step, pass]() {
+            QElapsedTimer timer;
+            timer.start();
+            auto result = std::make_shared<SystemInventory>();
+            backend->collectSlowInventory(*result, SystemBackend::SlowInventoryStep(step));
+            const qint64 micros = timer.nsecsElapsed() / 1000;
+
+            QMutexLocker locker(&inbox->mutex);
+            if (SystemSampler *sampler = inbox->sampler) {
+                QMetaObject::invokeMethod(sampler, [sampler, step, pass, result, micros]() {
+                    sampler->onCollectorFinished(step, pass, result, micros);
+                }, Qt::QueuedConnection);
+            }
+        }));
+        QTimer::singleShot(kCollectorDeadlineMs[step], this, [this, step, pass]() { onCollectorDeadline(step, pass); });
+    }
+
+    if (!m_pendingSteps) publishInventory(std::make_shared<SystemInventory>(*latest()->inventory), true);
+}
+
+void SystemSampler::onCollectorFinished(int step, quint64 pass, std::shared_ptr<SystemInventory> result, qint64 micros)
+{
+    const quint32 bit = 1u << step;
+    m_runningSteps &= ~bit;
+    CollectorStat &stat = m_collectorStats[step];
+    stat.lastMicros = micros;
+    stat.stale = false;
+    if (m_instrumentation)
+        m_instrumentation->record(Instrumentation::Probe(Instrumentation::GpuInventory + step), micros * 1000);
+
+    // A result that arrives after its deadline is still newer than what is
+    // shown, so it is applied either way; it just no longer holds up the pass.
+    bool passFinished = false;
+    if (pass == m_inventoryPass && (m_pendingSteps & bit)) {
+        m_pendingSteps &= ~bit;
+        passFinished = m_pendingSteps == 0;
+    }
+
+    auto inv = std::make_shared<SystemInventory>(*latest()->inventory);
+    SystemBackend::copySlowInventory(SystemBackend::SlowInventoryStep(step), *result, *inv);
+    publishInventory(std::move(inv), passFinished);
+}
+
+void SystemSampler::onCollectorDeadline(int step, quint64 pass)
+{
+    const quint32 bit = 1u << step;
+    if (pass != m_inventoryPass || !(m_pendingSteps & bit)) return;
+    m_pendingSteps &= ~bit;
+    CollectorStat &stat = m_collectorStats[step];
+    ++stat.timeouts;
+    stat.stale = true;
+    NEOFETCH_LOG(Logger::Warning, QString("Collector %1 missed its %2 ms deadline; keeping its previous value")
+                 .arg(stat.name).arg(kCollectorDeadlineMs[step]));
+
+    publishInventory(std::make_shared<SystemInventory>(*latest()->inventory), m_pendingSteps == 0);
+}
+
+void SystemSampler::publishInventory(std::shared_ptr<SystemInventory> inventory, bool passFinished)
+{
+    // These are copies rather than pooled snapshots; inventory passes are
+    // rare.
+    const SystemSnapshotPtr prev = latest();
+    if (passFinished) {
+        inventory->complete = true;
+        inventory->cached = false;
+    }
+
+    auto s = std::make_shared<SystemSnapshot>(*prev);
+    s->inventory = inventory;
+    s->collectors = m_collectorStats;
+    if (passFinished) s->inventoryMicros = m_passTimer.nsecsElapsed() / 1000;
+    publish(std::move(s));
+
+    // Only a fully fresh inventory goes to disk.
+    if (inventory->complete && m_inventoryCache) {
+        for (const CollectorStat &stat : m_collectorStats)
+            if (stat.stale) return;
+        m_inventoryCache->save(*inventory, m_backend->bootId(), m_backend->hardwareFingerprint());
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef SYSTEMSAMPLER_H
+#define SYSTEMSAMPLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QVector>
+#include <memory>
+#include "SystemSnapshot.h"
+#include "SystemBackend.h"
+#include "AlertEngine.h"
+
+class MetricHistory;
+class InventoryCache;
+class TraceWriter;
+class Instrumentation;
+class QThreadPool;
+
+// Drives a SystemBackend on a dedicated worker thread. Each cycle takes a
+// snapshot from a small pool (carrying over the last published values), fills
+// it in, and swaps it into m_latest atomically; consumers pick it up with
+// latest().
+//
+// Static facts (CPU model, DIMMs, disk models, adapters, displays) are
+// gathered into a SystemInventory once and reused by every later snapshot
+// until invalidateInventory() is called, so a regular tick only reads
+// counters. An inventory pass publishes the cheap fields together with the
+// tick's metrics first. The slow collectors then run concurrently on a small
+// thread pool, and each result is published as it arrives. A collector that
+// misses its deadline leaves its previous value in place, marked stale, and
+// is not restarted until it returns, so one hung WMI query cannot hold up
+// the others or pile up threads. If a history is given, every sampled tick
+// is also appended to it.
+//
+// Each metric collector has its own interval. A tick runs every collector
+// that is due or nearly due, so collectors with compatible intervals share
+// one wakeup, and the timer is then set for the earliest next due time.
+// Intervals stretch while nobody is watching (see Demand) and further while
+// the host is idle; stretching back takes effect at once, so metrics that
+// are overdue under the shorter interval are sampled straight away. Where
+// the backend offers pressure triggers, a stall on memory or I/O samples
+// memory and pressure immediately. Every tick is checked against the alert
+// rules before it is published, whether or not anyone is watching, and
+// appended to the trace when recording.
+class SystemSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Who is looking at the snapshots.
+    enum Demand {
+        Interactive, // a window shows them
+        Background,  // no window, but something still reads them (the exporter)
+        Unobserved   // nothing reads them until demand rises again
+    };
+
+    explicit SystemSampler(std::unique_ptr<SystemBackend> backend, MetricHistory *history = nullptr, QObject *parent = nullptr);
+
+    ~SystemSampler() override;
+
+    // Loads the first inventory from, and saves every complete one to, the
+    // cache file at path. Call before start().
+    void setInventoryCachePath(const QString &path);
+
+    // Times every collector and tick into instrumentation, which must
+    // outlive the sampler. Call before start().
+    void setInstrumentation(Instrumentation *instrumentation) { m_instrumentation = instrumentation; }
+
+    // Thread-safe: may be called from any thread.
+    SystemSnapshotPtr latest() const;
+
+    // Runs one regular tick, metrics only, on the calling thread. For
+    // benchmarks; do not mix with start().
+    void sampleOnce();
+
+public slots:
+    void start();
+    void stop();
+
+    // Drops the cached inventory; it is re-collected on the next tick.
+    void invalidateInventory();
+
+    // Stretches or restores the sampling intervals.
+    void setDemand(SystemSampler::Demand demand);
+
+    // Replaces the alert rules; what was firing under the old ones clears.
+    void setAlertRules(const AlertEngine &rules);
+
+    // Appends every published snapshot to trace, an open TraceWriter, from
+    // now on; null stops recording. The sampler closes it on stop().
+    void setTraceWriter(std::shared_ptr<TraceWriter> trace);
+
+signals:
+    void snapshotPublished();
+
+private slots:
+    void fetchAllData();
+    void updateSystemData();
+    void onPressureTrigger();
+
+private:
+    std::shared_ptr<SystemSnapshot> acquireSnapshot(quint32 metrics);
+    void publish(std::shared_ptr<SystemSnapshot> snapshot);
+    SystemInventoryPtr collectQuickInventory(const SystemInventory &previous);
+    void startSlowInventory();
+    void onCollectorFinished(int step, quint64 pass, std::shared_ptr<SystemInventory> result, qint64 micros);
+    void onCollectorDeadline(int step, quint64 pass);
+    void publishInventory(std::shared_ptr<SystemInventory> inventory, bool passFinished);
+    int intervalStretch() const;
+    qint64 intervalMs(int metric) const;
+    void scheduleNext();
+    void countWakeup(qint64 nowMs);
+
+    // Published snapshot, the one the GUI still holds, and one being filled.
+    static const int kPoolSize = 3;
+    static const int kFirstCpuSampleMs = 250;
+
+    // Shared with running collector tasks, which outlive the sampler if
+    // they hang; they post results back only while sampler is set.
+    struct CollectorInbox {
+        QMutex mutex;
+        SystemSampler *sampler;
+    };
+
+    // Shared so a hung collector task keeps the backend alive.
+    std::shared_ptr<SystemBackend> m_backend;
+    MetricHistory *m_history;
+    Instrumentation *m_instrumentation;
+    std::unique_ptr<InventoryCache> m_inventoryCache;
+    bool m_inventoryCacheTried;
+    SystemSnapshotPtr m_latest;
+    QVector<std::shared_ptr<SystemSnapshot>> m_pool;
+    QTimer *m_updateTimer;
+    bool m_inventoryDirty;
+
+    // Schedule, in milliseconds on m_clock.
+    QElapsedTimer m_clock;
+    qint64 m_sampledMs[SystemBackend::MetricCount]; // last run of each metric collector
+    Demand m_demand;
+    int m_quietSamples;            // consecutive CPU samples below the idle threshold
+    qint64 m_wakeupWindowStartMs;
+    int m_wakeupsInWindow;
+    double m_wakeupsPerSecond;
+
+    QThreadPool *m_collectorPool;
+    std::shared_ptr<CollectorInbox> m_inbox;
+    quint64 m_inventoryPass;   // bumped for every inventory pass
+    quint32 m_pendingSteps;    // slow steps of this pass not yet finished or timed out
+    quint32 m_runningSteps;    // slow steps with a task still running
+    QElapsedTimer m_passTimer;
+    QVector<CollectorStat> m_collectorStats;
+    AlertEngine m_alerts;
+    std::shared_ptr<TraceWriter> m_trace;
+};
+
+#endif
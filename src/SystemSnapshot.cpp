@@ -0,0 +1,108 @@
+#include "SystemSnapshot.h"
+#include <cstring>
+
+void CpuTable::setFromTicks(int row, const quint64 *before, const quint64 *after)
+{
+    quint64 delta[StateCount];
+    quint64 sum = 0;
+    for (int i = 0; i < StateCount; ++i) {
+        // Counters can step backwards slightly when a CPU comes back online.
+        delta[i] = after[i] > before[i] ? after[i] - before[i] : 0;
+        sum += delta[i];
+    }
+    if (sum == 0) return;
+    for (int i = 0; i < StateCount; ++i) {
+        const float value = float(delta[i] * 100.0 / double(sum));
+        if (row < 0) total[i] = value;
+        else share[i][row] = value;
+    }
+}
+
+bool CpuTable::operator==(const CpuTable &o) const
+{
+    if (std::memcmp(total, o.total, sizeof(total)) != 0 || cpuId != o.cpuId) return false;
+    for (int i = 0; i < StateCount; ++i)
+        if (share[i] != o.share[i]) return false;
+    return true;
+}
+
+quint64 counterDelta(quint64 before, quint64 after, int bits)
+{
+    if (after >= before) return after - before;
+    // A 64-bit counter does not wrap within a machine's lifetime.
+    if (bits >= 64) return 0;
+    const quint64 range = Q_UINT64_C(1) << bits;
+    if (before >= range) return 0;
+    return after + range - before;
+}
+
+void NetworkTable::setFromCounters(int row, const quint64 *before, const quint64 *after, double seconds, int bits)
+{
+    for (int i = 0; i < CounterCount; ++i) {
+        total[i][row] = after[i];
+        rate[i][row] = seconds > 0 ? float(counterDelta(before[i], after[i], bits) / seconds) : 0.0f;
+    }
+}
+
+bool DiskIoTable::operator==(const DiskIoTable &o) const
+{
+    if (name != o.name || latencyMs != o.latencyMs || utilization != o.utilization) return false;
+    for (int i = 0; i < RateCount; ++i)
+        if (rate[i] != o.rate[i]) return false;
+    return true;
+}
+
+bool NetworkTable::operator==(const NetworkTable &o) const
+{
+    if (ifIndex != o.ifIndex || name != o.name) return false;
+    for (int i = 0; i < CounterCount; ++i)
+        if (total[i] != o.total[i] || rate[i] != o.rate[i]) return false;
+    return true;
+}
+
+SnapshotFields SystemSnapshot::changedFields(const SystemSnapshot &before, const SystemSnapshot &after)
+{
+    using namespace SnapshotField;
+    SnapshotFields changed;
+
+    // Most ticks reuse the inventory object, which makes this a pointer
+    // compare.
+    if (before.inventory != after.inventory) {
+        const SystemInventory &a = *before.inventory;
+        const SystemInventory &b = *after.inventory;
+        if (a.cpuInfo != b.cpuInfo) changed |= CpuInfo;
+        if (a.gpuInfo != b.gpuInfo) changed |= GpuInfo;
+        if (a.displayInfo != b.displayInfo) changed |= DisplayInfo;
+        if (a.osInfo != b.osInfo) changed |= OsInfo;
+        if (a.kernelInfo != b.kernelInfo) changed |= KernelInfo;
+        if (a.shellInfo != b.shellInfo) changed |= ShellInfo;
+        if (a.username != b.username) changed |= Username;
+        if (a.currentDir != b.currentDir) changed |= CurrentDir;
+        if (a.diskDevices != b.diskDevices || a.diskDevicesNote != b.diskDevicesNote) changed |= DiskHardwareInfo;
+        if (a.memoryModules != b.memoryModules || a.memoryModulesNote != b.memoryModulesNote) changed |= MemoryHardwareInfo;
+        if (a.networkInfo != b.networkInfo) changed |= NetworkInfo;
+    }
+
+    // Uptime is displayed with minute resolution.
+    if (before.uptimeSeconds / 60 != after.uptimeSeconds / 60 || (before.timestampMs == 0) != (after.timestampMs == 0))
+        changed |= Uptime;
+    if (before.cpuPercent != after.cpuPercent) changed |= CpuPercent;
+    if (before.cpu != after.cpu) changed |= CpuCores;
+    if (before.memoryPercent != after.memoryPercent) changed |= MemoryPercent;
+    if (before.volumes != after.volumes) changed |= DiskInfo;
+    if (before.diskIo != after.diskIo) changed |= DiskIo;
+    if (before.processes != after.processes) changed |= Processes;
+    if (before.network != after.network) changed |= NetworkTraffic;
+    if (before.memoryTotal != after.memoryTotal) changed |= MemoryTotal | MemoryInfo;
+    if (before.memoryUsed != after.memoryUsed) changed |= MemoryUsed;
+    if (before.memoryDetail != after.memoryDetail) changed |= MemoryDetail;
+    if (before.pressure != after.pressure) changed |= Pressure;
+    if (before.alerts != after.alerts) changed |= Alerts;
+    if (before.sampleMicros != after.sampleMicros || before.inventoryMicros != after.inventoryMicros
+        || before.inventory->complete != after.inventory->complete
+        || before.inventory->cached != after.inventory->cached
+        || before.collectors != after.collectors
+        || before.intervalStretch != after.intervalStretch || before.wakeupsPerSecond != after.wakeupsPerSecond)
+        changed |= SampleStats;
+    return changed;
+}
@@ -0,0 +1,397 @@
+#ifndef SYSTEMSNAPSHOT_H
+#define SYSTEMSNAPSHOT_H
+
+#include <QString>
+#include <QVector>
+#include <QFlags>
+#include <algorithm>
+#include <memory>
+
+// One bit per published field, used to tell consumers exactly what changed
+// between two snapshots.
+namespace SnapshotField {
+enum Field : quint32 {
+    CpuInfo            = 1u << 0,
+    GpuInfo            = 1u << 1,
+    DisplayInfo        = 1u << 2,
+    OsInfo             = 1u << 3,
+    KernelInfo         = 1u << 4,
+    ShellInfo          = 1u << 5,
+    Username           = 1u << 6,
+    CurrentDir         = 1u << 7,
+    DiskHardwareInfo   = 1u << 8,
+    MemoryHardwareInfo = 1u << 9,
+    NetworkInfo        = 1u << 10,
+    Uptime             = 1u << 11,
+    CpuPercent         = 1u << 12,
+    MemoryPercent      = 1u << 13,
+    DiskInfo           = 1u << 14,
+    MemoryTotal        = 1u << 15,
+    MemoryUsed         = 1u << 16,
+    MemoryInfo         = 1u << 17,
+    SampleStats        = 1u << 18,
+    CpuCores           = 1u << 19,
+    Processes          = 1u << 20,
+    NetworkTraffic     = 1u << 21,
+    DiskIo             = 1u << 22,
+    MemoryDetail       = 1u << 23,
+    Pressure           = 1u << 24,
+    Alerts             = 1u << 25,
+
+    Inventory = CpuInfo | GpuInfo | DisplayInfo | OsInfo | KernelInfo | ShellInfo | Username
+              | CurrentDir | DiskHardwareInfo | MemoryHardwareInfo | NetworkInfo,
+    All = (1u << 26) - 1
+};
+}
+Q_DECLARE_FLAGS(SnapshotFields, SnapshotField::Field)
+Q_DECLARE_OPERATORS_FOR_FLAGS(SnapshotFields)
+
+// One installed DIMM.
+struct MemoryModule
+{
+    QString manufacturer;
+    quint64 capacityBytes = 0;
+    quint32 speedMHz = 0;
+    QString partNumber;
+
+    bool operator==(const MemoryModule &o) const
+    {
+        return capacityBytes == o.capacityBytes && speedMHz == o.speedMHz
+            && manufacturer == o.manufacturer && partNumber == o.partNumber;
+    }
+    bool operator!=(const MemoryModule &o) const { return !(*this == o); }
+};
+
+// One physical disk.
+struct DiskDevice
+{
+    QString model;
+    quint64 sizeBytes = 0;
+    QString interfaceType;
+    QString serial;
+
+    bool operator==(const DiskDevice &o) const
+    {
+        return sizeBytes == o.sizeBytes && model == o.model
+            && interfaceType == o.interfaceType && serial == o.serial;
+    }
+    bool operator!=(const DiskDevice &o) const { return !(*this == o); }
+};
+
+// Static hardware and environment facts. Collected once and shared by every
+// snapshot until a hardware-change event invalidates it.
+struct SystemInventory
+{
+    QString cpuInfo = "Loading...";
+    QString gpuInfo = "Loading...";
+    QString displayInfo = "Loading...";
+    QString osInfo = "Loading...";
+    QString kernelInfo = "Loading...";
+    QString shellInfo = "Loading...";
+    QString username = "user";
+    QString currentDir = "~";
+    QString networkInfo = "Loading...";
+
+    QVector<DiskDevice> diskDevices;
+    QVector<MemoryModule> memoryModules;
+    // Shown instead of the list when it is empty, e.g. why probing failed.
+    QString diskDevicesNote = "Loading...";
+    QString memoryModulesNote = "Loading...";
+
+    // False while the slow collectors of an inventory pass are still
+    // running; their fields keep the previous (or "Loading...") values.
+    bool complete = false;
+    // Loaded from InventoryCache and not yet re-probed.
+    bool cached = false;
+};
+
+using SystemInventoryPtr = std::shared_ptr<const SystemInventory>;
+
+// Growth of a kernel counter that is bits wide between two readings. A
+// narrower counter that went down wrapped, and the distance across the wrap
+// is returned; a 64-bit counter that went down was reset (driver reload,
+// interface or device re-created), and the interval counts as 0.
+quint64 counterDelta(quint64 before, quint64 after, int bits);
+
+// Per-volume usage, stored column-wise so the numeric columns stay dense.
+// Collectors resize() the table and overwrite rows in place; once the
+// columns have grown to the number of volumes a tick does not allocate.
+struct VolumeTable
+{
+    QVector<QString> mountPoint; // drive letter or mount path
+    QVector<QString> fsType;
+    QVector<quint64> totalBytes;
+    QVector<quint64> freeBytes;
+    // Block device the volume lives on, as named in DiskIoTable: "sda1",
+    // "dm-0", or the drive itself on Windows. Empty when not backed by one.
+    QVector<QString> device;
+
+    int size() const { return mountPoint.size(); }
+    void resize(int n)
+    {
+        mountPoint.resize(n);
+        fsType.resize(n);
+        totalBytes.resize(n);
+        freeBytes.resize(n);
+        device.resize(n);
+    }
+    quint64 usedBytes(int i) const { return totalBytes[i] - freeBytes[i]; }
+    int percentUsed(int i) const { return totalBytes[i] ? int(usedBytes(i) * 100 / totalBytes[i]) : 0; }
+
+    bool operator==(const VolumeTable &o) const
+    {
+        return totalBytes == o.totalBytes && freeBytes == o.freeBytes
+            && mountPoint == o.mountPoint && fsType == o.fsType && device == o.device;
+    }
+    bool operator!=(const VolumeTable &o) const { return !(*this == o); }
+};
+
+// Where physical memory and swap go, in bytes. Fields a platform does not
+// report stay 0.
+struct MemoryBreakdown
+{
+    enum Field {
+        Available, Cached, Buffers, Shmem, Slab, SwapTotal, SwapUsed, Dirty, Writeback,
+        HugePagesTotal, HugePagesFree, FieldCount
+    };
+
+    quint64 bytes[FieldCount] = {};
+
+    bool operator==(const MemoryBreakdown &o) const { return std::equal(bytes, bytes + FieldCount, o.bytes); }
+    bool operator!=(const MemoryBreakdown &o) const { return !(*this == o); }
+};
+
+// Pressure stall information: the percentage of time in which some tasks
+// (and, for full, all non-idle tasks) were stalled waiting for a resource,
+// averaged over the last 10, 60 and 300 seconds.
+struct PressureStats
+{
+    enum Resource { Cpu, Memory, Io, ResourceCount };
+    enum Window { Avg10, Avg60, Avg300, WindowCount };
+
+    bool available = false; // the kernel reports pressure at all
+    float some[ResourceCount][WindowCount] = {};
+    float full[ResourceCount][WindowCount] = {};
+
+    bool operator==(const PressureStats &o) const
+    {
+        return available == o.available && std::equal(&some[0][0], &some[0][0] + ResourceCount * WindowCount, &o.some[0][0])
+            && std::equal(&full[0][0], &full[0][0] + ResourceCount * WindowCount, &o.full[0][0]);
+    }
+    bool operator!=(const PressureStats &o) const { return !(*this == o); }
+};
+
+// Block-device activity over the last interval, one row per device that has
+// done any I/O since boot, stored column-wise like VolumeTable. All values
+// are 0 until a device has two readings.
+struct DiskIoTable
+{
+    enum Rate { ReadBytes, WriteBytes, Reads, Writes, RateCount }; // per second
+
+    QVector<QString> name;
+    QVector<float> rate[RateCount];
+    QVector<float> latencyMs;   // mean service time of the requests completed
+    QVector<float> utilization; // percent of the interval with I/O in flight
+
+    int size() const { return name.size(); }
+    void resize(int n)
+    {
+        name.resize(n);
+        for (QVector<float> &column : rate) column.resize(n);
+        latencyMs.resize(n);
+        utilization.resize(n);
+    }
+    float iops(int i) const { return rate[Reads][i] + rate[Writes][i]; }
+    // Row for a VolumeTable::device, or -1.
+    int indexOf(const QString &device) const { return device.isEmpty() ? -1 : name.indexOf(device); }
+
+    bool operator==(const DiskIoTable &o) const;
+    bool operator!=(const DiskIoTable &o) const { return !(*this == o); }
+};
+
+// How each logical CPU spent the last sampling interval, as a percentage of
+// that interval per state, plus the same split for the whole machine. Rows
+// are stored column-wise like VolumeTable and rewritten in place each tick.
+struct CpuTable
+{
+    enum State { User, Nice, System, Idle, IoWait, Irq, SoftIrq, Steal, StateCount };
+
+    QVector<int> cpuId; // N of "cpuN" in /proc/stat, or the processor number
+    QVector<float> share[StateCount];
+    float total[StateCount] = {};
+
+    int size() const { return cpuId.size(); }
+    void resize(int n)
+    {
+        cpuId.resize(n);
+        for (QVector<float> &column : share) column.resize(n);
+    }
+    // Everything but idle and iowait; 0 until a row has two readings.
+    float busy(int i) const
+    {
+        return share[User][i] + share[Nice][i] + share[System][i] + share[Irq][i] + share[SoftIrq][i] + share[Steal][i];
+    }
+    float totalBusy() const
+    {
+        return total[User] + total[Nice] + total[System] + total[Irq] + total[SoftIrq] + total[Steal];
+    }
+
+    // Fills row (or the aggregate when row is -1) from two readings of
+    // cumulative per-state ticks. Leaves it untouched if no time passed.
+    void setFromTicks(int row, const quint64 *before, const quint64 *after);
+
+    bool operator==(const CpuTable &o) const;
+    bool operator!=(const CpuTable &o) const { return !(*this == o); }
+};
+
+// Traffic per network interface, stored column-wise like CpuTable: the
+// cumulative counters as the kernel reports them, and their rate per second
+// over the last interval. Rows are identified by interface index, which
+// survives renames and is not reused while the interface exists.
+struct NetworkTable
+{
+    enum Counter { RxBytes, TxBytes, RxPackets, TxPackets, RxErrors, TxErrors, RxDrops, TxDrops, CounterCount };
+
+    QVector<int> ifIndex;
+    QVector<QString> name;
+    QVector<quint64> total[CounterCount];
+    QVector<float> rate[CounterCount]; // 0 until a row has two readings
+
+    int size() const { return ifIndex.size(); }
+    void resize(int n)
+    {
+        ifIndex.resize(n);
+        name.resize(n);
+        for (QVector<quint64> &column : total) column.resize(n);
+        for (QVector<float> &column : rate) column.resize(n);
+    }
+
+    // Stores after as row's totals and, if seconds > 0, the rates since
+    // before; zero rates otherwise. bits is the width of the platform's
+    // counters, as for counterDelta().
+    void setFromCounters(int row, const quint64 *before, const quint64 *after, double seconds, int bits);
+
+    bool operator==(const NetworkTable &o) const;
+    bool operator!=(const NetworkTable &o) const { return !(*this == o); }
+};
+
+// The busiest processes, by CPU share and then resident memory, stored
+// column-wise like VolumeTable, plus how many processes there are in all.
+struct ProcessTable
+{
+    QVector<qint64> pid;
+    QVector<QString> name;
+    QVector<float> cpuPercent; // share of all CPUs over the last interval
+    QVector<quint64> rssBytes;
+    int total = 0;
+
+    int size() const { return pid.size(); }
+    void resize(int n)
+    {
+        pid.resize(n);
+        name.resize(n);
+        cpuPercent.resize(n);
+        rssBytes.resize(n);
+    }
+
+    bool operator==(const ProcessTable &o) const
+    {
+        return total == o.total && pid == o.pid && cpuPercent == o.cpuPercent
+            && rssBytes == o.rssBytes && name == o.name;
+    }
+    bool operator!=(const ProcessTable &o) const { return !(*this == o); }
+};
+
+// An alert rule starting or ceasing to fire.
+struct AlertEvent
+{
+    QString rule;    // the rule's name, or its text when unnamed
+    QString subject; // the volume, CPU, device, interface or process for per-row metrics
+    double value = 0; // the value that made it fire or clear
+    qint64 timestampMs = 0;
+    bool firing = false;
+
+    bool operator==(const AlertEvent &o) const
+    {
+        return value == o.value && timestampMs == o.timestampMs && firing == o.firing
+            && rule == o.rule && subject == o.subject;
+    }
+    bool operator!=(const AlertEvent &o) const { return !(*this == o); }
+};
+
+// Alerts currently firing, each as the event that set it off, in rule
+// order; and the latest transitions, oldest first. Only rewritten when a
+// rule changes state, so most snapshots share both lists.
+struct AlertTable
+{
+    QVector<AlertEvent> firing;
+    QVector<AlertEvent> recent;
+
+    bool operator==(const AlertTable &o) const { return firing == o.firing && recent == o.recent; }
+    bool operator!=(const AlertTable &o) const { return !(*this == o); }
+};
+
+// Health of one inventory collector, as shown in the Logs panel.
+struct CollectorStat
+{
+    const char *name = "";
+    qint64 lastMicros = -1; // wall time of the last finished run, -1 if none
+    quint32 timeouts = 0;   // runs that missed their deadline
+    bool stale = false;     // its fields are older than the current pass
+
+    bool operator==(const CollectorStat &o) const
+    {
+        return lastMicros == o.lastMicros && timeouts == o.timeouts && stale == o.stale && name == o.name;
+    }
+    bool operator!=(const CollectorStat &o) const { return !(*this == o); }
+};
+
+// Everything the sampler collected in one cycle. A snapshot is filled on the
+// sampler thread and then published as a pointer-to-const, so readers on the
+// GUI thread never see a half-written value. Values are raw numbers;
+// turning them into text is left to SnapshotFormat at the display edge.
+struct SystemSnapshot
+{
+    SystemInventoryPtr inventory = std::make_shared<SystemInventory>();
+
+    // Wall-clock time the sample was taken; 0 until the first sample.
+    qint64 timestampMs = 0;
+
+    quint64 uptimeSeconds = 0;
+    int cpuPercent = 0;
+    CpuTable cpu;
+    int memoryPercent = 0;
+    quint64 memoryTotal = 0;
+    quint64 memoryUsed = 0;
+    MemoryBreakdown memoryDetail;
+    PressureStats pressure;
+    VolumeTable volumes;
+    DiskIoTable diskIo;
+    ProcessTable processes;
+    NetworkTable network;
+    AlertTable alerts;
+
+    // The SystemBackend::Metric collectors (as bits) that ran for this
+    // snapshot; the fields of the others are carried over from the previous
+    // one.
+    quint32 sampledMetrics = 0;
+
+    // Cost of producing this snapshot, in microseconds. inventoryMicros is
+    // the cost of the last inventory collection, which most ticks reuse.
+    qint64 sampleMicros = 0;
+    qint64 inventoryMicros = 0;
+    QVector<CollectorStat> collectors;
+
+    // Sampler schedule when this snapshot was taken: the factor its
+    // intervals are stretched by while nobody is watching or the host is
+    // idle, and its wakeups per second over the last minute.
+    int intervalStretch = 1;
+    double wakeupsPerSecond = 0;
+
+    // Fields whose values differ between the two snapshots.
+    static SnapshotFields changedFields(const SystemSnapshot &before, const SystemSnapshot &after);
+};
+
+using SystemSnapshotPtr = std::shared_ptr<const SystemSnapshot>;
+
+#endif
@@ -0,0 +1,824 @@
+#include "WindowsBackend.h"
+#include "InventoryCache.h"
+#include <Windows.h>
+#include <shlobj.h>
+#include <iphlpapi.h>
+#include <winioctl.h>
+#include <psapi.h>
+#include <comdef.h>
+#include <Wbemidl.h>
+#include <QSettings>
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "wbemuuid.lib")
+#pragma comment(lib, "ole32.lib")
+#pragma comment(lib, "oleaut32.lib")
+
+namespace {
+// Bounds each WMI enumeration step; on timeout Next() returns no object and
+// the loop ends with what it has so far.
+const long kWmiNextTimeoutMs = 3000;
+
+// Mapped shares that take longer keep their previous figures.
+const int kRemoteFreeSpaceTimeoutMs = 100;
+
+FreeSpaceProbe::Result freeSpace(int drive)
+{
+    const wchar_t path[4] = { wchar_t(L'A' + drive), L':', L'\\', L'\0' };
+    FreeSpaceProbe::Result r;
+    ULARGE_INTEGER total, totalFree;
+    if (GetDiskFreeSpaceExW(path, nullptr, &total, &totalFree) && total.QuadPart) {
+        r.ok = true;
+        r.totalBytes = total.QuadPart;
+        r.freeBytes = totalFree.QuadPart;
+    }
+    return r;
+}
+
+// Joins the calling thread to the multithreaded COM apartment for one WMI
+// query. Collectors run on shared QThreadPool threads, so only a successful
+// CoInitializeEx (S_OK or S_FALSE) is balanced with CoUninitialize(); a
+// thread already in another apartment (RPC_E_CHANGED_MODE) can still use COM
+// but must be left as it was.
+class ComScope
+{
+public:
+    ComScope() : m_result(CoInitializeEx(nullptr, COINIT_MULTITHREADED)) {}
+    ~ComScope()
+    {
+        if (m_result == S_OK || m_result == S_FALSE) CoUninitialize();
+    }
+
+    bool usable() const { return SUCCEEDED(m_result) || m_result == RPC_E_CHANGED_MODE; }
+
+private:
+    Q_DISABLE_COPY(ComScope)
+
+    HRESULT m_result;
+};
+}
+
+WindowsBackend::~WindowsBackend()
+{
+    for (const DiskVolume &v : m_diskVolumes)
+        if (v.handle != INVALID_HANDLE_VALUE) CloseHandle(v.handle);
+}
+
+void WindowsBackend::fetchCpuInfo(SystemInventory &s)
+{
+    HKEY hKey;
+    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+        wchar_t cpuName[256];
+        DWORD size = sizeof(cpuName);
+        DWORD type;
+        if (RegQueryValueExW(hKey, L"ProcessorNameString", nullptr, &type, (LPBYTE)cpuName, &size) == ERROR_SUCCESS) {
+            s.cpuInfo = QString::fromUtf16((const ushort*)cpuName);
+        }
+        RegCloseKey(hKey);
+    } else {
+        s.cpuInfo = "Unknown CPU";
+    }
+}
+
+void WindowsBackend::fetchGpuInfo(SystemInventory &s)
+{
+    s.gpuInfo = "Generic GPU";
+}
+
+void WindowsBackend::fetchDisplayInfo(SystemInventory &s)
+{
+    // Use EnumDisplayMonitors + GetMonitorInfo to reliably get monitor device name,
+    // then query EnumDisplayDevices and EnumDisplaySettings for brand/string and resolution.
+    QStringList displays;
+
+    struct Ctx { QStringList* out; } ctx{ &displays };
+
+    auto enumProc = [](HMONITOR hMon, HDC, LPRECT, LPARAM lParam) -> BOOL {
+        QStringList* out = reinterpret_cast<Ctx*>(lParam)->out;
+        MONITORINFOEXW mi;
+        ZeroMemory(&mi, sizeof(mi));
+        mi.cbSize = sizeof(mi);
+        if (!GetMonitorInfoW(hMon, &mi)) return TRUE;
+
+        // Try to get a friendly name via EnumDisplayDevices
+        DISPLAY_DEVICEW dev;
+        ZeroMemory(&dev, sizeof(dev));
+        dev.cb = sizeof(dev);
+        QString friendly;
+        if (EnumDisplayDevicesW(mi.szDevice, 0, &dev, 0)) {
+            friendly = QString::fromWCharArray(dev.DeviceString).trimmed();
+        }
+
+        DEVMODEW dm;
+        ZeroMemory(&dm, sizeof(dm));
+        dm.dmSize = sizeof(dm);
+        if (EnumDisplaySettingsW(mi.szDevice, ENUM_CURRENT_SETTINGS, &dm)) {
+            QString name = friendly.isEmpty() ? QString::fromWCharArray(mi.szDevice) : friendly;
+            QString res = QString("%1x%2").arg(dm.dmPelsWidth).arg(dm.dmPelsHeight);
+            out->append(QString("%1 - %2").arg(name).arg(res));
+        }
+        return TRUE;
+    };
+
+    EnumDisplayMonitors(nullptr, nullptr, (MONITORENUMPROC)enumProc, (LPARAM)&ctx);
+
+    if (displays.isEmpty()) s.displayInfo = "Unknown";
+    else s.displayInfo = displays.join('\n');
+}
+
+void WindowsBackend::fetchOsInfo(SystemInventory &s)
+{
+    QSettings reg("HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion", QSettings::NativeFormat);
+    s.osInfo = reg.value("ProductName", "Windows").toString();
+}
+
+void WindowsBackend::fetchKernelInfo(SystemInventory &s)
+{
+    s.kernelInfo = "NT 10.0";
+}
+
+void WindowsBackend::fetchShellInfo(SystemInventory &s)
+{
+    s.shellInfo = "PowerShell";
+}
+
+QByteArray WindowsBackend::bootId()
+{
+    // Windows 10 and later count boots here.
+    HKEY hKey;
+    DWORD bootCount = 0;
+    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\Session Manager\\Memory Management\\PrefetchParameters", 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+        DWORD size = sizeof(bootCount);
+        DWORD type;
+        if (RegQueryValueExW(hKey, L"BootId", nullptr, &type, (LPBYTE)&bootCount, &size) != ERROR_SUCCESS || type != REG_DWORD)
+            bootCount = 0;
+        RegCloseKey(hKey);
+    }
+    if (bootCount) return QByteArray("boot-") + QByteArray::number(quint64(bootCount));
+
+    // Otherwise the boot time, rounded so that timer drift between two
+    // reads does not change it.
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    const ULONGLONG nowMs = (((ULONGLONG)now.dwHighDateTime << 32) | now.dwLowDateTime) / 10000;
+    return QByteArray("time-") + QByteArray::number((nowMs - GetTickCount64()) / 60000);
+}
+
+quint64 WindowsBackend::hardwareFingerprint()
+{
+    // Values Windows keeps at hand: no WMI, no device enumeration.
+    MEMORYSTATUSEX memInfo;
+    memInfo.dwLength = sizeof(memInfo);
+    GlobalMemoryStatusEx(&memInfo);
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+
+    const quint64 values[] = {
+        GetLogicalDrives(),
+        memInfo.ullTotalPhys,
+        sysInfo.dwNumberOfProcessors,
+        quint64(GetSystemMetrics(SM_CMONITORS)),
+        quint64(GetSystemMetrics(SM_CXVIRTUALSCREEN)),
+        quint64(GetSystemMetrics(SM_CYVIRTUALSCREEN)),
+    };
+    return InventoryCache::hash(values, sizeof(values));
+}
+
+void WindowsBackend::fetchUptime(SystemSnapshot &s)
+{
+    s.uptimeSeconds = GetTickCount64() / 1000;
+}
+
+void WindowsBackend::fetchUserInfo(SystemInventory &s)
+{
+    wchar_t name[256];
+    DWORD size = sizeof(name);
+    if (GetUserNameW(name, &size)) {
+        s.username = QString::fromUtf16((const ushort*)name);
+    }
+    
+    wchar_t path[MAX_PATH];
+    if (SHGetFolderPathW(NULL, CSIDL_PROFILE, NULL, 0, path) == S_OK) {
+        s.currentDir = QString::fromUtf16((const ushort*)path);
+    } else {
+        s.currentDir = "";
+    }
+}
+
+void WindowsBackend::fetchDiskInfo(SystemSnapshot &s)
+{
+    // GetLogicalDrives() is a single cheap call. Drive type and filesystem
+    // do not change while a letter stays assigned, so they are queried when
+    // it appears; a tick only refreshes the free space.
+    const DWORD drives = GetLogicalDrives();
+    VolumeTable &v = s.volumes;
+    int n = 0;
+
+    for (int i = 0; i < 26; i++) {
+        Drive &d = m_drives[i];
+        if (!(drives & (1 << i))) {
+            if (d.present) d = Drive();
+            continue;
+        }
+        const wchar_t path[4] = { wchar_t(L'A' + i), L':', L'\\', L'\0' };
+        if (!d.present) {
+            d.present = true;
+            d.remote = GetDriveTypeW(path) == DRIVE_REMOTE;
+            // Asking a share for its filesystem can hang as long as asking
+            // for its size.
+            if (d.remote) d.fsType = QStringLiteral("Network");
+        }
+        // Retried until it answers: a card reader has no filesystem until a
+        // card goes in.
+        wchar_t fsName[MAX_PATH + 1];
+        if (d.fsType.isEmpty() && GetVolumeInformationW(path, nullptr, 0, nullptr, nullptr, nullptr, fsName, MAX_PATH + 1))
+            d.fsType = QString::fromWCharArray(fsName);
+
+        if (d.remote) {
+            // An unreachable server keeps the last figures.
+            FreeSpaceProbe::Result r;
+            if (d.probe.run([i]() { return freeSpace(i); }, kRemoteFreeSpaceTimeoutMs, r)) {
+                d.totalBytes = r.totalBytes;
+                d.freeBytes = r.freeBytes;
+            }
+        } else {
+            const FreeSpaceProbe::Result r = freeSpace(i);
+            d.totalBytes = r.totalBytes;
+            d.freeBytes = r.freeBytes;
+        }
+        if (d.totalBytes == 0) continue;
+
+        if (v.size() <= n) v.resize(n + 1);
+        const char drive[3] = { char('A' + i), ':', '\0' };
+        if (v.mountPoint[n] != QLatin1String(drive)) v.mountPoint[n] = QLatin1String(drive);
+        if (v.fsType[n] != d.fsType) v.fsType[n] = d.fsType;
+        // fetchDiskIo() reports per drive letter.
+        if (v.device[n] != v.mountPoint[n]) v.device[n] = v.mountPoint[n];
+        v.totalBytes[n] = d.totalBytes;
+        v.freeBytes[n] = d.freeBytes;
+        ++n;
+    }
+    v.resize(n);
+}
+
+void WindowsBackend::fetchCpuUsage(SystemSnapshot &s)
+{
+    // SystemProcessorPerformanceInformation: one entry per logical processor
+    // in the calling thread's processor group. KernelTime includes idle,
+    // DPC and interrupt time.
+    struct ProcessorTimes {
+        LARGE_INTEGER idleTime;
+        LARGE_INTEGER kernelTime;
+        LARGE_INTEGER userTime;
+        LARGE_INTEGER dpcTime;
+        LARGE_INTEGER interruptTime;
+        ULONG interruptCount;
+    };
+    typedef LONG (WINAPI *NtQuerySystemInformationFn)(int, PVOID, ULONG, PULONG);
+    static const NtQuerySystemInformationFn query = reinterpret_cast<NtQuerySystemInformationFn>(
+        GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtQuerySystemInformation"));
+    if (!query) return;
+
+    if (m_cpuBuffer.empty()) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        m_cpuBuffer.resize(size_t(info.dwNumberOfProcessors) * sizeof(ProcessorTimes));
+    }
+    ULONG returned = 0;
+    if (query(8, m_cpuBuffer.data(), ULONG(m_cpuBuffer.size()), &returned) < 0) return;
+
+    const ProcessorTimes *times = reinterpret_cast<const ProcessorTimes *>(m_cpuBuffer.data());
+    const int rows = int(returned / sizeof(ProcessorTimes));
+    const int stride = CpuTable::StateCount;
+    if (m_prevCpuTicks.size() < size_t(rows + 1) * stride) m_prevCpuTicks.resize(size_t(rows + 1) * stride, 0);
+
+    CpuTable &cpu = s.cpu;
+    cpu.resize(rows);
+    quint64 sum[CpuTable::StateCount] = {};
+    for (int row = 0; row < rows; ++row) {
+        const ProcessorTimes &t = times[row];
+        const quint64 idle = quint64(t.idleTime.QuadPart);
+        const quint64 dpc = quint64(t.dpcTime.QuadPart);
+        const quint64 interrupt = quint64(t.interruptTime.QuadPart);
+        const quint64 kernel = quint64(t.kernelTime.QuadPart);
+        const quint64 overhead = idle + dpc + interrupt;
+
+        quint64 ticks[CpuTable::StateCount] = {};
+        ticks[CpuTable::User] = quint64(t.userTime.QuadPart);
+        ticks[CpuTable::System] = kernel > overhead ? kernel - overhead : 0;
+        ticks[CpuTable::Idle] = idle;
+        ticks[CpuTable::Irq] = interrupt;
+        ticks[CpuTable::SoftIrq] = dpc;
+        for (int i = 0; i < stride; ++i) sum[i] += ticks[i];
+
+        quint64 *prev = m_prevCpuTicks.data() + size_t(row + 1) * stride;
+        cpu.cpuId[row] = row;
+        if (prev[CpuTable::Idle] != 0) cpu.setFromTicks(row, prev, ticks);
+        else for (QVector<float> &column : cpu.share) column[row] = 0.0f;
+        std::copy(ticks, ticks + stride, prev);
+    }
+
+    quint64 *prevSum = m_prevCpuTicks.data();
+    if (prevSum[CpuTable::Idle] != 0) cpu.setFromTicks(-1, prevSum, sum);
+    std::copy(sum, sum + stride, prevSum);
+    s.cpuPercent = int(cpu.totalBusy());
+}
+
+void WindowsBackend::fetchMemoryUsage(SystemSnapshot &s)
+{
+    MEMORYSTATUSEX memInfo;
+    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+    if (GlobalMemoryStatusEx(&memInfo)) {
+        s.memoryTotal = memInfo.ullTotalPhys;
+        ULONGLONG availMem = memInfo.ullAvailPhys;
+        s.memoryUsed = s.memoryTotal - availMem;
+        s.memoryPercent = (int)((s.memoryUsed * 100) / s.memoryTotal);
+        s.memoryDetail.bytes[MemoryBreakdown::Available] = availMem;
+    }
+
+    // The file cache and the kernel pools are the nearest Windows has to
+    // Cached and Slab. The page file is left out: its usage is not reported
+    // apart from the commit charge.
+    PERFORMANCE_INFORMATION perf;
+    perf.cb = sizeof(perf);
+    if (GetPerformanceInfo(&perf, sizeof(perf))) {
+        s.memoryDetail.bytes[MemoryBreakdown::Cached] = quint64(perf.SystemCache) * perf.PageSize;
+        s.memoryDetail.bytes[MemoryBreakdown::Slab] = quint64(perf.KernelTotal) * perf.PageSize;
+    }
+}
+
+void WindowsBackend::fetchPressure(SystemSnapshot &s)
+{
+    // No pressure stall accounting on Windows.
+    s.pressure = PressureStats();
+}
+
+void WindowsBackend::fetchProcesses(SystemSnapshot &s)
+{
+    // SystemProcessInformation returns every process with its times and
+    // working set in one call, instead of opening each process.
+    struct UnicodeString {
+        USHORT length;
+        USHORT maximumLength;
+        PWSTR buffer;
+    };
+    struct ProcessInformation {
+        ULONG nextEntryOffset;
+        ULONG numberOfThreads;
+        LARGE_INTEGER workingSetPrivateSize;
+        ULONG hardFaultCount;
+        ULONG numberOfThreadsHighWatermark;
+        ULONGLONG cycleTime;
+        LARGE_INTEGER createTime;
+        LARGE_INTEGER userTime;
+        LARGE_INTEGER kernelTime;
+        UnicodeString imageName;
+        LONG basePriority;
+        HANDLE uniqueProcessId;
+        HANDLE inheritedFromUniqueProcessId;
+        ULONG handleCount;
+        ULONG sessionId;
+        ULONG_PTR uniqueProcessKey;
+        SIZE_T peakVirtualSize;
+        SIZE_T virtualSize;
+        ULONG pageFaultCount;
+        SIZE_T peakWorkingSetSize;
+        SIZE_T workingSetSize;
+    };
+    const LONG statusInfoLengthMismatch = LONG(0xC0000004);
+    typedef LONG (WINAPI *NtQuerySystemInformationFn)(int, PVOID, ULONG, PULONG);
+    static const NtQuerySystemInformationFn query = reinterpret_cast<NtQuerySystemInformationFn>(
+        GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtQuerySystemInformation"));
+    if (!query) return;
+
+    if (m_processBuffer.empty()) m_processBuffer.resize(256 * 1024);
+    ULONG returned = 0;
+    LONG status;
+    while ((status = query(5, m_processBuffer.data(), ULONG(m_processBuffer.size()), &returned)) == statusInfoLengthMismatch)
+        m_processBuffer.resize(std::max<size_t>(returned, m_processBuffer.size()) + 64 * 1024);
+    if (status < 0) return;
+
+    m_processes.begin(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    for (size_t offset = 0;;) {
+        const ProcessInformation &info = *reinterpret_cast<const ProcessInformation *>(m_processBuffer.data() + offset);
+        const qint64 pid = qint64(reinterpret_cast<quintptr>(info.uniqueProcessId));
+        // Pid 0 is the idle process, whose "CPU time" is idle time.
+        if (pid != 0) {
+            ProcessTracker::Entry &e = m_processes.add(pid, quint64(info.createTime.QuadPart));
+            e.cpuTime = quint64(info.userTime.QuadPart) + quint64(info.kernelTime.QuadPart);
+            e.rssBytes = info.workingSetSize;
+            if (e.name.isEmpty() && info.imageName.buffer)
+                e.name = QString::fromWCharArray(info.imageName.buffer, info.imageName.length / sizeof(WCHAR));
+        }
+        if (!info.nextEntryOffset) break;
+        offset += info.nextEntryOffset;
+    }
+
+    // Shares are of the whole machine, like cpuPercent; process times are
+    // in 100 ns units.
+    int cpuCount = int(m_prevCpuTicks.size() / CpuTable::StateCount) - 1;
+    if (cpuCount < 1) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        cpuCount = int(info.dwNumberOfProcessors);
+    }
+    m_processes.finish(1e7, cpuCount, processLimit(), s.processes);
+}
+
+void WindowsBackend::fetchDiskHardwareInfo(SystemInventory &s)
+{
+    s.diskDevices.clear();
+    s.diskDevicesNote.clear();
+    
+    // 初始化 COM
+    ComScope com;
+    if (!com.usable()) {
+        s.diskDevicesNote = "WMI init failed";
+        return;
+    }
+    
+    // 设置安全级别
+    HRESULT hres = CoInitializeSecurity(
+        nullptr, -1, nullptr, nullptr,
+        RPC_C_AUTHN_LEVEL_DEFAULT,
+        RPC_C_IMP_LEVEL_IMPERSONATE,
+        nullptr, EOAC_NONE, nullptr
+    );
+    
+    IWbemLocator* pLoc = nullptr;
+    hres = CoCreateInstance(CLSID_WbemLocator, nullptr, CLSCTX_INPROC_SERVER,
+                            IID_IWbemLocator, (LPVOID*)&pLoc);
+    
+    if (SUCCEEDED(hres)) {
+        IWbemServices* pSvc = nullptr;
+        BSTR wmiNamespace = SysAllocString(L"ROOT\\CIMV2");
+        hres = pLoc->ConnectServer(
+            wmiNamespace,
+            nullptr, nullptr, nullptr, 0, nullptr, nullptr, &pSvc
+        );
+        SysFreeString(wmiNamespace);
+        
+        if (SUCCEEDED(hres)) {
+            // 设置安全
+            hres = CoSetProxyBlanket(
+                pSvc,
+                RPC_C_AUTHN_WINNT,
+                RPC_C_AUTHZ_NONE,
+                nullptr,
+                RPC_C_AUTHN_LEVEL_CALL,
+                RPC_C_IMP_LEVEL_IMPERSONATE,
+                nullptr,
+                EOAC_NONE
+            );
+            
+            if (SUCCEEDED(hres)) {
+                IEnumWbemClassObject* pEnumerator = nullptr;
+                BSTR query = SysAllocString(L"SELECT * FROM Win32_DiskDrive");
+                BSTR wql = SysAllocString(L"WQL");
+                hres = pSvc->ExecQuery(
+                    wql,
+                    query,
+                    WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
+                    nullptr,
+                    &pEnumerator
+                );
+                SysFreeString(query);
+                SysFreeString(wql);
+                
+                if (SUCCEEDED(hres)) {
+                    IWbemClassObject* pclsObj = nullptr;
+                    ULONG uReturn = 0;
+                    QVector<DiskDevice> disks;
+                    
+                    while (pEnumerator) {
+                        HRESULT hr = pEnumerator->Next(kWmiNextTimeoutMs, 1, &pclsObj, &uReturn);
+                        if (uReturn == 0) break;
+                        
+                        VARIANT vtProp;
+                        
+                        // 获取型号
+                        DiskDevice disk;
+                        hr = pclsObj->Get(L"Model", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) disk.model = QString::fromWCharArray(vtProp.bstrVal);
+                        VariantClear(&vtProp);
+                        
+                        // 获取大小
+                        hr = pclsObj->Get(L"Size", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) {
+                            bool ok;
+                            qint64 bytes = QString::fromWCharArray(vtProp.bstrVal).toLongLong(&ok);
+                            if (ok && bytes > 0) disk.sizeBytes = quint64(bytes);
+                        }
+                        VariantClear(&vtProp);
+                        
+                        // 获取接口类型
+                        hr = pclsObj->Get(L"InterfaceType", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) disk.interfaceType = QString::fromWCharArray(vtProp.bstrVal);
+                        VariantClear(&vtProp);
+                        
+                        // 获取序列号
+                        hr = pclsObj->Get(L"SerialNumber", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) disk.serial = QString::fromWCharArray(vtProp.bstrVal).trimmed();
+                        VariantClear(&vtProp);
+                        
+                        disks.append(disk);
+                        
+                        pclsObj->Release();
+                    }
+                    
+                    s.diskDevices = disks;
+                    if (disks.isEmpty()) s.diskDevicesNote = "No disks found";
+                    
+                    pEnumerator->Release();
+                }
+                pSvc->Release();
+            }
+        }
+        pLoc->Release();
+    }
+}
+
+void WindowsBackend::fetchMemoryHardwareInfo(SystemInventory &s)
+{
+    s.memoryModules.clear();
+    s.memoryModulesNote.clear();
+
+    ComScope com;
+    if (!com.usable()) {
+        s.memoryModulesNote = "WMI init failed";
+        return;
+    }
+
+    HRESULT hres = CoInitializeSecurity(
+        nullptr, -1, nullptr, nullptr,
+        RPC_C_AUTHN_LEVEL_DEFAULT,
+        RPC_C_IMP_LEVEL_IMPERSONATE,
+        nullptr, EOAC_NONE, nullptr
+    );
+
+    IWbemLocator* pLoc = nullptr;
+    hres = CoCreateInstance(CLSID_WbemLocator, nullptr, CLSCTX_INPROC_SERVER,
+                            IID_IWbemLocator, (LPVOID*)&pLoc);
+
+    if (SUCCEEDED(hres)) {
+        IWbemServices* pSvc = nullptr;
+        BSTR wmiNamespace = SysAllocString(L"ROOT\\CIMV2");
+        hres = pLoc->ConnectServer(
+            wmiNamespace,
+            nullptr, nullptr, nullptr, 0, nullptr, nullptr, &pSvc
+        );
+        SysFreeString(wmiNamespace);
+
+        if (SUCCEEDED(hres)) {
+            hres = CoSetProxyBlanket(
+                pSvc,
+                RPC_C_AUTHN_WINNT,
+                RPC_C_AUTHZ_NONE,
+                nullptr,
+                RPC_C_AUTHN_LEVEL_CALL,
+                RPC_C_IMP_LEVEL_IMPERSONATE,
+                nullptr,
+                EOAC_NONE
+            );
+
+            if (SUCCEEDED(hres)) {
+                IEnumWbemClassObject* pEnumerator = nullptr;
+                BSTR query = SysAllocString(L"SELECT Manufacturer, Capacity, Speed, PartNumber FROM Win32_PhysicalMemory");
+                BSTR wql = SysAllocString(L"WQL");
+                hres = pSvc->ExecQuery(
+                    wql,
+                    query,
+                    WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
+                    nullptr,
+                    &pEnumerator
+                );
+                SysFreeString(query);
+                SysFreeString(wql);
+
+                if (SUCCEEDED(hres)) {
+                    IWbemClassObject* pclsObj = nullptr;
+                    ULONG uReturn = 0;
+                    QVector<MemoryModule> modules;
+
+                    while (pEnumerator) {
+                        HRESULT hr = pEnumerator->Next(kWmiNextTimeoutMs, 1, &pclsObj, &uReturn);
+                        if (uReturn == 0) break;
+
+                        VARIANT vtProp;
+
+                        MemoryModule module;
+
+                        // Manufacturer
+                        hr = pclsObj->Get(L"Manufacturer", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) module.manufacturer = QString::fromWCharArray(vtProp.bstrVal).trimmed();
+                        VariantClear(&vtProp);
+
+                        // Capacity
+                        hr = pclsObj->Get(L"Capacity", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) {
+                            bool ok;
+                            quint64 bytes = QString::fromWCharArray(vtProp.bstrVal).toULongLong(&ok);
+                            if (ok) module.capacityBytes = bytes;
+                        } else if (vtProp.vt == VT_UI8) {
+                            module.capacityBytes = vtProp.ullVal;
+                        }
+                        VariantClear(&vtProp);
+
+                        // Speed
+                        hr = pclsObj->Get(L"Speed", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) module.speedMHz = QString::fromWCharArray(vtProp.bstrVal).toUInt();
+                        else if (vtProp.vt != VT_NULL && vtProp.vt != VT_EMPTY) module.speedMHz = vtProp.uintVal;
+                        VariantClear(&vtProp);
+
+                        // PartNumber
+                        hr = pclsObj->Get(L"PartNumber", 0, &vtProp, nullptr, nullptr);
+                        if (vtProp.vt == VT_BSTR) module.partNumber = QString::fromWCharArray(vtProp.bstrVal).trimmed();
+                        VariantClear(&vtProp);
+
+                        modules.append(module);
+
+                        pclsObj->Release();
+                    }
+
+                    s.memoryModules = modules;
+                    if (modules.isEmpty()) s.memoryModulesNote = "No memory modules found";
+
+                    pEnumerator->Release();
+                }
+                pSvc->Release();
+            }
+        }
+        pLoc->Release();
+    }
+}
+
+void WindowsBackend::fetchNetworkInfo(SystemInventory &s)
+{
+    // 获取网络适配器信息；适配器可能在两次调用之间增加，缓冲区不够时按新的大小重试
+    ULONG bufferSize = 0;
+    DWORD result = GetAdaptersInfo(nullptr, &bufferSize);
+    if (result == ERROR_NO_DATA || bufferSize == 0) {
+        s.networkInfo = "No adapters";
+        return;
+    }
+    std::vector<char> buffer;
+    do {
+        buffer.resize(bufferSize);
+        result = GetAdaptersInfo(reinterpret_cast<IP_ADAPTER_INFO*>(buffer.data()), &bufferSize);
+    } while (result == ERROR_BUFFER_OVERFLOW);
+
+    if (result == ERROR_SUCCESS) {
+        QStringList adapters;
+        for (IP_ADAPTER_INFO* adapter = reinterpret_cast<IP_ADAPTER_INFO*>(buffer.data()); adapter; adapter = adapter->Next) {
+            if (adapter->Type == MIB_IF_TYPE_ETHERNET || adapter->Type == IF_TYPE_IEEE80211) {
+                QString name = QString::fromLocal8Bit(adapter->Description);
+                if (!name.isEmpty()) {
+                    adapters.append(name);
+                }
+            }
+        }
+        s.networkInfo = adapters.isEmpty() ? "No adapters" : adapters.join(", ");
+    } else if (result == ERROR_NO_DATA) {
+        s.networkInfo = "No adapters";
+    } else {
+        s.networkInfo = "Unknown";
+    }
+}
+
+void WindowsBackend::fetchNetworkUsage(SystemSnapshot &s)
+{
+    PMIB_IF_TABLE2 table = nullptr;
+    if (GetIfTable2Ex(MibIfTableNormal, &table) != NO_ERROR) return;
+    const qint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const double seconds = m_netReadNs ? (now - m_netReadNs) / 1e9 : 0.0;
+    m_netReadNs = now;
+    for (NetInterface &i : m_netInterfaces) i.seen = false;
+
+    NetworkTable &net = s.network;
+    int rows = 0;
+    for (ULONG k = 0; k < table->NumEntries; ++k) {
+        const MIB_IF_ROW2 &row = table->Table[k];
+        // Every NIC also shows up as filter and miniport layers; only the
+        // hardware row carries its own traffic.
+        if (!row.InterfaceAndOperStatusFlags.HardwareInterface || row.Type == IF_TYPE_SOFTWARE_LOOPBACK) continue;
+
+        quint64 counters[NetworkTable::CounterCount];
+        counters[NetworkTable::RxBytes] = row.InOctets;
+        counters[NetworkTable::TxBytes] = row.OutOctets;
+        counters[NetworkTable::RxPackets] = row.InUcastPkts + row.InNUcastPkts;
+        counters[NetworkTable::TxPackets] = row.OutUcastPkts + row.OutNUcastPkts;
+        counters[NetworkTable::RxErrors] = row.InErrors;
+        counters[NetworkTable::TxErrors] = row.OutErrors;
+        counters[NetworkTable::RxDrops] = row.InDiscards;
+        counters[NetworkTable::TxDrops] = row.OutDiscards;
+
+        // The table keeps its order between calls, so try the same row first.
+        NetInterface *iface = nullptr;
+        if (size_t(rows) < m_netInterfaces.size() && m_netInterfaces[size_t(rows)].ifIndex == row.InterfaceIndex)
+            iface = &m_netInterfaces[size_t(rows)];
+        for (size_t i = 0; !iface && i < m_netInterfaces.size(); ++i)
+            if (m_netInterfaces[i].ifIndex == row.InterfaceIndex) iface = &m_netInterfaces[i];
+        const bool hasBaseline = iface != nullptr;
+        if (!iface) {
+            m_netInterfaces.emplace_back();
+            iface = &m_netInterfaces.back();
+            iface->ifIndex = row.InterfaceIndex;
+        }
+        // Aliases can be renamed by the user; comparing is cheaper than
+        // converting every tick.
+        if (iface->name.compare(QString::fromWCharArray(row.Alias)) != 0) iface->name = QString::fromWCharArray(row.Alias);
+
+        if (rows >= net.size()) net.resize(rows + 1);
+        net.ifIndex[rows] = int(iface->ifIndex);
+        net.name[rows] = iface->name;
+        // MIB_IF_ROW2 counters are ULONG64.
+        net.setFromCounters(rows, iface->counters, counters, hasBaseline ? seconds : 0.0, 64);
+        std::copy(counters, counters + NetworkTable::CounterCount, iface->counters);
+        iface->seen = true;
+        ++rows;
+    }
+    net.resize(rows);
+    FreeMibTable(table);
+
+    m_netInterfaces.erase(std::remove_if(m_netInterfaces.begin(), m_netInterfaces.end(),
+                                         [](const NetInterface &i) { return !i.seen; }), m_netInterfaces.end());
+}
+
+void WindowsBackend::fetchDiskIo(SystemSnapshot &s)
+{
+    const DWORD drives = GetLogicalDrives();
+    for (DiskVolume &v : m_diskVolumes) v.seen = false;
+
+    DiskIoTable &io = s.diskIo;
+    int rows = 0;
+    for (int i = 0; i < 26; ++i) {
+        if (!(drives & (1 << i))) continue;
+        DiskVolume *vol = nullptr;
+        for (DiskVolume &v : m_diskVolumes)
+            if (v.drive == i) vol = &v;
+        if (!vol) {
+            m_diskVolumes.emplace_back();
+            vol = &m_diskVolumes.back();
+            vol->drive = i;
+            vol->handle = INVALID_HANDLE_VALUE;
+            // Fixed drives only: opening a card reader or an optical drive
+            // can spin it up. The IOCTL needs no access rights.
+            const wchar_t root[4] = { wchar_t(L'A' + i), L':', L'\\', L'\0' };
+            if (GetDriveTypeW(root) == DRIVE_FIXED) {
+                const wchar_t device[7] = { L'\\', L'\\', L'.', L'\\', wchar_t(L'A' + i), L':', L'\0' };
+                vol->handle = CreateFileW(device, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+            }
+        }
+        vol->seen = true;
+
+        DISK_PERFORMANCE perf;
+        DWORD returned = 0;
+        if (vol->handle == INVALID_HANDLE_VALUE
+            || !DeviceIoControl(vol->handle, IOCTL_DISK_PERFORMANCE, nullptr, 0, &perf, sizeof(perf), &returned, nullptr))
+            continue;
+        const quint64 counters[DiskVolume::CounterCount] = {
+            quint64(perf.BytesRead.QuadPart), quint64(perf.BytesWritten.QuadPart), perf.ReadCount, perf.WriteCount,
+            quint64(perf.ReadTime.QuadPart), quint64(perf.WriteTime.QuadPart), quint64(perf.IdleTime.QuadPart),
+            quint64(perf.QueryTime.QuadPart)
+        };
+
+        if (rows >= io.size()) io.resize(rows + 1);
+        const char drive[3] = { char('A' + i), ':', '\0' };
+        if (io.name[rows] != QLatin1String(drive)) io.name[rows] = QLatin1String(drive);
+        // ReadCount and WriteCount are DWORDs, the rest LARGE_INTEGERs.
+        static const int bits[DiskVolume::CounterCount] = { 64, 64, 32, 32, 64, 64, 64, 64 };
+        quint64 d[DiskVolume::CounterCount];
+        for (int c = 0; c < DiskVolume::CounterCount; ++c) d[c] = vol->hasReading ? counterDelta(vol->counters[c], counters[c], bits[c]) : 0;
+        const double seconds = d[DiskVolume::QueryTime] / 1e7;
+        if (seconds > 0) {
+            const quint64 completed = d[DiskVolume::Reads] + d[DiskVolume::Writes];
+            io.rate[DiskIoTable::ReadBytes][rows] = float(d[DiskVolume::BytesRead] / seconds);
+            io.rate[DiskIoTable::WriteBytes][rows] = float(d[DiskVolume::BytesWritten] / seconds);
+            io.rate[DiskIoTable::Reads][rows] = float(d[DiskVolume::Reads] / seconds);
+            io.rate[DiskIoTable::Writes][rows] = float(d[DiskVolume::Writes] / seconds);
+            io.latencyMs[rows] = completed ? float((d[DiskVolume::ReadTime] + d[DiskVolume::WriteTime]) / 1e4 / completed) : 0.0f;
+            io.utilization[rows] = float(qBound(0.0, 100.0 * (1.0 - double(d[DiskVolume::IdleTime]) / d[DiskVolume::QueryTime]), 100.0));
+        } else {
+            for (QVector<float> &column : io.rate) column[rows] = 0;
+            io.latencyMs[rows] = 0;
+            io.utilization[rows] = 0;
+        }
+        std::copy(counters, counters + DiskVolume::CounterCount, vol->counters);
+        vol->hasReading = true;
+        ++rows;
+    }
+    io.resize(rows);
+
+    // Drives that were removed; a drive letter that comes back is opened
+    // again.
+    for (DiskVolume &v : m_diskVolumes)
+        if (!v.seen && v.handle != INVALID_HANDLE_VALUE) CloseHandle(v.handle);
+    m_diskVolumes.erase(std::remove_if(m_diskVolumes.begin(), m_diskVolumes.end(),
+                                       [](const DiskVolume &v) { return !v.seen; }), m_diskVolumes.end());
+}
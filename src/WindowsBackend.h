@@ -0,0 +1,81 @@
+#ifndef WINDOWSBACKEND_H
+#define WINDOWSBACKEND_H
+
+#include <QByteArray>
+#include "SystemBackend.h"
+#include "FreeSpaceProbe.h"
+#include "ProcessTracker.h"
+#include <vector>
+
+// Registry, Win32 and WMI based collectors.
+class WindowsBackend : public SystemBackend
+{
+public:
+    ~WindowsBackend() override;
+
+    void fetchCpuInfo(SystemInventory &s) override;
+    void fetchGpuInfo(SystemInventory &s) override;
+    void fetchDisplayInfo(SystemInventory &s) override;
+    void fetchOsInfo(SystemInventory &s) override;
+    void fetchKernelInfo(SystemInventory &s) override;
+    void fetchShellInfo(SystemInventory &s) override;
+    void fetchUserInfo(SystemInventory &s) override;
+    void fetchDiskHardwareInfo(SystemInventory &s) override;
+    void fetchMemoryHardwareInfo(SystemInventory &s) override;
+    void fetchNetworkInfo(SystemInventory &s) override;
+
+    QByteArray bootId() override;
+    quint64 hardwareFingerprint() override;
+
+    void fetchUptime(SystemSnapshot &s) override;
+    void fetchDiskInfo(SystemSnapshot &s) override;
+    void fetchCpuUsage(SystemSnapshot &s) override;
+    void fetchMemoryUsage(SystemSnapshot &s) override;
+    void fetchProcesses(SystemSnapshot &s) override;
+    void fetchNetworkUsage(SystemSnapshot &s) override;
+    void fetchDiskIo(SystemSnapshot &s) override;
+    void fetchPressure(SystemSnapshot &s) override;
+
+private:
+    // What is known about a drive letter while it stays assigned.
+    struct Drive {
+        bool present = false;
+        bool remote = false;     // mapped share, queried through probe
+        QString fsType;          // empty until GetVolumeInformationW answers
+        FreeSpaceProbe probe;
+        quint64 totalBytes = 0;  // last figures; kept while a share hangs
+        quint64 freeBytes = 0;
+    };
+
+    // A drive letter, its volume handle and its DISK_PERFORMANCE counters
+    // at the last reading. Times are in 100 ns units.
+    struct DiskVolume {
+        enum Counter { BytesRead, BytesWritten, Reads, Writes, ReadTime, WriteTime, IdleTime, QueryTime, CounterCount };
+        int drive;       // 0 for A:
+        void *handle;    // INVALID_HANDLE_VALUE if the drive is not queried
+        quint64 counters[CounterCount];
+        bool hasReading;
+        bool seen;
+    };
+
+    // An interface from GetIfTable2 and its counters at the last reading.
+    struct NetInterface {
+        quint32 ifIndex;
+        QString name;
+        quint64 counters[NetworkTable::CounterCount];
+        bool seen;
+    };
+
+    Drive m_drives[26];
+    // Per-processor times from the last tick, the machine-wide sum first.
+    std::vector<quint64> m_prevCpuTicks;
+    std::vector<char> m_cpuBuffer;
+    // SystemProcessInformation output, grown until the whole list fits.
+    std::vector<char> m_processBuffer;
+    ProcessTracker m_processes;
+    std::vector<NetInterface> m_netInterfaces;
+    qint64 m_netReadNs = 0;
+    std::vector<DiskVolume> m_diskVolumes;
+};
+
+#endif
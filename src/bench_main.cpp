@@ -0,0 +1,163 @@
+#include <QApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QVBoxLayout>
+#include <cstdio>
+#include "Benchmark.h"
+#include "KeyedLabelRows.h"
+#include "SystemBackend.h"
+#include "SystemDataProvider.h"
+#include "mainwindow.h"
+
+// benchmarks：逐个测量采集函数、完整采集周期、采样器一次 tick、导出、快照录制/回放、界面刷新和
+// 磁盘列表行复用的耗时、分配次数和 read 系统调用次数，输出 Google Benchmark 布局的 JSON。
+// 配合 --fixture 使用仓库中的 benchmarks/fixture，结果与本机状态无关，可在 CI 中比较；
+// 默认使用 offscreen 平台，可在无显示器的 Linux 上运行。
+
+namespace {
+
+void printUsage()
+{
+    std::fputs("Usage: benchmarks [--fixture <dir>] [--min-time <ms>] [--out <file>]\n"
+               "  --fixture   read a captured /proc and /sys tree instead of the live system (Linux)\n"
+               "  --min-time  minimum measuring time per benchmark, default 200 ms\n"
+               "  --out       write the JSON to a file instead of stdout\n",
+               stdout);
+}
+
+// 界面刷新：不启动采集线程，用两份固定快照交替喂给界面，测量 updateData() 及重绘的耗时与分配次数
+void runUi(BenchmarkRunner &runner, SystemBackend &backend)
+{
+    // 两份快照的每个指标字段都不同，每次切换的工作量相当于一次繁忙的采样周期
+    auto inventory = std::make_shared<SystemInventory>();
+    backend.collectInventory(*inventory);
+    auto a = std::make_shared<SystemSnapshot>();
+    a->inventory = inventory;
+    a->timestampMs = QDateTime::currentMSecsSinceEpoch();
+    backend.collectMetrics(*a);
+    backend.collectMetrics(*a);
+    auto b = std::make_shared<SystemSnapshot>(*a);
+    b->timestampMs += 5000;
+    b->uptimeSeconds += 60;
+    b->cpuPercent = (a->cpuPercent + 37) % 101;
+    b->memoryPercent = (a->memoryPercent + 11) % 101;
+    b->memoryUsed = a->memoryUsed / 2;
+    for (int i = 0; i < b->cpu.size(); ++i) b->cpu.share[CpuTable::User][i] += 0.25f;
+    b->cpu.total[CpuTable::User] += 0.25f;
+    for (int i = 0; i < b->volumes.size(); ++i) b->volumes.freeBytes[i] /= 2;
+
+    SystemDataProvider data(SystemDataProvider::Manual);
+    data.applySnapshot(a);
+    MainWindow window(&data);
+    window.createAllPanels();
+    window.show();
+    QCoreApplication::processEvents();
+
+    bool flip = false;
+    runner.run("ui/applySnapshot", [&]() { data.applySnapshot((flip = !flip) ? b : a); });
+    runner.run("ui/applySnapshot+render", [&]() {
+        data.applySnapshot((flip = !flip) ? b : a);
+        window.grab();
+    });
+    runner.run("ui/render", [&]() { window.grab(); });
+}
+
+// 磁盘列表的行复用：合成 64 个分区，分别测量内容不变、每行文字都变（剩余空间刷新）、
+// 以及每次增删 8 行（挂载/卸载）时 KeyedLabelRows::reconcile() 的开销；updates 为每次改动的控件数
+void runDiskRows(BenchmarkRunner &runner)
+{
+    const int kVolumes = 64;
+    const int kChurn = 8;
+    QVector<KeyedLabelRows::Row> rows, refreshed, churned;
+    for (int i = 0; i < kVolumes; ++i) {
+        const QString key = QString("/mnt/volume%1").arg(i);
+        rows.append({ key, QString("%1  ext4  %2 GiB / 931 GiB").arg(key).arg(i) });
+        refreshed.append({ key, QString("%1  ext4  %2 GiB / 931 GiB").arg(key).arg(i + 1) });
+        churned.append(i < kChurn ? KeyedLabelRows::Row{ key + "-new", rows[i].text } : rows[i]);
+    }
+
+    QWidget panel;
+    QVBoxLayout *layout = new QVBoxLayout(&panel);
+    KeyedLabelRows diskRows(layout, []() {
+        QLabel *label = new QLabel;
+        label->setFont(QFont("Consolas", 10));
+        label->setStyleSheet("color: #F9E2AF;");
+        return label;
+    });
+    panel.show();
+    diskRows.reconcile(rows);
+    QCoreApplication::processEvents();
+
+    bool flip = false;
+    int updates = 0;
+    int calls = 0;
+    auto measure = [&](const QString &name, const QVector<KeyedLabelRows::Row> &other) {
+        updates = calls = 0;
+        runner.run(name, [&]() {
+            updates += diskRows.reconcile((flip = !flip) ? other : rows);
+            ++calls;
+        });
+        runner.addCounter("updates", double(updates) / calls);
+        diskRows.reconcile(rows);
+    };
+    measure("ui/diskRows64/unchanged", rows);
+    measure("ui/diskRows64/retext", refreshed);
+    measure("ui/diskRows64/addRemove8", churned);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QByteArray fixture;
+    qint64 minTimeMs = 200;
+    QString outPath;
+    const QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); ++i) {
+        const bool hasValue = i + 1 < args.size();
+        if (args[i] == "--fixture" && hasValue) {
+            fixture = QFile::encodeName(args[++i]);
+        } else if (args[i] == "--min-time" && hasValue) {
+            minTimeMs = args[++i].toLongLong();
+        } else if (args[i] == "--out" && hasValue) {
+            outPath = args[++i];
+        } else {
+            printUsage();
+            return args[i] == "--help" || args[i] == "-h" ? 0 : 2;
+        }
+    }
+
+    auto createBackend = [&fixture]() {
+        return fixture.isEmpty() ? SystemBackend::create() : SystemBackend::create(fixture);
+    };
+    std::unique_ptr<SystemBackend> backend = createBackend();
+    if (!backend) {
+        std::fputs("--fixture is not supported on this platform\n", stderr);
+        return 2;
+    }
+
+    BenchmarkRunner runner(minTimeMs);
+    Benchmarks::runCollectors(runner, *backend);
+    Benchmarks::runSampler(runner, createBackend());
+    Benchmarks::runTrace(runner);
+    runUi(runner, *createBackend());
+    runDiskRows(runner);
+
+    QVector<QPair<QString, QString>> context;
+    context.append(qMakePair(QString("fixture"), QString::fromLocal8Bit(fixture)));
+    context.append(qMakePair(QString("platform"), QGuiApplication::platformName()));
+    const QByteArray json = runner.toJson("benchmarks", context);
+    if (outPath.isEmpty()) {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stdout);
+        return 0;
+    }
+    QFile out(outPath);
+    if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+        std::fprintf(stderr, "cannot write %s\n", qPrintable(outPath));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,302 @@
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QSysInfo>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "AlertEngine.h"
+#include "Instrumentation.h"
+#include "InventoryCache.h"
+#include "OpenMetrics.h"
+#include "SnapshotFormat.h"
+#include "SnapshotJson.h"
+#include "SystemBackend.h"
+#include "SystemSnapshot.h"
+
+// neofetch-cli：只依赖 QtCore 的命令行版本，采集一次、打印摘要后立即退出。
+// 不创建 QCoreApplication、不启动采集线程和日志线程，保证在 SSH、登录脚本、cron 中也能快速输出。
+
+namespace {
+
+const int kStatsTicks = 20;
+const int kStatsIntervalMs = 50;
+// Gap between the two /proc/stat (or NtQuerySystemInformation) readings
+// --openmetrics needs for CPU usage; the GUI's first tick uses the same.
+const int kCpuSampleMs = 250;
+const int kDefaultTopProcesses = 10;
+// Exit status when an --alerts rule fires; 2 is taken by usage errors.
+const int kAlertExitCode = 3;
+// Collectors that report a rate or share over the interval since their
+// previous reading, and so need two readings.
+const quint32 kRateMetrics = (1u << SystemBackend::CpuMetric) | (1u << SystemBackend::ProcessMetric)
+                           | (1u << SystemBackend::NetworkMetric) | (1u << SystemBackend::DiskIoMetric);
+
+void printUsage()
+{
+    std::fputs("Usage: neofetch-cli [--hardware] [--no-cache] [--time] [--stats] [--openmetrics] [--top [N]] [--alerts <file>]\n"
+               "       neofetch-cli --json | --watch <interval> [--fields <list>] [--top [N]] [--hardware] [--no-cache]\n"
+               "  --hardware  also list disk models and memory modules (slow unless cached: WMI / SMBIOS)\n"
+               "  --no-cache  ignore the inventory cache and probe everything\n"
+               "  --time      print the time to first output on stderr\n"
+               "  --openmetrics  print the snapshot in OpenMetrics text format instead of the summary\n"
+               "  --stats     after the summary, sample a few more ticks and print per-collector latency\n"
+               "  --top       append the N (default 10) busiest processes by CPU, then memory\n"
+               "  --alerts    check the snapshot against alert rules, print what fires on stderr and\n"
+               "              exit with 3 if anything does; 'for' durations and cooldowns do not apply\n"
+               "  --json      print the snapshot as one line of JSON instead of the summary\n"
+               "  --watch     print one line of JSON per sample, every interval (e.g. 1s, 250ms, 0.5),\n"
+               "              until interrupted or stdout is closed\n"
+               "  --fields    comma-separated JSON keys to include, default all: system, uptime, cpu,\n"
+               "              memory, pressure, volumes, diskIo, network, processes; collectors for\n"
+               "              the others do not run\n",
+               stdout);
+}
+
+// A cache the GUI (or an earlier --hardware run) wrote during this boot
+// has everything, including the hardware details; only the cheap fields
+// are re-read. On a miss with --hardware, probe and refresh the cache.
+std::shared_ptr<SystemInventory> loadInventory(SystemBackend &backend, bool useCache, bool hardware, Instrumentation *instrumentation)
+{
+    const InventoryCache cache(useCache ? InventoryCache::defaultPath() : QString());
+    std::shared_ptr<SystemInventory> inventory = cache.load(backend.bootId(), backend.hardwareFingerprint());
+    if (inventory) {
+        ProbeTimer probe(instrumentation, Instrumentation::QuickInventory);
+        backend.collectQuickInventory(*inventory);
+        if (!hardware) {
+            inventory->diskDevices.clear();
+            inventory->memoryModules.clear();
+        }
+    } else {
+        inventory = std::make_shared<SystemInventory>();
+        backend.collectInventory(*inventory, hardware ? SystemBackend::FullInventory : SystemBackend::QuickInventory,
+                                 instrumentation);
+        if (hardware) cache.save(*inventory, backend.bootId(), backend.hardwareFingerprint());
+    }
+    return inventory;
+}
+
+// "250ms", "1s" or bare seconds ("0.5"); 0 if malformed.
+qint64 parseInterval(const char *text)
+{
+    char *end = nullptr;
+    const double value = std::strtod(text, &end);
+    double scale = 1000;
+    if (std::strcmp(end, "ms") == 0) scale = 1;
+    else if (*end && std::strcmp(end, "s") != 0) return 0;
+    return value > 0 ? qMax(qint64(1), qint64(value * scale)) : 0;
+}
+
+// JSON 模式：--json 输出一行，--watch 按间隔持续输出（NDJSON，每次采样一行），只运行所选字段需要的采集函数。
+// 每行直接从快照写入复用的缓冲区，逐行 flush，管道另一端可以实时读取。
+int runJson(quint32 fields, qint64 watchMs, int topProcesses, bool useCache, bool hardware)
+{
+    std::unique_ptr<SystemBackend> backend = SystemBackend::create();
+    SystemSnapshot snapshot;
+    if (fields & SnapshotJson::System) snapshot.inventory = loadInventory(*backend, useCache, hardware, nullptr);
+    if (topProcesses > 0) backend->setProcessLimit(topProcesses);
+    const quint32 metrics = SnapshotJson::metricsFor(fields);
+
+    QByteArray line;
+    auto emitLine = [&]() {
+        snapshot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        SnapshotJson::render(snapshot, fields, line);
+        return std::fwrite(line.constData(), 1, size_t(line.size()), stdout) == size_t(line.size()) && std::fflush(stdout) == 0;
+    };
+
+    backend->collectMetrics(snapshot, nullptr, metrics);
+    if (!watchMs) {
+        if (metrics & kRateMetrics) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kCpuSampleMs));
+            backend->collectMetrics(snapshot, nullptr, metrics & kRateMetrics);
+        }
+        return emitLine() ? 0 : 1;
+    }
+
+    // Fixed-rate schedule: a slow sample or write shortens the next wait
+    // instead of shifting every later sample; after a stall of more than an
+    // interval the schedule restarts from now rather than catching up.
+    const std::chrono::milliseconds interval(watchMs);
+    auto next = std::chrono::steady_clock::now();
+    for (;;) {
+        next += interval;
+        const auto now = std::chrono::steady_clock::now();
+        if (next < now - interval) next = now;
+        std::this_thread::sleep_until(next);
+        backend->collectMetrics(snapshot, nullptr, metrics);
+        if (!emitLine()) return 0;
+    }
+}
+
+void appendLine(QString &out, const char *label, const QString &value)
+{
+    out += QLatin1String(label);
+    out += QLatin1String(": ");
+    out += value;
+    out += QLatin1Char('\n');
+}
+
+QString summary(const SystemSnapshot &s)
+{
+    const SystemInventory &inv = *s.inventory;
+    QString out;
+    const QString title = QString("%1@%2").arg(inv.username, QSysInfo::machineHostName());
+    out += title + '\n' + QString(title.size(), '-') + '\n';
+
+    appendLine(out, "OS", inv.osInfo);
+    appendLine(out, "Kernel", inv.kernelInfo);
+    appendLine(out, "Uptime", SnapshotFormat::uptime(s));
+    appendLine(out, "Shell", inv.shellInfo);
+    appendLine(out, "CPU", inv.cpuInfo);
+    appendLine(out, "GPU", inv.gpuInfo);
+    appendLine(out, "Display", inv.displayInfo);
+    if (s.memoryTotal) {
+        appendLine(out, "Memory", QString("%1 GiB / %2 GiB (%3%)")
+                   .arg(SnapshotFormat::gib(s.memoryUsed), SnapshotFormat::gib(s.memoryTotal))
+                   .arg(s.memoryPercent));
+    }
+    for (int i = 0; i < s.volumes.size(); ++i)
+        appendLine(out, "Disk", SnapshotFormat::volume(s.volumes, i));
+    appendLine(out, "Network", inv.networkInfo);
+
+    for (const DiskDevice &d : inv.diskDevices) appendLine(out, "Disk device", SnapshotFormat::diskDevice(d));
+    for (const MemoryModule &m : inv.memoryModules) appendLine(out, "Memory module", SnapshotFormat::memoryModule(m));
+
+    const ProcessTable &p = s.processes;
+    if (p.size()) {
+        out += QString("\nTop %1 of %2 processes:\n").arg(p.size()).arg(p.total);
+        out += SnapshotFormat::processHeader() + '\n';
+        for (int i = 0; i < p.size(); ++i) out += SnapshotFormat::process(p, i) + '\n';
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QElapsedTimer startup;
+    startup.start();
+
+    bool hardware = false;
+    bool useCache = true;
+    bool timing = false;
+    bool stats = false;
+    bool openMetrics = false;
+    int topProcesses = 0;
+    const char *alertsPath = nullptr;
+    bool json = false;
+    qint64 watchMs = 0;
+    quint32 jsonFields = SnapshotJson::AllFields;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--hardware") == 0) {
+            hardware = true;
+        } else if (std::strcmp(argv[i], "--no-cache") == 0) {
+            useCache = false;
+        } else if (std::strcmp(argv[i], "--time") == 0) {
+            timing = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (std::strcmp(argv[i], "--openmetrics") == 0) {
+            openMetrics = true;
+        } else if (std::strcmp(argv[i], "--alerts") == 0 && hasValue) {
+            alertsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "--watch") == 0 && hasValue) {
+            watchMs = parseInterval(argv[++i]);
+            if (!watchMs) {
+                std::fprintf(stderr, "--watch: bad interval '%s'\n", argv[i]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--fields") == 0 && hasValue) {
+            QString error;
+            if (!SnapshotJson::parseFields(QString::fromLocal8Bit(argv[++i]), &jsonFields, &error)) {
+                std::fprintf(stderr, "--fields: %s\n", error.toLocal8Bit().constData());
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--top") == 0) {
+            topProcesses = kDefaultTopProcesses;
+            if (hasValue && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') topProcesses = std::atoi(argv[++i]);
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0 ? 0 : 2;
+        }
+    }
+    if (json || watchMs) return runJson(jsonFields, watchMs, topProcesses, useCache, hardware);
+
+    AlertEngine alerts;
+    if (alertsPath) {
+        QFile rules(QFile::decodeName(alertsPath));
+        QString error;
+        if (!rules.open(QIODevice::ReadOnly | QIODevice::Text)) error = rules.errorString();
+        else alerts.setRules(QString::fromUtf8(rules.readAll()), &error);
+        if (!error.isEmpty()) {
+            std::fprintf(stderr, "%s: %s\n", alertsPath, error.toLocal8Bit().constData());
+            return 2;
+        }
+        alerts.setInstantaneous(true);
+    }
+
+    std::unique_ptr<SystemBackend> backend = SystemBackend::create();
+    std::unique_ptr<Instrumentation> instrumentation(stats ? new Instrumentation : nullptr);
+    SystemSnapshot snapshot;
+
+    snapshot.inventory = loadInventory(*backend, useCache, hardware, instrumentation.get());
+    snapshot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    // CPU usage and network rates need two readings some time apart, so the
+    // summary skips them; a metrics export, a process ranking or an alert
+    // check is worth the wait. Alert rules may look at the busiest process,
+    // so they need at least one.
+    const bool checkAlerts = alerts.ruleCount() > 0;
+    if (openMetrics || topProcesses > 0 || checkAlerts) {
+        const bool processes = topProcesses > 0 || checkAlerts;
+        backend->setProcessLimit(checkAlerts ? qMax(topProcesses, 1) : topProcesses);
+        for (int reading = 0; reading < 2; ++reading) {
+            if (reading) std::this_thread::sleep_for(std::chrono::milliseconds(kCpuSampleMs));
+            backend->fetchCpuUsage(snapshot);
+            if (processes) backend->fetchProcesses(snapshot);
+            if (openMetrics || checkAlerts) backend->fetchNetworkUsage(snapshot);
+            if (checkAlerts) backend->fetchDiskIo(snapshot);
+        }
+    }
+    backend->fetchUptime(snapshot);
+    backend->fetchMemoryUsage(snapshot);
+    backend->fetchDiskInfo(snapshot);
+    int exitCode = 0;
+    if (checkAlerts) {
+        backend->fetchPressure(snapshot);
+        alerts.evaluate(snapshot);
+        snapshot.alerts = alerts.table();
+        for (const AlertEvent &e : snapshot.alerts.firing)
+            std::fprintf(stderr, "%s\n", SnapshotFormat::alertEvent(e).toLocal8Bit().constData());
+        if (!snapshot.alerts.firing.isEmpty()) exitCode = kAlertExitCode;
+        if (topProcesses == 0) snapshot.processes.resize(0);
+    }
+
+    QByteArray text;
+    if (openMetrics) OpenMetrics::render(snapshot, text);
+    else text = summary(snapshot).toLocal8Bit();
+    std::fwrite(text.constData(), 1, size_t(text.size()), stdout);
+    std::fflush(stdout);
+
+    if (timing) std::fprintf(stderr, "startup: %.2f ms\n", startup.nsecsElapsed() / 1e6);
+
+    // 统计模式：输出摘要后再连续采集若干次（与 GUI 的采样路径相同），打印各采集函数的延迟分布
+    if (instrumentation) {
+        for (int tick = 0; tick < kStatsTicks; ++tick) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kStatsIntervalMs));
+            backend->collectMetrics(snapshot, instrumentation.get());
+        }
+        const QByteArray report = ("\nCollector latency (" + QString::number(kStatsTicks) + " ticks):\n"
+                                   + SnapshotFormat::instrumentation(*instrumentation)).toLocal8Bit();
+        std::fwrite(report.constData(), 1, size_t(report.size()), stdout);
+    }
+    return exitCode;
+}
@@ -2,29 +2,112 @@
 #include <QMessageBox>
 #include <QDebug>
 #include <QIcon>
+#include <QStandardPaths>
+#include <QElapsedTimer>
+#include <QFile>
+#include <cstdio>
+#include "Logger.h"
+#include "MetricsExporter.h"
 #include "SystemDataProvider.h"
 #include "mainwindow.h"
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
     QApplication app(argc, argv);
+
+    // 日志写入临时目录，由后台线程批量落盘；级别可通过 NEOFETCH_LOG_LEVEL 调整
+    Logger &logger = Logger::instance();
+    logger.setLevel(Logger::levelFromString(qEnvironmentVariable("NEOFETCH_LOG_LEVEL"), Logger::Info));
+    logger.start(QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/neofetch.log");
+    logger.installMessageHandler();
     
     // 设置应用程序图标（从资源文件加载）
     app.setWindowIcon(QIcon(":/logo.ico"));
     
     qDebug() << "Starting NeoFetch Pro...";
     
-    SystemDataProvider systemData;
+    // 回放：--replay <文件> [--speed <倍速>] [--replay-from <秒>]，不启动采集线程，
+    // 把录制的快照按原来的间隔（除以倍速）依次送入界面
+    QString replayPath;
+    const int replayArg = app.arguments().indexOf("--replay");
+    if (replayArg > 0 && replayArg + 1 < app.arguments().size()) replayPath = app.arguments().at(replayArg + 1);
+    double replaySpeed = 1.0;
+    const int speedArg = app.arguments().indexOf("--speed");
+    if (speedArg > 0 && speedArg + 1 < app.arguments().size()) replaySpeed = app.arguments().at(speedArg + 1).toDouble();
+    qint64 replayFromMs = 0;
+    const int fromArg = app.arguments().indexOf("--replay-from");
+    if (fromArg > 0 && fromArg + 1 < app.arguments().size()) replayFromMs = qint64(app.arguments().at(fromArg + 1).toDouble() * 1000);
+
+    SystemDataProvider systemData(replayPath.isEmpty() ? SystemDataProvider::Live : SystemDataProvider::Manual);
     qDebug() << "SystemDataProvider created";
+
+    // 录制：--record <文件> 或环境变量 NEOFETCH_RECORD，把每次发布的快照追加到紧凑的二进制轨迹文件
+    // （格式见 SnapshotTrace.h），最多每秒一条，每分钟写盘一次
+    QString recordPath = qEnvironmentVariable("NEOFETCH_RECORD");
+    const int recordArg = app.arguments().indexOf("--record");
+    if (recordArg > 0 && recordArg + 1 < app.arguments().size()) recordPath = app.arguments().at(recordArg + 1);
+    if (!recordPath.isEmpty() && replayPath.isEmpty()) {
+        QString error;
+        if (!systemData.startRecording(recordPath, &error)) qWarning() << "Recording to" << recordPath << "not started:" << error;
+    }
+
+    // OpenMetrics 导出：--metrics-port <端口> 或环境变量 NEOFETCH_METRICS_PORT，只监听 127.0.0.1，
+    // 供 Prometheus 抓取 http://127.0.0.1:<端口>/metrics；在独立线程中响应，不阻塞采集和界面
+    quint16 metricsPort = quint16(qEnvironmentVariableIntValue("NEOFETCH_METRICS_PORT"));
+    const int portArg = app.arguments().indexOf("--metrics-port");
+    if (portArg > 0 && portArg + 1 < app.arguments().size()) metricsPort = quint16(app.arguments().at(portArg + 1).toUInt());
+    std::unique_ptr<MetricsExporter> exporter;
+    if (metricsPort) {
+        exporter.reset(new MetricsExporter([&systemData]() { return systemData.latestPublished(); }));
+        // 导出器在运行时，窗口隐藏后采样只适度放慢，而不是几乎停止
+        systemData.setExternalConsumer(exporter->start(metricsPort));
+    }
     
+    // 告警规则：--alerts <文件> 或环境变量 NEOFETCH_ALERTS，每行一条规则（语法见 AlertEngine.h），
+    // 在采集线程中对每次采样求值；触发的告警显示在仪表盘和日志面板，并写入日志文件
+    QString alertsPath = qEnvironmentVariable("NEOFETCH_ALERTS");
+    const int alertsArg = app.arguments().indexOf("--alerts");
+    if (alertsArg > 0 && alertsArg + 1 < app.arguments().size()) alertsPath = app.arguments().at(alertsArg + 1);
+    if (!alertsPath.isEmpty()) {
+        QFile rules(alertsPath);
+        QString error;
+        if (!rules.open(QIODevice::ReadOnly | QIODevice::Text)) error = rules.errorString();
+        else systemData.setAlertRules(QString::fromUtf8(rules.readAll()), &error);
+        if (!error.isEmpty()) qWarning() << "Alert rules" << alertsPath << "not loaded:" << error;
+    }
+
     MainWindow window(&systemData);
+    window.setStartupClock(startup);
     qDebug() << "MainWindow created";
     
     // 窗口图标（可选，因为应用程序图标已设置）
     window.setWindowIcon(QIcon(":/logo.ico"));
     window.show();
     qDebug() << "Window shown";
+
+    if (!replayPath.isEmpty()) {
+        QString error;
+        if (!systemData.startReplay(replayPath, replaySpeed, replayFromMs, &error)) {
+            QMessageBox::critical(&window, "NeoFetch Pro", QString("Cannot replay %1: %2").arg(replayPath, error));
+            logger.stop();
+            return 1;
+        }
+        QObject::connect(&systemData, &SystemDataProvider::replayFinished, []() { qDebug() << "Replay finished"; });
+    }
     
+    // 启动耗时测量：窗口第一次显示完整数据后输出各阶段耗时并退出（scripts/startup-bench.ps1 使用）
+    if (app.arguments().contains("--startup-time")) {
+        QObject::connect(&window, &MainWindow::startupMeasured, &app, [&](double firstPaintMs, double firstSampleMs, double completeMs) {
+            std::fprintf(stderr, "startup: %.2f ms (first paint %.2f ms, first sample %.2f ms)\n", completeMs, firstPaintMs, firstSampleMs);
+            app.quit();
+        });
+    }
+
     qDebug() << "Entering exec...";
-    return app.exec();
+    int rc = app.exec();
+    logger.stop();
+    return rc;
 }
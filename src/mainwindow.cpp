@@ -1,10 +1,8 @@
 #include "mainwindow.h"
+#include "Logger.h"
+#include "SnapshotFormat.h"
 #include <QDebug>
-#include <QStandardPaths>
-#include <QFile>
-#include <QTextStream>
-#include <QDateTime>
-#include <Windows.h>
+#include <QTimer>
 
 // Helper: create a styled QLabel
 QLabel* MainWindow::makeLabel(const QString& text, int fontSize, const QString& color, bool bold, QWidget* parent) {
@@ -16,31 +14,20 @@ QLabel* MainWindow::makeLabel(const QString& text, int fontSize, const QString&
     return lbl;
 }
 
-// Helper: clear and delete all items/widgets in a layout
-void MainWindow::clearLayout(QLayout* layout) {
-    if (!layout) return;
-    while (layout->count()) {
-        QLayoutItem* item = layout->takeAt(0);
-        if (!item) continue;
-        if (item->widget()) {
-            delete item->widget();
-        } else if (item->layout()) {
-            clearLayout(item->layout());
-        }
-        delete item;
-    }
-}
-
 MainWindow::MainWindow(SystemDataProvider* data, QWidget *parent)
     : QWidget(parent), m_data(data), m_dragging(false), m_selectedMenu(0),
-      lblUsername(nullptr), lblOs(nullptr), lblCpuPercent(nullptr), lblMemoryPercent(nullptr),
+      lblUsername(nullptr), lblOs(nullptr), lblCpuPercent(nullptr), lblMemoryPercent(nullptr), lblAlerts(nullptr),
       diskLayout(nullptr), hardwareDiskLayout(nullptr), lblCpuInfo(nullptr), lblGpuInfo(nullptr),
-      lblDisplayInfo(nullptr), lblMemoryInfo(nullptr), lblNetworkInfo(nullptr), lblSoftwareOs(nullptr),
-      lblKernelInfo(nullptr), lblShellInfo(nullptr), lblUptime(nullptr), logsEdit(nullptr),
-      contentStack(nullptr), dashboardPanel(nullptr), hardwarePanel(nullptr), softwarePanel(nullptr), logsPanel(nullptr)
+      lblDisplayInfo(nullptr), lblMemoryInfo(nullptr), lblMemoryHardware(nullptr), lblMemoryDetail(nullptr), lblPressure(nullptr), lblNetworkInfo(nullptr), lblSoftwareOs(nullptr),
+      lblKernelInfo(nullptr), lblShellInfo(nullptr), lblUptime(nullptr), lblProcessCount(nullptr), lblLogStats(nullptr), logsEdit(nullptr),
+      contentStack(nullptr), dashboardPanel(nullptr), hardwarePanel(nullptr), softwarePanel(nullptr), processesPanel(nullptr), logsPanel(nullptr),
+      m_cycleUpdates(0), m_lastCycleUpdates(0), m_totalUpdates(0), m_cycles(0),
+      m_firstPaintNs(-1), m_firstSampleNs(-1), m_completeNs(-1), m_startupReported(false)
 {
+    m_startupClock.start();
     setupUI();
     connect(m_data, &SystemDataProvider::dataChanged, this, &MainWindow::updateData);
+    updateData(SnapshotField::All);
     qDebug() << "MainWindow created";
 }
 
@@ -64,6 +51,21 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event) {
     m_dragging = false;
 }
 
+void MainWindow::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    m_data->setViewVisible(!isMinimized());
+}
+
+void MainWindow::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    m_data->setViewVisible(false);
+}
+
+void MainWindow::changeEvent(QEvent *event) {
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) m_data->setViewVisible(isVisible() && !isMinimized());
+}
+
 bool MainWindow::eventFilter(QObject *obj, QEvent *event) {
     if (event->type() == QEvent::MouseButtonPress || event->type() == QEvent::MouseButtonRelease) {
         QLabel* label = qobject_cast<QLabel*>(obj);
@@ -85,7 +87,44 @@ void MainWindow::selectMenu(int index) {
         else
             menuLabels[i]->setStyleSheet("color: #6C7086; padding: 8px;");
     }
-    if (contentStack) contentStack->setCurrentIndex(index);
+    if (contentStack) contentStack->setCurrentWidget(ensurePanel(index));
+    // Not refreshed while hidden; catch up now rather than at the next tick.
+    if (logsPanelVisible()) refreshLogStats();
+}
+
+QWidget* MainWindow::ensurePanel(int index) {
+    QWidget** panel = nullptr;
+    switch (index) {
+    case 1: panel = &hardwarePanel; break;
+    case 2: panel = &softwarePanel; break;
+    case 3: panel = &processesPanel; break;
+    case 4: panel = &logsPanel; break;
+    default: return dashboardPanel;
+    }
+    if (*panel) return *panel;
+
+    switch (index) {
+    case 1: *panel = createHardwarePanel(); break;
+    case 2: *panel = createSoftwarePanel(); break;
+    case 3: *panel = createProcessesPanel(); break;
+    default: *panel = createLogsPanel(); break;
+    }
+    contentStack->addWidget(*panel);
+    // The new widgets start empty; fill them from the current snapshot.
+    updateData(SnapshotField::All);
+    return *panel;
+}
+
+void MainWindow::createAllPanels() {
+    for (int index = 1; index <= 4; ++index) ensurePanel(index);
+}
+
+void MainWindow::paintEvent(QPaintEvent *event) {
+    QWidget::paintEvent(event);
+    if (m_firstPaintNs >= 0) return;
+    m_firstPaintNs = m_startupClock.nsecsElapsed();
+    // Report from the event loop rather than from inside the paint.
+    QTimer::singleShot(0, this, &MainWindow::reportStartup);
 }
 
 void MainWindow::setupUI() {
@@ -135,9 +174,9 @@ QWidget* MainWindow::createSidebar() {
     line->setStyleSheet("color: #1E1E28;");
     layout->addWidget(line);
 
-    QString menuItems[] = {"Dashboard","Hardware","Software","Logs"};
+    QString menuItems[] = {"Dashboard","Hardware","Software","Processes","Logs"};
     menuLabels.clear();
-    for (int i=0;i<4;++i) {
+    for (int i=0;i<5;++i) {
         QLabel* menu = makeLabel(menuItems[i], 11, "#CDD6F4", false, side);
         menu->setStyleSheet(menu->styleSheet() + " padding: 8px;");
         menu->setCursor(Qt::PointingHandCursor);
@@ -170,15 +209,10 @@ QWidget* MainWindow::createContent() {
     contentStack = new QStackedWidget(content);
     contentStack->setStyleSheet("background-color: transparent;");
 
+    // Only the dashboard is built up front; the other panels are created by
+    // ensurePanel() when first selected.
     dashboardPanel = createDashboardPanel();
-    hardwarePanel = createHardwarePanel();
-    softwarePanel = createSoftwarePanel();
-    logsPanel = createLogsPanel();
-
     contentStack->addWidget(dashboardPanel);
-    contentStack->addWidget(hardwarePanel);
-    contentStack->addWidget(softwarePanel);
-    contentStack->addWidget(logsPanel);
 
     layout->addWidget(contentStack);
     return content;
@@ -238,12 +272,20 @@ QWidget* MainWindow::createDashboardPanel() {
 
     lblMemoryPercent = makeLabel(QString(), 11, "#F5C2E7", false, card);
     cardLayout->addWidget(lblMemoryPercent);
+
+    // Only shown while an alert rule is firing.
+    lblAlerts = makeLabel(QString(), 11, "#F38BA8", true, card);
+    lblAlerts->setWordWrap(true);
+    lblAlerts->hide();
+    cardLayout->addSpacing(4);
+    cardLayout->addWidget(lblAlerts);
     cardLayout->addSpacing(8);
 
     QFrame* line4 = new QFrame(card); line4->setFrameShape(QFrame::HLine); line4->setStyleSheet("color: #1E1E28;"); cardLayout->addWidget(line4);
     cardLayout->addSpacing(8);
 
     diskLayout = new QVBoxLayout(); diskLayout->setSpacing(2); cardLayout->addLayout(diskLayout);
+    diskRows.reset(new KeyedLabelRows(diskLayout, [this]() { return makeLabel(QString(), 10, "#F9E2AF", false, nullptr); }));
     cardLayout->addSpacing(8);
 
     lblUptime = makeLabel(QString(), 10, "#6C7086", false, card);
@@ -272,12 +314,21 @@ QWidget* MainWindow::createHardwarePanel() {
     lblDisplayInfo = makeLabel(QString(), 11, "#CDD6F4", false, card); infoLayout->addWidget(lblDisplayInfo);
     lblMemoryInfo = makeLabel(QString(), 11, "#CDD6F4", false, card); infoLayout->addWidget(lblMemoryInfo);
     lblMemoryHardware = makeLabel(QString(), 11, "#CDD6F4", false, card); infoLayout->addWidget(lblMemoryHardware);
+    lblMemoryDetail = makeLabel(QString(), 10, "#6C7086", false, card); infoLayout->addWidget(lblMemoryDetail);
+    lblPressure = makeLabel(QString(), 10, "#6C7086", false, card); infoLayout->addWidget(lblPressure);
 
     QLabel* diskTitle = makeLabel("Disks", 11, "#F9E2AF", false, card); infoLayout->addWidget(diskTitle);
     hardwareDiskLayout = new QVBoxLayout(); hardwareDiskLayout->setSpacing(2); infoLayout->addLayout(hardwareDiskLayout);
+    hardwareDiskRows.reset(new KeyedLabelRows(hardwareDiskLayout, [this]() {
+        QLabel* lbl = makeLabel(QString(), 10, "#F9E2AF", false, nullptr);
+        lbl->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+        return lbl;
+    }));
 
     QLabel* networkTitle = makeLabel("Network", 11, "#89B4FA", false, card); infoLayout->addWidget(networkTitle);
     lblNetworkInfo = makeLabel(QString(), 11, "#CDD6F4", false, card); infoLayout->addWidget(lblNetworkInfo);
+    QVBoxLayout* networkLayout = new QVBoxLayout(); networkLayout->setSpacing(2); infoLayout->addLayout(networkLayout);
+    networkRows.reset(new KeyedLabelRows(networkLayout, [this]() { return makeLabel(QString(), 10, "#89B4FA", false, nullptr); }));
 
     cardLayout->addLayout(infoLayout);
     hLayout->addWidget(card, 1, Qt::AlignCenter);
@@ -306,6 +357,32 @@ QWidget* MainWindow::createSoftwarePanel() {
     return container;
 }
 
+QWidget* MainWindow::createProcessesPanel() {
+    QWidget* container = new QWidget(); container->setStyleSheet("background-color: transparent;");
+    QHBoxLayout* hLayout = new QHBoxLayout(container); hLayout->setContentsMargins(20,20,20,20); hLayout->setSpacing(0);
+
+    QFrame* card = new QFrame(container); card->setFrameStyle(QFrame::Box);
+    card->setStyleSheet("QFrame { background-color: #18181F; border: 1px solid #1E1E28; border-radius: 12px; }");
+    QVBoxLayout* cardLayout = new QVBoxLayout(card); cardLayout->setContentsMargins(32,24,32,24); cardLayout->setSpacing(0);
+
+    QLabel* logo = makeLabel(QString("📊"), 20, "#CDD6F4", false, card); logo->setAlignment(Qt::AlignCenter); cardLayout->addWidget(logo);
+    QLabel* panelTitle = makeLabel("Processes", 10, "#6C7086", false, card); panelTitle->setAlignment(Qt::AlignCenter); cardLayout->addWidget(panelTitle);
+    cardLayout->addSpacing(20);
+
+    QVBoxLayout* infoLayout = new QVBoxLayout(); infoLayout->setSpacing(2); infoLayout->setSizeConstraint(QLayout::SetMinimumSize);
+    lblProcessCount = makeLabel(QString(), 11, "#CDD6F4", false, card); infoLayout->addWidget(lblProcessCount);
+    infoLayout->addSpacing(8);
+    QLabel* header = makeLabel(SnapshotFormat::processHeader(), 10, "#6C7086", false, card); infoLayout->addWidget(header);
+    // Rows are keyed by rank, so a reshuffle of the ranking only re-texts
+    // labels instead of moving them.
+    QVBoxLayout* rowsLayout = new QVBoxLayout(); rowsLayout->setSpacing(2); infoLayout->addLayout(rowsLayout);
+    processRows.reset(new KeyedLabelRows(rowsLayout, [this]() { return makeLabel(QString(), 10, "#89B4FA", false, nullptr); }));
+
+    cardLayout->addLayout(infoLayout);
+    hLayout->addWidget(card, 1, Qt::AlignCenter);
+    return container;
+}
+
 QWidget* MainWindow::createLogsPanel() {
     QWidget* container = new QWidget(); container->setStyleSheet("background-color: transparent;");
     QHBoxLayout* hLayout = new QHBoxLayout(container); hLayout->setContentsMargins(20,20,20,20); hLayout->setSpacing(0);
@@ -318,11 +395,15 @@ QWidget* MainWindow::createLogsPanel() {
     QLabel* panelTitle = makeLabel("Logs", 10, "#6C7086", false, card); panelTitle->setAlignment(Qt::AlignCenter); cardLayout->addWidget(panelTitle);
     cardLayout->addSpacing(20);
 
+    QLabel* stats = makeLabel(QString(), 10, "#CDD6F4", false, card); stats->setWordWrap(true); cardLayout->addWidget(stats);
+    cardLayout->addSpacing(12);
+
     QTextEdit* edit = new QTextEdit(card); edit->setReadOnly(true);
     edit->setStyleSheet("color: #CDD6F4; background-color: transparent; border: none; font-family: Consolas; font-size: 10px;");
     edit->setFont(QFont("Consolas", 10)); cardLayout->addWidget(edit);
 
     hLayout->addWidget(card, 1, Qt::AlignCenter);
+    lblLogStats = stats;
     logsEdit = edit;
     return container;
 }
@@ -349,89 +430,170 @@ QWidget* MainWindow::createTitleBar() {
     return bar;
 }
 
-void MainWindow::updateData() {
-    QString logPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/neofetch_ui_debug.txt";
-    QFile logFile(logPath);
-    if (logFile.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream out(&logFile);
-        out << "updateData called, disk count: " << m_data->getDiskInfo().size() << Qt::endl;
-        out << "displayInfo:\n" << m_data->displayInfo() << Qt::endl;
-        out << "memoryHardwareInfo:\n" << m_data->memoryHardwareInfo() << Qt::endl;
-        logFile.close();
-    }
-
-    QList<QVariant> disks = m_data->getDiskInfo();
+void MainWindow::setLabelText(QLabel* label, const QString& text) {
+    if (!label || label->text() == text) return;
+    label->setText(text);
+    ++m_cycleUpdates;
+}
 
-    lblUsername->setText(QString("%1@%2").arg(m_data->username()).arg(m_data->currentDir()));
-    lblOs->setText(m_data->osInfo());
-    lblCpuPercent->setText(QString("CPU: %1%").arg(m_data->cpuPercent()));
-    lblMemoryPercent->setText(QString("Memory: %1%").arg(m_data->memoryPercent()));
+void MainWindow::updateData(SnapshotFields changed) {
+    using namespace SnapshotField;
+
+    // Read everything from one published snapshot so the widgets never mix
+    // values from two different sampling cycles.
+    const SystemSnapshotPtr snap = m_data->snapshot();
+    const SystemInventory* inv = snap->inventory.get();
+    Instrumentation& instr = m_data->instrumentation();
+    ProbeTimer probe(&instr, Instrumentation::UiUpdate);
+    m_cycleUpdates = 0;
+
+    if (m_firstSampleNs < 0 && snap->timestampMs != 0) m_firstSampleNs = m_startupClock.nsecsElapsed();
+    if (m_completeNs < 0 && inv->complete) m_completeNs = m_startupClock.nsecsElapsed();
+
+    NEOFETCH_LOG(Logger::Debug, QString("updateData: changed=0x%1, disk count: %2").arg(uint(changed), 0, 16).arg(snap->volumes.size()));
+    if (changed & DisplayInfo) NEOFETCH_LOG(Logger::Debug, QString("displayInfo: %1").arg(inv->displayInfo));
+    if (changed & MemoryHardwareInfo) NEOFETCH_LOG(Logger::Debug, QString("memoryHardwareInfo: %1").arg(SnapshotFormat::memoryModules(*inv)));
+
+    if (changed & (Username | CurrentDir))
+        setLabelText(lblUsername, QString("%1@%2").arg(inv->username).arg(inv->currentDir));
+    if (changed & OsInfo) {
+        setLabelText(lblOs, inv->osInfo);
+        setLabelText(lblSoftwareOs, inv->osInfo);
+    }
+    if (changed & CpuPercent) setLabelText(lblCpuPercent, QString("CPU: %1%").arg(snap->cpuPercent));
+    if (changed & MemoryPercent) setLabelText(lblMemoryPercent, QString("Memory: %1%").arg(snap->memoryPercent));
+    if (lblAlerts && (changed & Alerts)) {
+        const QString text = SnapshotFormat::firingAlerts(snap->alerts);
+        setLabelText(lblAlerts, text);
+        lblAlerts->setVisible(!text.isEmpty());
+    }
 
-    lblCpuInfo->setText(QString("CPU: %1").arg(m_data->cpuInfo()));
-    lblGpuInfo->setText(QString("GPU: %1").arg(m_data->gpuInfo()));
-    lblDisplayInfo->setText(QString("Display: %1").arg(m_data->displayInfo()));
+    if (changed & CpuInfo) setLabelText(lblCpuInfo, QString("CPU: %1").arg(inv->cpuInfo));
+    if (changed & GpuInfo) setLabelText(lblGpuInfo, QString("GPU: %1").arg(inv->gpuInfo));
+    if (changed & DisplayInfo) setLabelText(lblDisplayInfo, QString("Display: %1").arg(inv->displayInfo));
 
-    qulonglong totalGB = m_data->memoryTotal() / (1024.0 * 1024.0 * 1024.0);
-    qulonglong usedGB = m_data->memoryUsed() / (1024.0 * 1024.0 * 1024.0);
-    int percent = m_data->memoryPercent();
-    lblMemoryInfo->setText(QString("Memory: %1 GiB / %2 GiB (%3%)").arg(usedGB).arg(totalGB).arg(percent));
+    if (changed & (MemoryTotal | MemoryUsed | MemoryPercent)) {
+        qulonglong totalGB = snap->memoryTotal / (1024.0 * 1024.0 * 1024.0);
+        qulonglong usedGB = snap->memoryUsed / (1024.0 * 1024.0 * 1024.0);
+        int percent = snap->memoryPercent;
+        setLabelText(lblMemoryInfo, QString("Memory: %1 GiB / %2 GiB (%3%)").arg(usedGB).arg(totalGB).arg(percent));
+    }
 
     // Memory hardware info (manufacturer, size, speed)
-    if (lblMemoryHardware) {
-        lblMemoryHardware->setText(m_data->memoryHardwareInfo());
+    if (changed & MemoryHardwareInfo) setLabelText(lblMemoryHardware, SnapshotFormat::memoryModules(*inv));
+    if (changed & MemoryDetail) setLabelText(lblMemoryDetail, SnapshotFormat::memoryDetail(snap->memoryDetail));
+    if (changed & Pressure) setLabelText(lblPressure, SnapshotFormat::pressure(snap->pressure));
+
+    if (hardwareDiskRows && (changed & DiskHardwareInfo)) {
+        QVector<KeyedLabelRows::Row> rows;
+        rows.reserve(inv->diskDevices.size());
+        for (const DiskDevice &disk : inv->diskDevices) {
+            const QString line = SnapshotFormat::diskDevice(disk);
+            rows.append({ line, line });
+        }
+        if (rows.isEmpty()) rows.append({ QString(), inv->diskDevicesNote.isEmpty() ? QString("No disk hardware info") : inv->diskDevicesNote });
+        m_cycleUpdates += hardwareDiskRows->reconcile(rows);
     }
 
-    if (hardwareDiskLayout) {
-        clearLayout(hardwareDiskLayout);
-        QString hwInfo = m_data->diskHardwareInfo();
-        if (!hwInfo.isEmpty()) {
-            const QStringList lines = hwInfo.split('\n', Qt::SkipEmptyParts);
-            for (const QString &line : lines) {
-                QLabel* lbl = makeLabel(line.trimmed(), 10, "#F9E2AF", false, nullptr);
-                lbl->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
-                hardwareDiskLayout->addWidget(lbl);
-            }
-        } else {
-            QLabel* lbl = makeLabel("No disk hardware info", 10, "#F9E2AF", false, nullptr);
-            hardwareDiskLayout->addWidget(lbl);
+    if (changed & NetworkInfo) setLabelText(lblNetworkInfo, QString("Network: %1").arg(inv->networkInfo));
+    if (networkRows && (changed & NetworkTraffic)) {
+        const NetworkTable &network = snap->network;
+        QVector<KeyedLabelRows::Row> rows;
+        rows.reserve(network.size());
+        for (int i = 0; i < network.size(); ++i)
+            rows.append({ QString::number(network.ifIndex[i]), SnapshotFormat::networkInterface(network, i) });
+        m_cycleUpdates += networkRows->reconcile(rows);
+    }
+    if (changed & KernelInfo) setLabelText(lblKernelInfo, QString("Kernel: %1").arg(inv->kernelInfo));
+    if (changed & ShellInfo) setLabelText(lblShellInfo, QString("Shell: %1").arg(inv->shellInfo));
+
+    if (diskRows && (changed & (DiskInfo | DiskIo))) {
+        QVector<KeyedLabelRows::Row> rows;
+        const VolumeTable &volumes = snap->volumes;
+        rows.reserve(volumes.size());
+        for (int i = 0; i < volumes.size(); ++i) {
+            QString text = SnapshotFormat::volume(volumes, i);
+            const int io = snap->diskIo.indexOf(volumes.device[i]);
+            if (io >= 0) text += "  " + SnapshotFormat::diskIo(snap->diskIo, io);
+            rows.append({ volumes.mountPoint[i], text });
         }
+        m_cycleUpdates += diskRows->reconcile(rows);
     }
 
-    lblNetworkInfo->setText(QString("Network: %1").arg(m_data->networkInfo()));
-    lblSoftwareOs->setText(m_data->osInfo());
-    lblKernelInfo->setText(QString("Kernel: %1").arg(m_data->kernelInfo()));
-    lblShellInfo->setText(QString("Shell: %1").arg(m_data->shellInfo()));
-
-    if (diskLayout) {
-        clearLayout(diskLayout);
-        for (const auto& disk : disks) {
-            QVariantMap d = disk.toMap();
-            QString drive = d["drive"].toString().trimmed();
-            QString fsType = d["fstype"].toString();
-            QString used = d["used"].toString();
-            QString total = d["total"].toString();
-            int perc = d["percent"].toInt();
-            QString diskText = QString("%1 %2 %3 GiB / %4 GiB (%5%)").arg(drive).arg(fsType).arg(used).arg(total).arg(perc);
-            QLabel* lbl = makeLabel(diskText, 10, "#F9E2AF", false, nullptr);
-            diskLayout->addWidget(lbl);
-        }
+    if (processRows && (changed & Processes)) {
+        const ProcessTable &processes = snap->processes;
+        setLabelText(lblProcessCount, QString("%1 processes").arg(processes.total));
+        QVector<KeyedLabelRows::Row> rows;
+        rows.reserve(processes.size());
+        for (int i = 0; i < processes.size(); ++i)
+            rows.append({ QString::number(i), SnapshotFormat::process(processes, i) });
+        m_cycleUpdates += processRows->reconcile(rows);
     }
 
-    lblUptime->setText(QString("Uptime: %1").arg(m_data->uptime()));
+    if (changed & Uptime) setLabelText(lblUptime, QString("Uptime: %1").arg(SnapshotFormat::uptime(*snap)));
 
-    if (logsEdit) {
+    // Only the fields that rarely change rebuild the text; the per-tick
+    // figures live in lblLogStats.
+    const SnapshotFields logFields = CpuInfo | GpuInfo | OsInfo | KernelInfo | ShellInfo | DiskInfo | Alerts;
+    if (logsEdit && (changed & logFields)) {
         QString logs = "=== System Information ===\n\n";
-        logs += QString("CPU: %1\n").arg(m_data->cpuInfo());
-        logs += QString("GPU: %1\n").arg(m_data->gpuInfo());
-        logs += QString("OS: %1\n").arg(m_data->osInfo());
-        logs += QString("Kernel: %1\n").arg(m_data->kernelInfo());
-        logs += QString("Shell: %1\n").arg(m_data->shellInfo());
-        logs += QString("Uptime: %1\n\n").arg(m_data->uptime());
+        logs += QString("CPU: %1\n").arg(inv->cpuInfo);
+        logs += QString("GPU: %1\n").arg(inv->gpuInfo);
+        logs += QString("OS: %1\n").arg(inv->osInfo);
+        logs += QString("Kernel: %1\n").arg(inv->kernelInfo);
+        logs += QString("Shell: %1\n\n").arg(inv->shellInfo);
+        if (!snap->alerts.recent.isEmpty()) {
+            logs += "=== Alerts ===\n\n";
+            for (const AlertEvent &e : snap->alerts.recent) logs += SnapshotFormat::alertEvent(e) + '\n';
+            logs += '\n';
+        }
         logs += "=== Disk Usage ===\n\n";
-        for (auto& disk : disks) {
-            QVariantMap d = disk.toMap();
-            logs += QString("%1 (%2): %3 GiB / %4 GiB (%5%)\n").arg(d["drive"].toString()).arg(d["fstype"].toString()).arg(d["used"].toString()).arg(d["total"].toString()).arg(d["percent"].toInt());
+        const VolumeTable &volumes = snap->volumes;
+        for (int i = 0; i < volumes.size(); ++i) {
+            logs += QString("%1 (%2): %3 GiB / %4 GiB (%5%)\n").arg(volumes.mountPoint[i]).arg(volumes.fsType[i])
+                .arg(SnapshotFormat::gib(volumes.usedBytes(i))).arg(SnapshotFormat::gib(volumes.totalBytes[i])).arg(volumes.percentUsed(i));
         }
         logsEdit->setText(logs);
+        ++m_cycleUpdates;
     }
+    if ((changed & (CpuCores | Uptime | SampleStats)) && logsPanelVisible()) refreshLogStats();
+
+    m_lastCycleUpdates = m_cycleUpdates;
+    m_totalUpdates += m_cycleUpdates;
+    ++m_cycles;
+    instr.count(Instrumentation::UiRefreshes);
+    instr.count(Instrumentation::LabelUpdates, m_cycleUpdates);
+    reportStartup();
+}
+
+bool MainWindow::logsPanelVisible() const {
+    return lblLogStats && contentStack->currentWidget() == logsPanel && isVisible() && !isMinimized();
+}
+
+void MainWindow::refreshLogStats() {
+    const SystemSnapshotPtr snap = m_data->snapshot();
+    const SystemInventory* inv = snap->inventory.get();
+    QString stats = QString("CPU time: %1\n").arg(SnapshotFormat::cpuTimes(snap->cpu));
+    stats += QString("CPU cores: %1\n").arg(SnapshotFormat::cpuCores(snap->cpu));
+    stats += QString("Uptime: %1\n").arg(SnapshotFormat::uptime(*snap));
+    stats += QString("Sample cost: %1 us (last inventory pass: %2 us%3)\n").arg(snap->sampleMicros).arg(snap->inventoryMicros)
+        .arg(inv->cached ? QString(", showing cached inventory") : QString());
+    for (const CollectorStat &c : snap->collectors) stats += QString("  %1\n").arg(SnapshotFormat::collector(c));
+    stats += QString("Scheduler: %1\n").arg(SnapshotFormat::schedule(*snap));
+    stats += QString("UI updates: %1 widgets last cycle, %2 over %3 cycles\n").arg(m_lastCycleUpdates).arg(m_totalUpdates).arg(m_cycles);
+    auto milestone = [](qint64 ns) { return ns < 0 ? QString("-") : QString("%1 ms").arg(ns / 1e6, 0, 'f', 1); };
+    stats += QString("Startup: first paint %1, first sample %2, complete %3\n\n")
+        .arg(milestone(m_firstPaintNs)).arg(milestone(m_firstSampleNs)).arg(milestone(m_completeNs));
+    stats += "=== Collector Latency ===\n\n";
+    stats += SnapshotFormat::instrumentation(m_data->instrumentation());
+    setLabelText(lblLogStats, stats);
+}
+
+void MainWindow::reportStartup() {
+    // The first paint and the complete inventory can arrive in either order.
+    if (m_startupReported || m_firstPaintNs < 0 || m_completeNs < 0) return;
+    m_startupReported = true;
+    NEOFETCH_LOG(Logger::Info, QString("Startup: first paint %1 ms, first sample %2 ms, complete %3 ms")
+        .arg(m_firstPaintNs / 1e6, 0, 'f', 1).arg(m_firstSampleNs / 1e6, 0, 'f', 1).arg(m_completeNs / 1e6, 0, 'f', 1));
+    emit startupMeasured(m_firstPaintNs / 1e6, m_firstSampleNs / 1e6, m_completeNs / 1e6);
 }
@@ -13,18 +13,40 @@
 #include <QFileIconProvider>
 #include <QStackedWidget>
 #include <QTextEdit>
+#include <QElapsedTimer>
+#include <memory>
 #include "SystemDataProvider.h"
+#include "KeyedLabelRows.h"
 
 class MainWindow : public QWidget {
     Q_OBJECT
 public:
     MainWindow(SystemDataProvider* data, QWidget *parent = nullptr);
 
+    // Startup times are measured from this clock; defaults to the moment the
+    // window was constructed.
+    void setStartupClock(const QElapsedTimer& clock) { m_startupClock = clock; }
+
+    // Builds every lazily created panel now, so that updateData() touches
+    // all widgets (used by the UI benchmark).
+    void createAllPanels();
+
+signals:
+    // Emitted once, when the first complete inventory has been shown. Times
+    // are in milliseconds on the startup clock.
+    void startupMeasured(double firstPaintMs, double firstSampleMs, double completeMs);
+
 protected:
+    void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     bool eventFilter(QObject *obj, QEvent *event) override;
+    // Report visibility to the provider, which slows sampling while the
+    // window is hidden or minimized.
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
 private:
     void selectMenu(int index);
@@ -34,13 +56,23 @@ private:
     QWidget* createDashboardPanel();
     QWidget* createHardwarePanel();
     QWidget* createSoftwarePanel();
+    QWidget* createProcessesPanel();
     QWidget* createLogsPanel();
+    // Builds the panel behind a menu entry the first time it is shown.
+    QWidget* ensurePanel(int index);
     QWidget* createTitleBar();
-    void updateData();
+    void updateData(SnapshotFields changed);
+    // The per-tick part of the Logs panel: CPU time, uptime, sample cost,
+    // scheduler, UI updates and collector latency. Only kept current while
+    // that panel is on screen.
+    void refreshLogStats();
+    bool logsPanelVisible() const;
+    void reportStartup();
 
-    // Helper to create styled labels and clear layouts
+    // Helper to create styled labels
     QLabel* makeLabel(const QString& text = QString(), int fontSize = 11, const QString& color = "#CDD6F4", bool bold = false, QWidget* parent = nullptr);
-    void clearLayout(QLayout* layout);
+    // setText() only when the text differs; counts towards m_cycleUpdates.
+    void setLabelText(QLabel* label, const QString& text);
 
     SystemDataProvider* m_data;
     bool m_dragging;
@@ -50,25 +82,48 @@ private:
     QLabel* lblOs;
     QLabel* lblCpuPercent;
     QLabel* lblMemoryPercent;
+    QLabel* lblAlerts;
     QVBoxLayout* diskLayout;
     QLabel* lblCpuInfo;
     QLabel* lblGpuInfo;
     QLabel* lblDisplayInfo;
     QLabel* lblMemoryInfo;
     QLabel* lblMemoryHardware;
+    QLabel* lblMemoryDetail;
+    QLabel* lblPressure;
     QLabel* lblNetworkInfo;
     QVBoxLayout* hardwareDiskLayout;
+    std::unique_ptr<KeyedLabelRows> diskRows;
+    std::unique_ptr<KeyedLabelRows> hardwareDiskRows;
+    std::unique_ptr<KeyedLabelRows> networkRows;
     QLabel* lblSoftwareOs;
     QLabel* lblKernelInfo;
     QLabel* lblShellInfo;
     QLabel* lblUptime;
+    QLabel* lblProcessCount;
+    std::unique_ptr<KeyedLabelRows> processRows;
     QList<QLabel*> menuLabels;
     QStackedWidget* contentStack;
     QWidget* dashboardPanel;
     QWidget* hardwarePanel;
     QWidget* softwarePanel;
+    QWidget* processesPanel;
     QWidget* logsPanel;
+    QLabel* lblLogStats;
     QTextEdit* logsEdit;
+
+    // Widgets touched by updateData(), for judging refresh cost.
+    int m_cycleUpdates;
+    int m_lastCycleUpdates;
+    qulonglong m_totalUpdates;
+    qulonglong m_cycles;
+
+    // Startup milestones in nanoseconds on m_startupClock, -1 until reached.
+    QElapsedTimer m_startupClock;
+    qint64 m_firstPaintNs;
+    qint64 m_firstSampleNs;
+    qint64 m_completeNs;
+    bool m_startupReported;
 };
 
 #endif
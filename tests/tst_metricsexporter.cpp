@@ -0,0 +1,141 @@
+#include <QtTest>
+#include <QTcpSocket>
+#include "MetricsExporter.h"
+#include "OpenMetrics.h"
+
+// The exporter on a free loopback port, scraped with a plain HTTP client.
+
+namespace {
+
+const int kTimeoutMs = 5000;
+
+struct Response {
+    QByteArray statusLine;
+    QByteArray contentType;
+    int contentLength = -1;
+    QByteArray body;
+};
+
+// Sends request and reads until the exporter closes the connection.
+Response fetch(quint16 port, const QByteArray &request)
+{
+    Response r;
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress(QHostAddress::LocalHost), port);
+    if (!socket.waitForConnected(kTimeoutMs)) return r;
+    socket.write(request);
+    QByteArray raw;
+    while (socket.state() == QAbstractSocket::ConnectedState && socket.waitForReadyRead(kTimeoutMs)) raw += socket.readAll();
+    raw += socket.readAll();
+
+    const int end = raw.indexOf("\r\n\r\n");
+    if (end < 0) return r;
+    const QList<QByteArray> lines = raw.left(end).split('\n');
+    r.statusLine = lines.first().trimmed();
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines[i].indexOf(':');
+        const QByteArray name = lines[i].left(colon).trimmed().toLower();
+        const QByteArray value = lines[i].mid(colon + 1).trimmed();
+        if (name == "content-type") r.contentType = value;
+        else if (name == "content-length") r.contentLength = value.toInt();
+    }
+    r.body = raw.mid(end + 4);
+    return r;
+}
+
+SystemSnapshotPtr knownSnapshot()
+{
+    auto s = std::make_shared<SystemSnapshot>();
+    s->timestampMs = 1700000000123LL;
+    s->uptimeSeconds = 86400;
+    s->cpuPercent = 42;
+    s->cpu.resize(2);
+    for (int i = 0; i < s->cpu.size(); ++i) {
+        s->cpu.cpuId[i] = i;
+        s->cpu.share[CpuTable::User][i] = 40 + i;
+        s->cpu.share[CpuTable::Idle][i] = 60 - i;
+    }
+    s->memoryTotal = 17179869184ULL;
+    s->memoryUsed = 8589934592ULL;
+    s->volumes.resize(1);
+    s->volumes.mountPoint[0] = "/";
+    s->volumes.fsType[0] = "ext4";
+    s->volumes.totalBytes[0] = 500000000000ULL;
+    s->volumes.freeBytes[0] = 125000000000ULL;
+    s->sampleMicros = 1500;
+    return s;
+}
+
+} // namespace
+
+class MetricsExporterTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void getServesSnapshot();
+    void headSendsHeadersOnly();
+    void unknownPathIsNotFound();
+    void noSnapshotIsUnavailable();
+
+private:
+    SystemSnapshotPtr m_snapshot;
+    QByteArray m_expected;
+    std::unique_ptr<MetricsExporter> m_exporter;
+};
+
+void MetricsExporterTest::initTestCase()
+{
+    m_snapshot = knownSnapshot();
+    OpenMetrics::render(*m_snapshot, m_expected);
+    const SystemSnapshotPtr snapshot = m_snapshot;
+    m_exporter.reset(new MetricsExporter([snapshot]() { return snapshot; }));
+    QVERIFY(m_exporter->start(0));
+    QVERIFY(m_exporter->port() != 0);
+}
+
+void MetricsExporterTest::getServesSnapshot()
+{
+    const Response r = fetch(m_exporter->port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QCOMPARE(r.statusLine, QByteArray("HTTP/1.1 200 OK"));
+    QCOMPARE(r.contentType, QByteArray(OpenMetrics::kContentType));
+    QCOMPARE(r.contentLength, m_expected.size());
+    QCOMPARE(r.body, m_expected);
+    QVERIFY(r.body.endsWith("# EOF\n"));
+    QVERIFY(r.body.contains("\nneofetch_memory_used_bytes 8589934592\n"));
+    QVERIFY(r.body.contains("\nneofetch_snapshot_timestamp_seconds 1700000000.123\n"));
+
+    // A query string is ignored.
+    QCOMPARE(fetch(m_exporter->port(), "GET /metrics?x=y HTTP/1.1\r\n\r\n").body, m_expected);
+}
+
+void MetricsExporterTest::headSendsHeadersOnly()
+{
+    const Response r = fetch(m_exporter->port(), "HEAD /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QCOMPARE(r.statusLine, QByteArray("HTTP/1.1 200 OK"));
+    QCOMPARE(r.contentType, QByteArray(OpenMetrics::kContentType));
+    QCOMPARE(r.contentLength, m_expected.size());
+    QVERIFY(r.body.isEmpty());
+}
+
+void MetricsExporterTest::unknownPathIsNotFound()
+{
+    const Response r = fetch(m_exporter->port(), "GET /metrics/extra HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QCOMPARE(r.statusLine, QByteArray("HTTP/1.1 404 Not Found"));
+    QCOMPARE(r.contentType, QByteArray("text/plain; charset=utf-8"));
+    QCOMPARE(r.contentLength, r.body.size());
+    QVERIFY(!r.body.contains("# EOF"));
+}
+
+void MetricsExporterTest::noSnapshotIsUnavailable()
+{
+    MetricsExporter exporter([]() { return SystemSnapshotPtr(); });
+    QVERIFY(exporter.start(0));
+    const Response r = fetch(exporter.port(), "GET /metrics HTTP/1.1\r\n\r\n");
+    QCOMPARE(r.statusLine, QByteArray("HTTP/1.1 503 Service Unavailable"));
+}
+
+QTEST_GUILESS_MAIN(MetricsExporterTest)
+
+#include "tst_metricsexporter.moc"
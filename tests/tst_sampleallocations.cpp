@@ -0,0 +1,50 @@
+#include <QtTest>
+#include "AllocationCounter.h"
+#include "MetricHistory.h"
+#include "SystemSampler.h"
+
+// Once the snapshot pool and its columns have grown to size, a sampler tick
+// overwrites them in place: the collectors, the alert rules, the history and
+// publishing together make no heap allocation.
+
+namespace {
+
+const int kWarmUpTicks = 10;
+const int kMeasuredTicks = 100;
+
+} // namespace
+
+class SampleAllocationsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tickDoesNotAllocateAfterWarmUp();
+};
+
+void SampleAllocationsTest::tickDoesNotAllocateAfterWarmUp()
+{
+    // The captured /proc and /sys tree, so the tick sees the same CPUs,
+    // processes, interfaces and devices every time.
+    std::unique_ptr<SystemBackend> backend = SystemBackend::create(QByteArray(NEOFETCH_FIXTURE_DIR));
+    if (!backend) QSKIP("the platform backend cannot read a fixture tree");
+
+    MetricHistory history;
+    SystemSampler sampler(std::move(backend), &history);
+    for (int i = 0; i < kWarmUpTicks; ++i) sampler.sampleOnce();
+
+    const quint64 before = allocationCount();
+    for (int i = 0; i < kMeasuredTicks; ++i) sampler.sampleOnce();
+    const quint64 allocations = allocationCount() - before;
+
+    // A tick that collected nothing would pass trivially.
+    const SystemSnapshotPtr s = sampler.latest();
+    QVERIFY(s->cpu.size() > 0);
+    QVERIFY(s->processes.size() > 0);
+    QVERIFY(s->network.size() > 0);
+    QCOMPARE(allocations, quint64(0));
+}
+
+QTEST_GUILESS_MAIN(SampleAllocationsTest)
+
+#include "tst_sampleallocations.moc"
@@ -0,0 +1,123 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include "SystemDataProvider.h"
+#include "SystemSampler.h"
+
+// The sampler runs every collector on its own thread, so a collector that
+// blocks for hundreds of milliseconds (a WMI round-trip, a hung NFS
+// statvfs) must not delay the GUI thread's event loop.
+
+namespace {
+
+const int kSlowCollectorMs = 300;
+const int kProbeIntervalMs = 5;
+// How late the probe timer may fire. Far below kSlowCollectorMs, so a
+// collector that ran on the GUI thread would show up; loose enough for a
+// loaded CI machine.
+const int kMaxLatencyMs = 50;
+
+// Metric and inventory collectors that do nothing but sleep.
+class SlowBackend : public SystemBackend
+{
+public:
+    std::atomic<int> cpuSamples{0};
+
+    void fetchCpuInfo(SystemInventory &) override {}
+    void fetchGpuInfo(SystemInventory &) override { QThread::msleep(kSlowCollectorMs); }
+    void fetchDisplayInfo(SystemInventory &) override {}
+    void fetchOsInfo(SystemInventory &) override {}
+    void fetchKernelInfo(SystemInventory &) override {}
+    void fetchShellInfo(SystemInventory &) override {}
+    void fetchUserInfo(SystemInventory &) override {}
+    void fetchDiskHardwareInfo(SystemInventory &) override { QThread::msleep(kSlowCollectorMs); }
+    void fetchMemoryHardwareInfo(SystemInventory &) override { QThread::msleep(kSlowCollectorMs); }
+    void fetchNetworkInfo(SystemInventory &) override {}
+
+    QByteArray bootId() override { return QByteArray("test"); }
+    quint64 hardwareFingerprint() override { return 0; }
+
+    void fetchUptime(SystemSnapshot &s) override { ++s.uptimeSeconds; }
+    void fetchDiskInfo(SystemSnapshot &) override {}
+    void fetchCpuUsage(SystemSnapshot &s) override
+    {
+        QThread::msleep(kSlowCollectorMs);
+        s.cpuPercent = 50;
+        ++cpuSamples;
+    }
+    void fetchMemoryUsage(SystemSnapshot &) override {}
+    void fetchProcesses(SystemSnapshot &) override {}
+    void fetchNetworkUsage(SystemSnapshot &) override {}
+    void fetchDiskIo(SystemSnapshot &) override {}
+    void fetchPressure(SystemSnapshot &) override {}
+};
+
+} // namespace
+
+class SamplerThreadTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void guiThreadKeepsRunningWhileCollectorsBlock();
+};
+
+void SamplerThreadTest::guiThreadKeepsRunningWhileCollectorsBlock()
+{
+    // Wired up the way SystemDataProvider does it in Live mode, with the
+    // published snapshots applied on this (the GUI) thread.
+    std::unique_ptr<SlowBackend> backend(new SlowBackend);
+    SlowBackend *slow = backend.get();
+    SystemDataProvider data(SystemDataProvider::Manual);
+    SystemSampler *sampler = new SystemSampler(std::move(backend));
+    QThread samplerThread;
+    sampler->moveToThread(&samplerThread);
+    connect(&samplerThread, &QThread::started, sampler, &SystemSampler::start);
+    connect(&samplerThread, &QThread::finished, sampler, &QObject::deleteLater);
+    int published = 0;
+    connect(sampler, &SystemSampler::snapshotPublished, &data, [&]() {
+        ++published;
+        data.applySnapshot(sampler->latest());
+    }, Qt::QueuedConnection);
+
+    // The first tick, the quick CPU re-sample 250 ms later and one regular
+    // tick a second after that, each blocking the sampler for
+    // kSlowCollectorMs, while the slow inventory steps block the pool.
+    QEventLoop loop;
+    QElapsedTimer clock;
+    qint64 lastMs = 0;
+    qint64 maxGapMs = 0;
+    QTimer probe;
+    probe.setTimerType(Qt::PreciseTimer);
+    connect(&probe, &QTimer::timeout, &probe, [&]() {
+        const qint64 nowMs = clock.elapsed();
+        maxGapMs = qMax(maxGapMs, nowMs - lastMs);
+        lastMs = nowMs;
+        if (slow->cpuSamples >= 3) loop.quit();
+    });
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+
+    clock.start();
+    probe.start(kProbeIntervalMs);
+    samplerThread.start();
+    loop.exec();
+    probe.stop();
+    // The backend goes away with the sampler.
+    const int cpuSamples = slow->cpuSamples;
+
+    QMetaObject::invokeMethod(sampler, "stop", Qt::BlockingQueuedConnection);
+    samplerThread.quit();
+    samplerThread.wait();
+
+    QVERIFY2(cpuSamples >= 3, "the sampler did not run the slow collector three times");
+    QVERIFY(published >= 3);
+    QVERIFY2(maxGapMs - kProbeIntervalMs <= kMaxLatencyMs,
+             qPrintable(QString("the GUI thread stalled for %1 ms").arg(maxGapMs)));
+}
+
+QTEST_GUILESS_MAIN(SamplerThreadTest)
+
+#include "tst_samplerthread.moc"
@@ -0,0 +1,229 @@
+#include <QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <vector>
+#include "SnapshotTrace.h"
+#include "SyntheticSamples.h"
+
+// Three hours of synthetic one-second samples written to a trace, read back
+// in order and by seeking, from a closed trace, one cut short by a crash and
+// one with a damaged block.
+
+namespace {
+
+// Compares everything a trace records; collector health is not recorded.
+void compareRecord(const SystemSnapshot &read, const SystemSnapshot &written)
+{
+    QCOMPARE(read.timestampMs, written.timestampMs);
+    QCOMPARE(read.uptimeSeconds, written.uptimeSeconds);
+    QCOMPARE(read.cpuPercent, written.cpuPercent);
+    QCOMPARE(read.memoryPercent, written.memoryPercent);
+    QCOMPARE(read.memoryTotal, written.memoryTotal);
+    QCOMPARE(read.memoryUsed, written.memoryUsed);
+    QVERIFY(read.memoryDetail == written.memoryDetail);
+    QVERIFY(read.pressure == written.pressure);
+    QCOMPARE(read.sampleMicros, written.sampleMicros);
+    QCOMPARE(read.inventoryMicros, written.inventoryMicros);
+    QCOMPARE(read.intervalStretch, written.intervalStretch);
+    QCOMPARE(read.wakeupsPerSecond, written.wakeupsPerSecond);
+    QCOMPARE(read.sampledMetrics, written.sampledMetrics);
+    QVERIFY(read.cpu == written.cpu);
+    QVERIFY(read.volumes == written.volumes);
+    QVERIFY(read.diskIo == written.diskIo);
+    QVERIFY(read.network == written.network);
+    QVERIFY(read.processes == written.processes);
+    QVERIFY(read.alerts == written.alerts);
+
+    const SystemInventory &a = *read.inventory;
+    const SystemInventory &b = *written.inventory;
+    QCOMPARE(a.cpuInfo, b.cpuInfo);
+    QCOMPARE(a.gpuInfo, b.gpuInfo);
+    QCOMPARE(a.displayInfo, b.displayInfo);
+    QCOMPARE(a.osInfo, b.osInfo);
+    QCOMPARE(a.kernelInfo, b.kernelInfo);
+    QCOMPARE(a.shellInfo, b.shellInfo);
+    QCOMPARE(a.username, b.username);
+    QCOMPARE(a.currentDir, b.currentDir);
+    QCOMPARE(a.networkInfo, b.networkInfo);
+    QVERIFY(a.diskDevices == b.diskDevices);
+    QVERIFY(a.memoryModules == b.memoryModules);
+    QCOMPARE(a.diskDevicesNote, b.diskDevicesNote);
+    QCOMPARE(a.memoryModulesNote, b.memoryModulesNote);
+    QCOMPARE(a.complete, b.complete);
+    QCOMPARE(a.cached, b.cached);
+}
+
+// Records left from the reader's position.
+int readToEnd(TraceReader &reader)
+{
+    int n = 0;
+    while (reader.next()) ++n;
+    return n;
+}
+
+} // namespace
+
+class SnapshotTraceTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void roundTripsEveryField();
+    void seekFindsFirstRecordAtOrAfter();
+    void readsTraceWithoutIndex();
+    void damagedBlockEndsRecording();
+
+private:
+    // A copy of the trace to damage.
+    QString copyTrace(const QString &name);
+
+    QTemporaryDir m_dir;
+    QString m_path;
+    std::vector<SystemSnapshotPtr> m_samples;
+    int m_blocks = 0;
+};
+
+void SnapshotTraceTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_path = m_dir.filePath("synthetic.trace");
+    // No throttling, so every sample is a record.
+    TraceWriter writer(0);
+    QVERIFY(writer.open(m_path));
+    SyntheticSamples samples;
+    for (int i = 0; i < SyntheticSamples::kSamples; ++i) {
+        m_samples.push_back(samples.next());
+        QVERIFY(writer.append(*m_samples.back()));
+    }
+    writer.close();
+    QCOMPARE(writer.records(), quint64(SyntheticSamples::kSamples));
+    m_blocks = (SyntheticSamples::kSamples + TraceWriter::kBlockRecords - 1) / TraceWriter::kBlockRecords;
+}
+
+void SnapshotTraceTest::roundTripsEveryField()
+{
+    TraceReader reader;
+    QVERIFY(reader.open(m_path));
+    QCOMPARE(reader.records(), quint64(SyntheticSamples::kSamples));
+    QCOMPARE(reader.blockCount(), m_blocks);
+    QCOMPARE(reader.startMs(), m_samples.front()->timestampMs);
+    QCOMPARE(reader.endMs(), m_samples.back()->timestampMs);
+
+    for (const SystemSnapshotPtr &written : m_samples) {
+        const SystemSnapshotPtr read = reader.next();
+        QVERIFY(read != nullptr);
+        compareRecord(*read, *written);
+        if (QTest::currentTestFailed()) return;
+    }
+    QVERIFY(!reader.next());
+}
+
+void SnapshotTraceTest::seekFindsFirstRecordAtOrAfter()
+{
+    TraceReader reader;
+    QVERIFY(reader.open(m_path));
+
+    // Both ends, past either end, the first and last record of every block,
+    // and the gaps between records; out of order, so seeks go backwards too.
+    std::vector<qint64> targets = { m_samples.back()->timestampMs + 1, m_samples.front()->timestampMs - 1000 };
+    for (int b = m_blocks - 1; b >= 0; --b) {
+        const size_t first = size_t(b) * TraceWriter::kBlockRecords;
+        const size_t last = qMin(first + TraceWriter::kBlockRecords, m_samples.size()) - 1;
+        targets.push_back(m_samples[first]->timestampMs);
+        targets.push_back(m_samples[last]->timestampMs);
+        targets.push_back(m_samples[last]->timestampMs + 1);
+        targets.push_back(m_samples[(first + last) / 2]->timestampMs - 1);
+    }
+
+    for (qint64 t : targets) {
+        size_t expected = 0;
+        while (expected < m_samples.size() && m_samples[expected]->timestampMs < t) ++expected;
+        reader.seek(t);
+        // The record found, and the one after it, decoded from the same
+        // block state.
+        for (size_t i = expected; i < qMin(expected + 2, m_samples.size()); ++i) {
+            const SystemSnapshotPtr read = reader.next();
+            QVERIFY2(read != nullptr, qPrintable(QString("nothing at or after %1").arg(t)));
+            compareRecord(*read, *m_samples[i]);
+            if (QTest::currentTestFailed()) return;
+        }
+        if (expected == m_samples.size()) QVERIFY(!reader.next());
+    }
+}
+
+void SnapshotTraceTest::readsTraceWithoutIndex()
+{
+    // A crash leaves no index: 32 bytes per block entry plus a 16-byte
+    // trailer.
+    const QString path = copyTrace("unindexed.trace");
+    QVERIFY(!path.isEmpty());
+    QFile file(path);
+    const qint64 unindexed = file.size() - 16 - 32 * m_blocks;
+    QVERIFY(file.resize(unindexed));
+
+    TraceReader reader;
+    QVERIFY(reader.open(path));
+    QCOMPARE(reader.blockCount(), m_blocks);
+    QCOMPARE(reader.records(), quint64(SyntheticSamples::kSamples));
+    QCOMPARE(readToEnd(reader), int(SyntheticSamples::kSamples));
+    reader.seek(m_samples.back()->timestampMs);
+    const SystemSnapshotPtr last = reader.next();
+    QVERIFY(last != nullptr);
+    compareRecord(*last, *m_samples.back());
+
+    // Cut inside the last block, as if the crash came while writing it:
+    // that block is lost, the others still read.
+    QVERIFY(file.resize(unindexed - 10));
+    QVERIFY(reader.open(path));
+    QCOMPARE(reader.blockCount(), m_blocks - 1);
+    QCOMPARE(readToEnd(reader), (m_blocks - 1) * TraceWriter::kBlockRecords);
+}
+
+void SnapshotTraceTest::damagedBlockEndsRecording()
+{
+    // Flip a byte in the compressed payload of block 5, past its 40-byte
+    // header.
+    const int damaged = 5;
+    const QString path = copyTrace("damaged.trace");
+    QVERIFY(!path.isEmpty());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray bytes = file.readAll();
+    int offset = -1;
+    for (int b = 0; b <= damaged; ++b) {
+        offset = bytes.indexOf("NFBK", offset + 1);
+        QVERIFY(offset >= 0);
+    }
+    bytes[offset + 64] = char(bytes[offset + 64] ^ 0x5a);
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.write(bytes), qint64(bytes.size()));
+    file.close();
+
+    // Reading in order stops at the damaged block; its checksum no longer
+    // matches, so nothing from it is decoded.
+    TraceReader reader;
+    QVERIFY(reader.open(path));
+    QCOMPARE(reader.blockCount(), m_blocks);
+    QCOMPARE(readToEnd(reader), damaged * TraceWriter::kBlockRecords);
+
+    // The index still reaches the blocks after it.
+    const size_t later = size_t(damaged + 2) * TraceWriter::kBlockRecords + 5;
+    reader.seek(m_samples[later]->timestampMs);
+    const SystemSnapshotPtr read = reader.next();
+    QVERIFY(read != nullptr);
+    compareRecord(*read, *m_samples[later]);
+}
+
+QString SnapshotTraceTest::copyTrace(const QString &name)
+{
+    const QString path = m_dir.filePath(name);
+    QFile::remove(path);
+    if (!QFile::copy(m_path, path)) return QString();
+    QFile(path).setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+    return path;
+}
+
+QTEST_GUILESS_MAIN(SnapshotTraceTest)
+
+#include "tst_snapshottrace.moc"